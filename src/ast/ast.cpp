@@ -21,5 +21,123 @@
 //
 
 #include "ast.h"
-#include "../lexer/lexer.h"
 
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+thread_local AstArena *current_arena = nullptr;
+
+// Every node is preceded by a header naming the arena it came from (nullptr for the global heap)
+struct alignas(std::max_align_t) NodeHeader {
+    AstArena *arena;
+};
+
+// Expression subtrees whose destruction has been deferred. Only the outermost node destructor on a thread drains the
+// list; a node destroyed while it drains moves its children onto the list instead of destroying them in place.
+thread_local std::vector<Expr> doomed;
+thread_local bool draining = false;
+
+template <typename T> struct owns_node : std::false_type {};
+template <typename T> struct owns_node<std::unique_ptr<T>> : std::true_type {};
+
+void defer(Expr &child) {
+    // Leaves (names, literals, placeholders) own no nodes and are destroyed in place
+    if (std::visit([]<typename T>(const T &) { return owns_node<T>::value; }, child)) {
+        doomed.push_back(std::move(child));
+    }
+}
+
+void defer(ExprPtr &child) {
+    if (child) defer(static_cast<Expr &>(*child));
+}
+
+// Defers the children of one node for the lifetime of the scope; the outermost scope then destroys the whole list
+class Teardown {
+private:
+    bool outermost_;
+
+public:
+    Teardown() : outermost_(!draining) {
+        draining = true;
+    }
+
+    ~Teardown() {
+        if (!outermost_) {
+            return;
+        }
+        while (!doomed.empty()) {
+            Expr victim = std::move(doomed.back());
+            doomed.pop_back();
+        } // `victim` dies here and defers its own children
+        draining = false;
+    }
+
+    Teardown(const Teardown&) = delete;
+    Teardown& operator=(const Teardown&) = delete;
+};
+
+} // namespace
+
+void *AstNode::operator new(const size_t size) {
+    AstArena *arena = current_arena;
+    void *block = arena != nullptr
+        ? arena->allocate(sizeof(NodeHeader) + size, alignof(NodeHeader))
+        : ::operator new(sizeof(NodeHeader) + size);
+    auto *header = new (block) NodeHeader{arena};
+    return header + 1;
+}
+
+void AstNode::operator delete(void *ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    const NodeHeader *header = static_cast<NodeHeader *>(ptr) - 1;
+    if (header->arena == nullptr) {
+        ::operator delete(const_cast<NodeHeader *>(header));
+    }
+    // Arena storage is reclaimed all at once when the arena is destroyed
+}
+
+AstArena::AstArena(const size_t initial_size) : resource_(initial_size) {
+}
+
+void *AstArena::allocate(const size_t size, const size_t alignment) {
+    return resource_.allocate(size, alignment);
+}
+
+AstArena *AstArena::current() {
+    return current_arena;
+}
+
+AstArena::Scope::Scope(AstArena &arena) : previous_(current_arena) {
+    current_arena = &arena;
+}
+
+AstArena::Scope::~Scope() {
+    current_arena = previous_;
+}
+
+
+BinaryOp::~BinaryOp() {
+    Teardown teardown;
+    defer(left);
+    defer(right);
+}
+
+UnaryOp::~UnaryOp() {
+    Teardown teardown;
+    defer(operand);
+}
+
+FunctionCall::~FunctionCall() {
+    Teardown teardown;
+    for (Expr &arg : args) defer(arg);
+}
+
+CastExpr::~CastExpr() {
+    Teardown teardown;
+    defer(expr);
+}
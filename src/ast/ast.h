@@ -0,0 +1,51 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 27.12.2025.
+//
+
+#ifndef FLUXO_DB_AST_H
+#define FLUXO_DB_AST_H
+
+#include "ast_arena.h"
+#include "ast_expr.h"
+#include "ast_statements.h"
+
+#include <memory>
+#include <utility>
+
+// A statement together with the arena its expression nodes were allocated from. The pair moves as a whole and the
+// statement is read-only, so the tree cannot be moved out and outlive its arena. Members are destroyed in reverse
+// order, so the tree always goes before the arena that holds it.
+class ArenaStatement {
+private:
+    std::unique_ptr<AstArena> arena_;
+    Statement statement_;
+
+public:
+    ArenaStatement(std::unique_ptr<AstArena> arena, Statement statement)
+        : arena_(std::move(arena)), statement_(std::move(statement)) {}
+
+    [[nodiscard]] const AstArena &arena() const { return *arena_; }
+    [[nodiscard]] const Statement &statement() const & { return statement_; }
+    // A temporary would take its arena with it before the caller could use the statement
+    const Statement &statement() const && = delete;
+};
+
+#endif //FLUXO_DB_AST_H
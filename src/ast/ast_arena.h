@@ -0,0 +1,70 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_AST_ARENA_H
+#define FLUXO_DB_AST_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+class AstArena;
+
+// Base of every heap-allocated AST node (BinaryOp, UnaryOp, FunctionCall, CastExpr, Expression).
+// While an AstArena::Scope is active on the thread, `new` takes node storage from that arena and `delete` leaves it
+// there; otherwise nodes use the global heap as before. Each node remembers where it came from, so trees built with
+// and without an arena can be mixed freely.
+struct AstNode {
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr) noexcept;
+};
+
+// Bump allocator owning the expression nodes of one parsed statement. Nodes are laid out in allocation order, which
+// for a parsed tree is close to traversal order, and the whole block list is released at once when the arena dies.
+// An arena must outlive every node allocated from it.
+class AstArena {
+private:
+    std::pmr::monotonic_buffer_resource resource_;
+
+public:
+    explicit AstArena(size_t initial_size = 4096);
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    void *allocate(size_t size, size_t alignment);
+
+    // Arena of the innermost Scope on this thread, or nullptr
+    static AstArena *current();
+
+    // Routes AST node allocations on this thread to `arena` for the lifetime of the scope
+    class Scope {
+    private:
+        AstArena *previous_;
+
+    public:
+        explicit Scope(AstArena &arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+#endif //FLUXO_DB_AST_ARENA_H
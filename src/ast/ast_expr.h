@@ -5,33 +5,45 @@
 #ifndef FLUXO_DB_AST_EXPR_H
 #define FLUXO_DB_AST_EXPR_H
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <variant>
 #include <vector>
 #include <optional>
 
+#include "ast_arena.h"
+#include "symbol.h"
+
 struct ColumnRef;
 struct LiteralValue;
 struct BinaryOp;
 struct UnaryOp;
 struct FunctionCall;
 struct CastExpr;
+struct ParameterRef;
 
 
 struct TableRef {
-    std::string name;
-    std::optional<std::string> alias;
+    Symbol name;
+    std::optional<Symbol> alias;
 };
 
 struct ColumnRef {
-    std::string name;
-    std::optional<std::string> table_name; // Optional table name
+    Symbol name;
+    std::optional<Symbol> table_name; // Optional table name
 };
 
 enum class DataType {
     INTEGER, BIGINT, TEXT, BOOLEAN, DOUBLE, DATE, TIMESTAMP, VARCHAR, NULL_TYPE
 };
 
+// Placeholder for a value supplied at execution time. Slots are 1-based: $n is slot n, and each ? takes the next slot
+// in order of appearance.
+struct ParameterRef {
+    uint32_t index = 0;
+};
+
 struct LiteralValue {
     DataType type = DataType::NULL_TYPE; // NULL by default
 
@@ -66,42 +78,55 @@ using Expr = std::variant<
     std::unique_ptr<BinaryOp>,
     std::unique_ptr<UnaryOp>,
     std::unique_ptr<FunctionCall>,
-    std::unique_ptr<CastExpr>
+    std::unique_ptr<CastExpr>,
+    ParameterRef
 >;
 // Helper alias
-using ExprPtr = std::unique_ptr<Expr>;
+using ExprPtr = std::unique_ptr<Expression>;
 
-struct  BinaryOp {
+// The node destructors below never recurse: each hands its children to a per-thread worklist that the outermost
+// destructor drains, so tearing down a tree takes constant stack depth however deep the tree is (see ast.cpp).
+struct BinaryOp : AstNode {
     enum Op {
         PLUS, MINUS, MUL, DIV, EQ, NEQ, MOD, LT, LTE,
         GT, GTE, AND, OR, LIKE, ILIKE, NOT_LIKE
     } op;
     Expr left;
     Expr right;
+
+    ~BinaryOp();
 };
 
-struct UnaryOp {
+struct UnaryOp : AstNode {
     enum Op { NOT, IS_NULL, IS_NOT_NULL, MINUS } op;
     ExprPtr operand;
+
+    ~UnaryOp();
 };
 
-struct FunctionCall {
+struct FunctionCall : AstNode {
     std::string name; // "upper", "coalesce", "now", etc.
     std::vector<Expr> args;
     bool is_aggregate = false; // true for aggregate functions like SUM, COUNT, etc.
+
+    ~FunctionCall();
 };
 
-struct CastExpr {
+struct CastExpr : AstNode {
     ExprPtr expr;
     DataType target_type;
+
+    ~CastExpr();
 };
 
-struct Expression : Expr {
+struct Expression : Expr, AstNode {
     using Expr::Expr; // Inherit constructors
+    Expression() = default;
+    explicit Expression(Expr &&expr) : Expr(std::move(expr)) {}
 };
 
 struct ColumnDef {
-    std::string name;
+    Symbol name;
     DataType type;
     bool not_null = false;
     bool primary_key = false;
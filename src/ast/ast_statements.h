@@ -5,6 +5,7 @@
 #ifndef FLUXO_DB_AST_STATEMENTS_H
 #define FLUXO_DB_AST_STATEMENTS_H
 
+#include <cstdint>
 #include <string>
 #include <variant>
 #include <vector>
@@ -18,58 +19,58 @@ struct AddColumnAction {
 };
 
 struct AddConstraintAction {
-    std::string column_name;
+    Symbol column_name;
     bool not_null = false;
     bool unique = false;
     bool primary_key = false;
 };
 
 struct DropColumnAction {
-    std::string column_name;
+    Symbol column_name;
     bool if_exists = false;
     bool cascade = false;
 };
 
 struct DropConstraintAction {
-    std::string constraint_name;
+    Symbol constraint_name;
     bool if_exists = false;
     bool cascade = false;
 };
 
 struct AlterColumnTypeAction {
-    std::string column_name;
+    Symbol column_name;
     DataType new_type;
     Expr using_expr; // Optional USING expression
     std::string collation; // Optional collation
 };
 
 struct AlterColumnDefaultAction {
-    std::string column_name;
+    Symbol column_name;
     Expr default_expr; // The new default value;
     bool is_drop = false; // true if DROP DEFAULT
 };
 
 struct AlterColumnNotNullAction {
-    std::string column_name;
+    Symbol column_name;
     bool set_not_null = true; // true for SET NOT NULL, false for DROP NOT NULL
 };
 
 struct RenameColumnAction {
-    std::string old_name;
-    std::string new_name;
+    Symbol old_name;
+    Symbol new_name;
 };
 
 struct RenameTableAction {
-    std::string new_name;
+    Symbol new_name;
 };
 
 struct RenameConstraintAction {
-    std::string old_name;
-    std::string new_name;
+    Symbol old_name;
+    Symbol new_name;
 };
 
 struct SetSchemaAction {
-    std::string schema_name;
+    Symbol schema_name;
 };
 
 struct OwnerToAction {
@@ -119,7 +120,7 @@ enum class OrderDirection {
     DESC
 };
 struct IndexElem {
-    std::optional<std::string> name; // Column name
+    std::optional<Symbol> name; // Column name
     std::optional<Expr> expr;        // Expression (e.g., lower(col))
     std::optional<std::string> collation;
     std::optional<std::string> op_class; // e.g., varchar_pattern_ops
@@ -128,8 +129,8 @@ struct IndexElem {
 };
 
 struct CreateIndexStmt {
-    std::string index_name;
-    std::string table_name;
+    Symbol index_name;
+    Symbol table_name;
     bool unique = false;
     bool if_not_exists = false;
     bool concurrently = false;
@@ -162,11 +163,11 @@ enum class TriggerForEach {
 };
 
 struct CreateTriggerStmt {
-    std::string trigger_name;
-    std::string table_name;
+    Symbol trigger_name;
+    Symbol table_name;
     TriggerTiming timing; // BEFORE, AFTER, INSTEAD OF
     std::vector<TriggerEvent> events; // INSERT, UPDATE, DELETE, TRUNCATE
-    std::optional<std::vector<std::string>> update_of_columns; // For UPDATE OF
+    std::optional<std::vector<Symbol>> update_of_columns; // For UPDATE OF
     std::string function_name;
     std::vector<Expr> function_args;
     TriggerForEach for_each = TriggerForEach::STATEMENT; // Default to statement
@@ -174,7 +175,7 @@ struct CreateTriggerStmt {
 };
 
 struct CreateSequenceStmt {
-    std::string sequence_name;
+    Symbol sequence_name;
     bool if_not_exists = false;
     bool temporary = false;
     int64_t start_value = 1;
@@ -212,17 +213,61 @@ struct SelectStmt {
 };
 
 struct CreateViewStmt {
-    std::string view_name;
+    Symbol view_name;
     bool if_not_exists = false;
     bool temporary = false;
-    std::vector<std::string> columns; // Optional column names
+    std::vector<Symbol> columns; // Optional column names
     SelectStmt select_stmt; // The SELECT statement defining the view
 };
 
+// One VALUES column of a bulk INSERT, stored column-major. Every buffer holds a slot for every row; the slot of a
+// NULL row is zero (or an empty string) and its bit is set in `nulls`.
+struct ColumnBuffer {
+    DataType type = DataType::NULL_TYPE; // Type of the column's literals; NULL_TYPE while every value is NULL
+    std::vector<int64_t> integers;       // INTEGER, BIGINT and BOOLEAN (0 / 1) values
+    std::vector<double> doubles;         // DOUBLE values
+    std::vector<uint32_t> string_offsets; // TEXT: row i is string_data[string_offsets[i], string_offsets[i + 1])
+    std::string string_data;
+    std::vector<uint64_t> nulls;         // Bit i set when row i is NULL
+
+    [[nodiscard]] bool is_null(const size_t row) const {
+        return row / 64 < nulls.size() && (nulls[row / 64] >> (row % 64) & 1) != 0;
+    }
+
+    // Row `row` as the literal the general VALUES path would have produced
+    [[nodiscard]] LiteralValue literal(const size_t row) const {
+        if (type == DataType::NULL_TYPE || is_null(row)) {
+            return LiteralValue::Null();
+        }
+        switch (type) {
+            case DataType::DOUBLE:
+                return LiteralValue::Double(doubles[row]);
+            case DataType::TEXT:
+                return LiteralValue::Text(string_data.substr(string_offsets[row],
+                                                             string_offsets[row + 1] - string_offsets[row]));
+            case DataType::BOOLEAN:
+                return LiteralValue::Boolean(integers[row] != 0);
+            default:
+                return LiteralValue{type, integers[row]};
+        }
+    }
+};
+
+// VALUES rows of an INSERT in which every value is a plain literal
+struct BulkValues {
+    size_t row_count = 0;
+    std::vector<ColumnBuffer> columns;
+};
+
 struct InsertStmt {
-    std::string table_name;
-    std::vector<std::string> columns;
+    Symbol table_name;
+    std::vector<Symbol> columns;
+    // Rows are either general expressions in `values` or, when every value is a literal, typed column buffers in
+    // `bulk` (and `values` is empty)
     std::vector<std::vector<Expr>> values; // Multiple rows support
+    std::optional<BulkValues> bulk;
+
+    [[nodiscard]] size_t row_count() const { return bulk ? bulk->row_count : values.size(); }
 };
 
 struct TableConstraint {
@@ -233,14 +278,14 @@ struct TableConstraint {
         CHECK
     } type;
 
-    std::string name; // Constraint name (optional in SQL, but useful to generate if empty)
+    Symbol name; // Constraint name (optional in SQL, but useful to generate if empty)
 
     // For PK, UNIQUE, FK
-    std::vector<std::string> columns;
+    std::vector<Symbol> columns;
 
     // For FK
-    std::optional<std::string> foreign_table;
-    std::vector<std::string> foreign_columns;
+    std::optional<Symbol> foreign_table;
+    std::vector<Symbol> foreign_columns;
     // FK Actions
     char fk_match_type = 's'; // s=simple, f=full, p=partial
     char fk_update_action = 'a'; // a=no action, r=restrict, c=cascade, n=set null, d=set default
@@ -251,7 +296,7 @@ struct TableConstraint {
 };
 
 struct CreateTableStmt {
-    std::string table_name;
+    Symbol table_name;
     std::vector<ColumnDef> columns;
     std::vector<TableConstraint> constraints;
     bool if_not_exists = false;
@@ -267,7 +312,7 @@ using SchemaElement = std::variant<
 >;
 
 struct CreateSchemaStmt {
-    std::string schema_name;
+    Symbol schema_name;
     bool if_not_exists = false;
     std::optional<std::string> authorization; // Owner of the schema
     std::optional<std::vector<SchemaElement>> schema_elements; // Elements within the schema
@@ -301,7 +346,7 @@ enum class ObjectType {
 
 struct DropStmt {
     ObjectType object_type;
-    std::vector<std::string> names; // Names of objects to drop
+    std::vector<Symbol> names; // Names of objects to drop
     bool if_exists = false;
     bool cascade = false;
     bool restrict = false;
@@ -309,7 +354,7 @@ struct DropStmt {
 };
 
 struct AlterTableStmt {
-    std::string table_name;
+    Symbol table_name;
     bool if_exists = false; // IF EXISTS clause
     std::vector<AlterAction> actions; // List of alter actions
 };
@@ -0,0 +1,101 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_AST_VISIT_H
+#define FLUXO_DB_AST_VISIT_H
+#pragma once
+#include "ast_statements.h"
+#include <type_traits>
+#include <variant>
+
+// Call `f` on the root of every expression held by a statement: projections, predicates, VALUES rows, defaults,
+// index expressions, trigger arguments and so on. Works on const and non-const statements alike; `f` receives an
+// Expr& of matching constness and is responsible for descending into the expression itself.
+
+template <typename Select, typename F>
+void for_each_select_expr_root(Select &stmt, F &f) {
+    for (auto &projection : stmt.projections) f(projection);
+    if (stmt.where) f(*stmt.where);
+    if (stmt.having) f(*stmt.having);
+    for (auto &expr : stmt.group_by) f(expr);
+    for (auto &[expr, asc] : stmt.order_by) f(expr);
+}
+
+template <typename Create, typename F>
+void for_each_create_expr_root(Create &create, F &f) {
+    std::visit([&f]<typename T>(T &stmt) {
+        using S = std::remove_const_t<T>;
+        if constexpr (std::is_same_v<S, CreateTableStmt>) {
+            for (auto &constraint : stmt.constraints) {
+                if (constraint.check_expr) f(*constraint.check_expr);
+            }
+        } else if constexpr (std::is_same_v<S, CreateIndexStmt>) {
+            for (auto &param : stmt.params) {
+                if (param.expr) f(*param.expr);
+            }
+            if (stmt.where) f(*stmt.where);
+        } else if constexpr (std::is_same_v<S, CreateViewStmt>) {
+            for_each_select_expr_root(stmt.select_stmt, f);
+        } else if constexpr (std::is_same_v<S, CreateTriggerStmt>) {
+            for (auto &arg : stmt.function_args) f(arg);
+            if (stmt.when) f(*stmt.when);
+        } else if constexpr (std::is_same_v<S, CreateSchemaStmt>) {
+            if (stmt.schema_elements) {
+                for (auto &element : *stmt.schema_elements) for_each_create_expr_root(element, f);
+            }
+        }
+    }, create);
+}
+
+template <typename Alter, typename F>
+void for_each_alter_expr_root(Alter &stmt, F &f) {
+    for (auto &action : stmt.actions) {
+        if (auto *column_action = std::get_if<AlterColumnAction>(&action)) {
+            if (auto *type_action = std::get_if<AlterColumnTypeAction>(column_action)) {
+                f(type_action->using_expr);
+            } else if (auto *default_action = std::get_if<AlterColumnDefaultAction>(column_action)) {
+                f(default_action->default_expr);
+            }
+        }
+    }
+}
+
+template <typename S, typename F>
+    requires std::is_same_v<std::remove_const_t<S>, Statement>
+void for_each_expr_root(S &statement, F &&f) {
+    std::visit([&f]<typename T>(T &stmt) {
+        using U = std::remove_const_t<T>;
+        if constexpr (std::is_same_v<U, SelectStmt>) {
+            for_each_select_expr_root(stmt, f);
+        } else if constexpr (std::is_same_v<U, InsertStmt>) {
+            for (auto &row : stmt.values) {
+                for (auto &value : row) f(value);
+            }
+        } else if constexpr (std::is_same_v<U, CreateStmt>) {
+            for_each_create_expr_root(stmt, f);
+        } else if constexpr (std::is_same_v<U, AlterTableStmt>) {
+            for_each_alter_expr_root(stmt, f);
+        }
+    }, statement);
+}
+
+#endif //FLUXO_DB_AST_VISIT_H
@@ -0,0 +1,435 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "fingerprint.h"
+#include "ast_visit.h"
+#include "../ir/expr_ir.h"
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Marker mixed in for every literal and placeholder alike
+constexpr uint64_t value_slot_tag = 0x5eed'0f'51'07ull;
+
+// Expressions are lowered here before hashing. Hashing does not nest, so one IR per thread serves every Hasher, and
+// once it has grown to the largest expression seen it lowers without allocating.
+thread_local ExprIr scratch_ir;
+
+class Hasher {
+private:
+    uint64_t state_ = 0xcbf29ce484222325ull; // FNV-1a 64 offset basis
+    ExprIr &ir_ = scratch_ir;
+
+public:
+    void mix(const uint64_t value) {
+        // Fold a whole word per step, then spread it across the state
+        state_ = (state_ ^ value) * 0x100000001b3ull;
+        state_ ^= state_ >> 29;
+    }
+
+    void mix(const std::string_view text) {
+        mix(text.size());
+        for (const char c : text) {
+            state_ = (state_ ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+        }
+    }
+
+    void mix(const bool flag) { mix(static_cast<uint64_t>(flag ? 1 : 0)); }
+
+    template <typename E>
+        requires std::is_enum_v<E>
+    void mix(const E value) { mix(static_cast<uint64_t>(value)); }
+
+    template <typename T>
+    void mix(const std::optional<T> &value) {
+        mix(value.has_value());
+        if (value) mix(*value);
+    }
+
+    void mix(const std::string &text) { mix(std::string_view(text)); }
+    void mix(const Symbol symbol) { mix(symbol.text_hash()); }
+    void mix(const int64_t value) { mix(static_cast<uint64_t>(value)); }
+
+    template <typename T>
+    void mix(const std::vector<T> &values) {
+        mix(static_cast<uint64_t>(values.size()));
+        for (const T &value : values) mix(value);
+    }
+
+    void mix(const Expr &expr);
+    void mix(const ColumnDef &column);
+    void mix(const TableRef &table);
+    void mix(const IndexElem &elem);
+    void mix(const TableConstraint &constraint);
+    void mix(const SelectStmt &stmt);
+    void mix(const AlterAction &action);
+    void mix(const CreateStmt &stmt);
+    void mix(const SchemaElement &element);
+    void mix(const Statement &statement);
+
+    template <typename T>
+    void mix_create(const T &stmt);
+
+    // Final avalanche (MurmurHash3 fmix64) so nearby states give unrelated fingerprints
+    [[nodiscard]] uint64_t finish() const {
+        uint64_t h = state_;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+// Expressions are hashed as their IR: a forward scan over the post-order node array. Each node contributes its kind
+// and operator, and the arity of every kind is fixed (functions mix their argument count), so the sequence determines
+// the shape of the tree.
+void Hasher::mix(const Expr &root) {
+    ir_.clear();
+    ir_.lower(root);
+    for (const IrNode &node : ir_.nodes) {
+        switch (node.kind) {
+            case IrKind::INTEGER:
+            case IrKind::DOUBLE:
+            case IrKind::BOOLEAN:
+            case IrKind::TEXT:
+            case IrKind::PARAMETER:
+                mix(value_slot_tag);
+                continue;
+            case IrKind::NULL_VALUE:
+                if (node.op == 1) {
+                    mix(value_slot_tag); // NULL literal
+                    continue;
+                }
+                break;
+            default:
+                break;
+        }
+        mix(node.kind);
+        mix(static_cast<uint64_t>(node.op));
+        if (node.kind == IrKind::COLUMN) {
+            mix(ir_.columns[node.a].name);
+            mix(ir_.columns[node.a].table_name);
+        } else if (node.kind == IrKind::FUNCTION) {
+            mix(static_cast<uint64_t>(node.b));
+            mix(ir_.string(node.c));
+        } else if (node.kind == IrKind::CAST) {
+            mix(node.type);
+        }
+    }
+}
+
+void Hasher::mix(const ColumnDef &column) {
+    mix(column.name);
+    mix(column.type);
+    mix(column.not_null);
+    mix(column.primary_key);
+    mix(column.unique);
+}
+
+void Hasher::mix(const TableRef &table) {
+    mix(table.name);
+    mix(table.alias);
+}
+
+void Hasher::mix(const IndexElem &elem) {
+    mix(elem.name);
+    mix(elem.expr);
+    mix(elem.collation);
+    mix(elem.op_class);
+    mix(elem.ordering);
+    mix(elem.nulls_first);
+}
+
+void Hasher::mix(const TableConstraint &constraint) {
+    mix(constraint.type);
+    mix(constraint.name);
+    mix(constraint.columns);
+    mix(constraint.foreign_table);
+    mix(constraint.foreign_columns);
+    mix(static_cast<uint64_t>(constraint.fk_match_type));
+    mix(static_cast<uint64_t>(constraint.fk_update_action));
+    mix(static_cast<uint64_t>(constraint.fk_delete_action));
+    mix(constraint.check_expr);
+}
+
+void Hasher::mix(const SelectStmt &stmt) {
+    mix(stmt.projections);
+    mix(stmt.from);
+    mix(stmt.where);
+    mix(stmt.having);
+    mix(stmt.group_by);
+    mix(static_cast<uint64_t>(stmt.order_by.size()));
+    for (const auto &[expr, asc] : stmt.order_by) {
+        mix(expr);
+        mix(asc);
+    }
+    mix(stmt.limit);
+    mix(stmt.offset);
+    mix(stmt.distinct);
+}
+
+void Hasher::mix(const AlterAction &action) {
+    mix(static_cast<uint64_t>(action.index()));
+    std::visit([this]<typename T>(const T &group) {
+        if constexpr (std::is_same_v<T, SetSchemaAction>) {
+            mix(group.schema_name);
+        } else if constexpr (std::is_same_v<T, OwnerToAction>) {
+            mix(group.new_owner);
+        } else {
+            mix(static_cast<uint64_t>(group.index()));
+            std::visit([this]<typename A>(const A &a) {
+                if constexpr (std::is_same_v<A, AddColumnAction>) {
+                    mix(a.column_def);
+                    mix(a.if_not_exists);
+                } else if constexpr (std::is_same_v<A, AddConstraintAction>) {
+                    mix(a.column_name);
+                    mix(a.not_null);
+                    mix(a.unique);
+                    mix(a.primary_key);
+                } else if constexpr (std::is_same_v<A, DropColumnAction>) {
+                    mix(a.column_name);
+                    mix(a.if_exists);
+                    mix(a.cascade);
+                } else if constexpr (std::is_same_v<A, DropConstraintAction>) {
+                    mix(a.constraint_name);
+                    mix(a.if_exists);
+                    mix(a.cascade);
+                } else if constexpr (std::is_same_v<A, AlterColumnTypeAction>) {
+                    mix(a.column_name);
+                    mix(a.new_type);
+                    mix(a.using_expr);
+                    mix(a.collation);
+                } else if constexpr (std::is_same_v<A, AlterColumnDefaultAction>) {
+                    mix(a.column_name);
+                    mix(a.default_expr);
+                    mix(a.is_drop);
+                } else if constexpr (std::is_same_v<A, AlterColumnNotNullAction>) {
+                    mix(a.column_name);
+                    mix(a.set_not_null);
+                } else if constexpr (std::is_same_v<A, RenameColumnAction> || std::is_same_v<A, RenameConstraintAction>) {
+                    mix(a.old_name);
+                    mix(a.new_name);
+                } else if constexpr (std::is_same_v<A, RenameTableAction>) {
+                    mix(a.new_name);
+                }
+            }, group);
+        }
+    }, action);
+}
+
+template <typename T>
+void Hasher::mix_create(const T &stmt) {
+    if constexpr (std::is_same_v<T, CreateTableStmt>) {
+        mix(stmt.table_name);
+        mix(stmt.columns);
+        mix(stmt.constraints);
+        mix(stmt.if_not_exists);
+        mix(stmt.tablespace);
+    } else if constexpr (std::is_same_v<T, CreateIndexStmt>) {
+        mix(stmt.index_name);
+        mix(stmt.table_name);
+        mix(stmt.unique);
+        mix(stmt.if_not_exists);
+        mix(stmt.concurrently);
+        mix(stmt.only);
+        mix(stmt.method);
+        mix(stmt.params);
+        mix(stmt.where);
+        mix(stmt.tablespace);
+    } else if constexpr (std::is_same_v<T, CreateViewStmt>) {
+        mix(stmt.view_name);
+        mix(stmt.if_not_exists);
+        mix(stmt.temporary);
+        mix(stmt.columns);
+        mix(stmt.select_stmt);
+    } else if constexpr (std::is_same_v<T, CreateSchemaStmt>) {
+        mix(stmt.schema_name);
+        mix(stmt.if_not_exists);
+        mix(stmt.authorization);
+        mix(stmt.schema_elements.has_value());
+        if (stmt.schema_elements) mix(*stmt.schema_elements);
+    } else if constexpr (std::is_same_v<T, CreateTriggerStmt>) {
+        mix(stmt.trigger_name);
+        mix(stmt.table_name);
+        mix(stmt.timing);
+        mix(stmt.events);
+        mix(stmt.update_of_columns);
+        mix(stmt.function_name);
+        mix(stmt.function_args);
+        mix(stmt.for_each);
+        mix(stmt.when);
+    } else if constexpr (std::is_same_v<T, CreateSequenceStmt>) {
+        mix(stmt.sequence_name);
+        mix(stmt.if_not_exists);
+        mix(stmt.temporary);
+        mix(stmt.start_value);
+        mix(stmt.increment_by);
+        mix(stmt.min_value);
+        mix(stmt.max_value);
+        mix(stmt.cycle);
+        mix(stmt.cache_size);
+        mix(stmt.owner.has_value());
+        if (stmt.owner) {
+            mix(stmt.owner->first);
+            mix(stmt.owner->second);
+        }
+    } else if constexpr (std::is_same_v<T, CreateDatabaseStmt>) {
+        mix(stmt.name);
+        mix(stmt.if_not_exists);
+        mix(stmt.user_name);
+        mix(stmt.encoding);
+        mix(stmt.tablespace_name);
+        mix(stmt.allow_conn);
+        mix(stmt.conn_limit);
+    } else if constexpr (std::is_same_v<T, CreateCollationStmt>) {
+        mix(stmt.collation_name);
+        mix(stmt.locale);
+        mix(stmt.if_not_exists);
+        mix(stmt.deterministic);
+        mix(stmt.provider);
+        mix(stmt.version);
+        mix(stmt.rules);
+        mix(stmt.existing_collation_name);
+    } else if constexpr (std::is_same_v<T, CreateRoleStmt>) {
+        mix(stmt.role_name);
+        mix(stmt.if_not_exists);
+        mix(stmt.superuser);
+        mix(stmt.createdb);
+        mix(stmt.createrole);
+        mix(stmt.inherit);
+        mix(stmt.login);
+        mix(stmt.conn_limit);
+        mix(stmt.valid_until);
+        mix(stmt.password);
+    }
+}
+
+void Hasher::mix(const CreateStmt &stmt) {
+    mix(static_cast<uint64_t>(stmt.index()));
+    std::visit([this](const auto &create) { mix_create(create); }, stmt);
+}
+
+void Hasher::mix(const SchemaElement &element) {
+    mix(static_cast<uint64_t>(element.index()));
+    std::visit([this](const auto &create) { mix_create(create); }, element);
+}
+
+void Hasher::mix(const Statement &statement) {
+    mix(static_cast<uint64_t>(statement.index()));
+    std::visit([this]<typename T>(const T &stmt) {
+        if constexpr (std::is_same_v<T, SelectStmt>) {
+            mix(stmt);
+        } else if constexpr (std::is_same_v<T, InsertStmt>) {
+            mix(stmt.table_name);
+            mix(stmt.columns);
+            if (stmt.bulk) {
+                // Hash bulk rows exactly like the same rows held as literal expressions
+                mix(static_cast<uint64_t>(stmt.bulk->row_count));
+                for (size_t row = 0; row < stmt.bulk->row_count; ++row) {
+                    mix(static_cast<uint64_t>(stmt.bulk->columns.size()));
+                    for (size_t cell = 0; cell < stmt.bulk->columns.size(); ++cell) {
+                        mix(value_slot_tag);
+                    }
+                }
+            } else {
+                mix(stmt.values);
+            }
+        } else if constexpr (std::is_same_v<T, CreateStmt>) {
+            mix(stmt);
+        } else if constexpr (std::is_same_v<T, DropStmt>) {
+            mix(stmt.object_type);
+            mix(stmt.names);
+            mix(stmt.if_exists);
+            mix(stmt.cascade);
+            mix(stmt.restrict);
+            mix(stmt.concurrently);
+        } else if constexpr (std::is_same_v<T, AlterTableStmt>) {
+            mix(stmt.table_name);
+            mix(stmt.if_exists);
+            mix(stmt.actions);
+        }
+    }, statement);
+}
+
+// Pre-order over an explicit stack, as fold() walks its trees, so that arbitrarily deep expressions cannot overflow the
+// call stack. Children are pushed in reverse, so slots are still numbered left to right.
+void replace_literals(Expr &root, uint32_t &next_slot, std::vector<LiteralValue> &removed) {
+    std::vector<Expr *> stack{&root};
+    while (!stack.empty()) {
+        Expr &expr = *stack.back();
+        stack.pop_back();
+        if (auto *literal = std::get_if<LiteralValue>(&expr)) {
+            removed.push_back(std::move(*literal));
+            expr = ParameterRef{next_slot++};
+        } else if (const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(&expr)) {
+            stack.push_back(&(*binary)->right);
+            stack.push_back(&(*binary)->left);
+        } else if (const auto *unary = std::get_if<std::unique_ptr<UnaryOp>>(&expr)) {
+            if (Expression *operand = (*unary)->operand.get()) stack.push_back(operand);
+        } else if (const auto *call = std::get_if<std::unique_ptr<FunctionCall>>(&expr)) {
+            for (auto arg = (*call)->args.rbegin(); arg != (*call)->args.rend(); ++arg) stack.push_back(&*arg);
+        } else if (const auto *cast = std::get_if<std::unique_ptr<CastExpr>>(&expr)) {
+            if (Expression *operand = (*cast)->expr.get()) stack.push_back(operand);
+        }
+    }
+}
+
+} // namespace
+
+uint64_t fingerprint(const Statement &statement) {
+    Hasher hasher;
+    hasher.mix(statement);
+    return hasher.finish();
+}
+
+uint64_t fingerprint(const Expr &expr) {
+    Hasher hasher;
+    hasher.mix(expr);
+    return hasher.finish();
+}
+
+std::vector<LiteralValue> normalize_literals(Statement &statement, const uint32_t first_slot) {
+    std::vector<LiteralValue> removed;
+    uint32_t next_slot = first_slot;
+    if (auto *insert = std::get_if<InsertStmt>(&statement); insert && insert->bulk) {
+        // Bulk rows hold nothing but literals: each cell becomes a slot, in the order the rows would be visited
+        const BulkValues bulk = std::move(*insert->bulk);
+        insert->bulk.reset();
+        removed.reserve(bulk.row_count * bulk.columns.size());
+        insert->values.reserve(bulk.row_count);
+        for (size_t row = 0; row < bulk.row_count; ++row) {
+            std::vector<Expr> &values = insert->values.emplace_back();
+            values.reserve(bulk.columns.size());
+            for (const ColumnBuffer &column : bulk.columns) {
+                removed.push_back(column.literal(row));
+                values.emplace_back(ParameterRef{next_slot++});
+            }
+        }
+    }
+    for_each_expr_root(statement, [&](Expr &root) { replace_literals(root, next_slot, removed); });
+    return removed;
+}
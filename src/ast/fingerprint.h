@@ -0,0 +1,45 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_FINGERPRINT_H
+#define FLUXO_DB_FINGERPRINT_H
+#pragma once
+#include "ast_statements.h"
+#include <cstdint>
+#include <vector>
+
+// Query fingerprints. Two statements get the same fingerprint when they differ only in the literal values inside
+// expressions, so "WHERE b = 5", "WHERE b = 7" and "WHERE b = $1" all share one shape. Everything else (names,
+// operators, clause structure, DDL options) is part of the fingerprint.
+// Each expression is hashed as a scan over its ExprIr, lowered into per-thread scratch space that is reused from call
+// to call, so hashing allocates only while that space grows to the largest expression the thread has seen. The hash
+// does not depend on the process, so fingerprints can be stored and compared across runs.
+
+uint64_t fingerprint(const Statement &statement);
+uint64_t fingerprint(const Expr &expr);
+
+// Replace every literal in expression position with a ParameterRef, numbering slots from `first_slot` in visiting
+// order. Returns the literals that were removed, where element i was slot first_slot + i.
+// Pass Parser::parameter_count() + 1 to keep slots clear of the statement's own placeholders.
+std::vector<LiteralValue> normalize_literals(Statement &statement, uint32_t first_slot = 1);
+
+#endif //FLUXO_DB_FINGERPRINT_H
@@ -0,0 +1,556 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "serialize.h"
+#include "../ir/expr_ir.h"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+constexpr std::string_view magic = "FXAS";
+// Expressions are encoded through an IR. Encoding does not nest, so one per thread serves every Writer and keeps its
+// capacity from statement to statement.
+thread_local ExprIr scratch_ir;
+
+template <typename T> struct is_optional : std::false_type {};
+template <typename T> struct is_optional<std::optional<T>> : std::true_type {};
+template <typename T> struct is_vector : std::false_type {};
+template <typename T> struct is_vector<std::vector<T>> : std::true_type {};
+template <typename T> struct is_pair : std::false_type {};
+template <typename A, typename B> struct is_pair<std::pair<A, B>> : std::true_type {};
+template <typename T> struct is_variant : std::false_type {};
+template <typename... Ts> struct is_variant<std::variant<Ts...>> : std::true_type {};
+
+template <typename T, typename U>
+constexpr bool is = std::is_same_v<std::remove_const_t<T>, U>;
+
+// Last enumerator of every enum the encoding carries, so the decoder can reject values no encoder writes
+template <typename E>
+constexpr E last_enumerator() {
+    if constexpr (is<E, DataType>) return DataType::NULL_TYPE;
+    else if constexpr (is<E, OrderDirection>) return OrderDirection::DESC;
+    else if constexpr (is<E, TriggerEvent>) return TriggerEvent::TRUNCATE;
+    else if constexpr (is<E, TriggerTiming>) return TriggerTiming::INSTEAD_OF;
+    else if constexpr (is<E, TriggerForEach>) return TriggerForEach::STATEMENT;
+    else if constexpr (is<E, TableConstraint::Type>) return TableConstraint::Type::CHECK;
+    else if constexpr (is<E, ObjectType>) return ObjectType::TYPE;
+    else if constexpr (is<E, IrKind>) return IrKind::PARAMETER;
+    else static_assert(sizeof(E) == 0, "Enum without a last enumerator");
+}
+
+// Call `f` with every field of an AST struct, in declaration order. S may be const (encoding) or not (decoding), so
+// the field list is written once for both directions.
+template <typename S, typename F>
+void describe(S &s, F &&f) {
+    if constexpr (is<S, TableRef>) f(s.name, s.alias);
+    else if constexpr (is<S, ColumnRef>) f(s.name, s.table_name);
+    else if constexpr (is<S, ColumnDef>) f(s.name, s.type, s.not_null, s.primary_key, s.unique);
+    else if constexpr (is<S, AddColumnAction>) f(s.column_def, s.if_not_exists);
+    else if constexpr (is<S, AddConstraintAction>) f(s.column_name, s.not_null, s.unique, s.primary_key);
+    else if constexpr (is<S, DropColumnAction>) f(s.column_name, s.if_exists, s.cascade);
+    else if constexpr (is<S, DropConstraintAction>) f(s.constraint_name, s.if_exists, s.cascade);
+    else if constexpr (is<S, AlterColumnTypeAction>) f(s.column_name, s.new_type, s.using_expr, s.collation);
+    else if constexpr (is<S, AlterColumnDefaultAction>) f(s.column_name, s.default_expr, s.is_drop);
+    else if constexpr (is<S, AlterColumnNotNullAction>) f(s.column_name, s.set_not_null);
+    else if constexpr (is<S, RenameColumnAction> || is<S, RenameConstraintAction>) f(s.old_name, s.new_name);
+    else if constexpr (is<S, RenameTableAction>) f(s.new_name);
+    else if constexpr (is<S, SetSchemaAction>) f(s.schema_name);
+    else if constexpr (is<S, OwnerToAction>) f(s.new_owner);
+    else if constexpr (is<S, CreateCollationStmt>) {
+        f(s.collation_name, s.locale, s.if_not_exists, s.deterministic, s.provider, s.version, s.rules,
+          s.existing_collation_name);
+    } else if constexpr (is<S, CreateDatabaseStmt>) {
+        f(s.name, s.if_not_exists, s.user_name, s.encoding, s.tablespace_name, s.allow_conn, s.conn_limit);
+    } else if constexpr (is<S, IndexElem>) {
+        f(s.name, s.expr, s.collation, s.op_class, s.ordering, s.nulls_first);
+    } else if constexpr (is<S, CreateIndexStmt>) {
+        f(s.index_name, s.table_name, s.unique, s.if_not_exists, s.concurrently, s.only, s.method, s.params, s.where,
+          s.tablespace);
+    } else if constexpr (is<S, CreateTriggerStmt>) {
+        f(s.trigger_name, s.table_name, s.timing, s.events, s.update_of_columns, s.function_name, s.function_args,
+          s.for_each, s.when);
+    } else if constexpr (is<S, CreateSequenceStmt>) {
+        f(s.sequence_name, s.if_not_exists, s.temporary, s.start_value, s.increment_by, s.min_value, s.max_value,
+          s.cycle, s.cache_size, s.owner);
+    } else if constexpr (is<S, CreateRoleStmt>) {
+        f(s.role_name, s.if_not_exists, s.superuser, s.createdb, s.createrole, s.inherit, s.login, s.conn_limit,
+          s.valid_until, s.password);
+    } else if constexpr (is<S, SelectStmt>) {
+        f(s.projections, s.from, s.where, s.having, s.group_by, s.order_by, s.limit, s.offset, s.distinct);
+    } else if constexpr (is<S, CreateViewStmt>) {
+        f(s.view_name, s.if_not_exists, s.temporary, s.columns, s.select_stmt);
+    } else if constexpr (is<S, ColumnBuffer>) {
+        f(s.type, s.integers, s.doubles, s.string_offsets, s.string_data, s.nulls);
+    } else if constexpr (is<S, BulkValues>) {
+        f(s.row_count, s.columns);
+    } else if constexpr (is<S, InsertStmt>) {
+        f(s.table_name, s.columns, s.values, s.bulk);
+    } else if constexpr (is<S, TableConstraint>) {
+        f(s.type, s.name, s.columns, s.foreign_table, s.foreign_columns, s.fk_match_type, s.fk_update_action,
+          s.fk_delete_action, s.check_expr);
+    } else if constexpr (is<S, CreateTableStmt>) {
+        f(s.table_name, s.columns, s.constraints, s.if_not_exists, s.tablespace);
+    } else if constexpr (is<S, CreateSchemaStmt>) {
+        f(s.schema_name, s.if_not_exists, s.authorization, s.schema_elements);
+    } else if constexpr (is<S, DropStmt>) {
+        f(s.object_type, s.names, s.if_exists, s.cascade, s.restrict, s.concurrently);
+    } else if constexpr (is<S, AlterTableStmt>) {
+        f(s.table_name, s.if_exists, s.actions);
+    } else {
+        static_assert(sizeof(S) == 0, "AST type without a field description");
+    }
+}
+
+class Writer {
+private:
+    std::string &out_;
+    ExprIr &ir_ = scratch_ir;
+
+    void put_varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<char>(value));
+    }
+
+    void put_string(const std::string_view text) {
+        put_varint(text.size());
+        out_.append(text);
+    }
+
+public:
+    explicit Writer(std::string &out) : out_(out) {}
+
+    // An expression is written as its IR, node by node in post-order. The arity of each node kind is fixed, so child
+    // indices are implied and the decoder rebuilds them with a stack; literal values and names are written inline.
+    void put_expr(const Expr &expr) {
+        ir_.clear();
+        ir_.lower(expr);
+        put(ir_.columns);
+        put_varint(ir_.nodes.size());
+        for (const IrNode &node : ir_.nodes) {
+            put(node.kind);
+            switch (node.kind) {
+                case IrKind::NULL_VALUE:
+                    put(node.op);
+                    put(node.type);
+                    break;
+                case IrKind::COLUMN:
+                case IrKind::PARAMETER:
+                    put(node.a);
+                    break;
+                case IrKind::INTEGER:
+                    put(node.type);
+                    put(ir_.integers[node.a]);
+                    break;
+                case IrKind::DOUBLE:
+                    put(node.type);
+                    put(ir_.doubles[node.a]);
+                    break;
+                case IrKind::BOOLEAN:
+                    put(node.type);
+                    put(node.a);
+                    break;
+                case IrKind::TEXT:
+                    put(node.type);
+                    put_string(ir_.string(node.a));
+                    break;
+                case IrKind::BINARY:
+                case IrKind::UNARY:
+                    put(node.op);
+                    break;
+                case IrKind::FUNCTION:
+                    put(node.op);
+                    put(node.b);
+                    put_string(ir_.string(node.c));
+                    break;
+                case IrKind::CAST:
+                    put(node.type);
+                    break;
+            }
+        }
+    }
+
+    template <typename T>
+    void put(const T &value) {
+        if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+            out_.push_back(static_cast<char>(value));
+        } else if constexpr (std::is_enum_v<T>) {
+            put_varint(static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            const auto bits = std::bit_cast<uint64_t>(static_cast<double>(value));
+            for (int shift = 0; shift < 64; shift += 8) out_.push_back(static_cast<char>(bits >> shift));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            const auto wide = static_cast<int64_t>(value);
+            put_varint((static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63)); // Zigzag
+        } else if constexpr (std::is_integral_v<T>) {
+            put_varint(static_cast<uint64_t>(value));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            put_string(value);
+        } else if constexpr (std::is_same_v<T, Symbol>) {
+            put(value.str()); // Ids are local to the process, so names travel as text
+        } else if constexpr (std::is_same_v<T, std::monostate>) {
+        } else if constexpr (is_optional<T>::value) {
+            put(value.has_value());
+            if (value) put(*value);
+        } else if constexpr (is_vector<T>::value) {
+            put_varint(value.size());
+            for (const auto &element : value) put(element);
+        } else if constexpr (is_pair<T>::value) {
+            put(value.first);
+            put(value.second);
+        } else if constexpr (std::is_same_v<T, Expr>) {
+            put_expr(value);
+        } else if constexpr (is_variant<T>::value) {
+            put_varint(value.index());
+            std::visit([this](const auto &alternative) { put(alternative); }, value);
+        } else {
+            describe(value, [this](const auto &...fields) { (put(fields), ...); });
+        }
+    }
+};
+
+class Reader {
+private:
+    std::string_view buffer_;
+    size_t position_ = 0;
+
+    [[noreturn]] static void truncated() {
+        throw std::runtime_error("Truncated serialized statement");
+    }
+
+    [[noreturn]] static void malformed_expression() {
+        throw std::runtime_error("Malformed expression in serialized statement");
+    }
+
+    uint8_t get_byte() {
+        if (position_ >= buffer_.size()) truncated();
+        return static_cast<uint8_t>(buffer_[position_++]);
+    }
+
+    // Element counts are checked against the bytes left, so a corrupt length cannot trigger a huge allocation
+    size_t get_count() {
+        const uint64_t count = get_varint();
+        if (count > buffer_.size() - position_) truncated();
+        return static_cast<size_t>(count);
+    }
+
+    // A decoded bulk INSERT must be one the parser could have built, since ColumnBuffer::literal and the storage layer
+    // index its buffers by row without checking. Every column has one slot per row in the buffer of its type and
+    // leaves the others empty, TEXT offsets ascend through the whole of string_data, no null bit lies past the last
+    // row, and a NULL_TYPE column is NULL in every row.
+    static void check_bulk(const BulkValues &bulk) {
+        const auto invalid = [] { throw std::runtime_error("Malformed bulk column in serialized statement"); };
+        const size_t rows = bulk.row_count;
+        const size_t words = rows / 64 + (rows % 64 != 0 ? 1 : 0);
+        const uint64_t last_word = rows % 64 != 0 ? (uint64_t{1} << (rows % 64)) - 1 : ~uint64_t{0};
+        if (bulk.columns.empty()) invalid();
+        for (const ColumnBuffer &column : bulk.columns) {
+            const DataType type = column.type;
+            const bool integers = type != DataType::NULL_TYPE && type != DataType::DOUBLE && type != DataType::TEXT;
+            if (column.integers.size() != (integers ? rows : 0) ||
+                column.doubles.size() != (type == DataType::DOUBLE ? rows : 0)) {
+                invalid();
+            }
+            const std::vector<uint32_t> &offsets = column.string_offsets;
+            if (type == DataType::TEXT) {
+                if (offsets.empty() || offsets.size() - 1 != rows || offsets.front() != 0 ||
+                    offsets.back() != column.string_data.size() || !std::is_sorted(offsets.begin(), offsets.end())) {
+                    invalid();
+                }
+            } else if (!offsets.empty() || !column.string_data.empty()) {
+                invalid();
+            }
+            const std::vector<uint64_t> &nulls = column.nulls;
+            if (nulls.size() > words || (nulls.size() == words && words > 0 && (nulls.back() & ~last_word) != 0)) {
+                invalid();
+            }
+            if (type == DataType::NULL_TYPE) {
+                if (nulls.size() != words) invalid();
+                for (size_t word = 0; word < words; ++word) {
+                    if (nulls[word] != (word + 1 == words ? last_word : ~uint64_t{0})) invalid();
+                }
+            }
+        }
+    }
+
+    template <typename V, size_t... I>
+    void get_alternative(V &value, const size_t index, std::index_sequence<I...>) {
+        ((index == I && (get(value.template emplace<I>()), true)) || ...);
+    }
+
+public:
+    explicit Reader(const std::string_view buffer) : buffer_(buffer) {}
+
+    [[nodiscard]] bool done() const { return position_ == buffer_.size(); }
+
+    // Inverse of Writer::put_expr. The tree is built directly from the post-order stream, as ExprIr::raise builds it
+    // from the node array: each node takes its children from a stack of finished subtrees. Every operator, type and
+    // link is checked on the way, so a corrupt buffer cannot yield a malformed tree.
+    void get_expr(Expr &value) {
+        struct Subtree {
+            Expr expr;
+            bool absent; // Stands in for the null ExprPtr of a UNARY or CAST operand
+        };
+        // Per-thread scratch, emptied on every exit: its nodes may live in an arena that does not outlive the call
+        thread_local std::vector<Subtree> subtrees;
+        thread_local std::vector<ColumnRef> columns;
+        struct Release {
+            ~Release() { subtrees.clear(); }
+        } release;
+        subtrees.clear();
+
+        get(columns);
+        const size_t count = get_count();
+        const auto take = [] {
+            if (subtrees.empty() || subtrees.back().absent) malformed_expression();
+            Expr child = std::move(subtrees.back().expr);
+            subtrees.pop_back();
+            return child;
+        };
+        const auto take_operand = [&take]() -> ExprPtr {
+            if (!subtrees.empty() && subtrees.back().absent) {
+                subtrees.pop_back();
+                return nullptr;
+            }
+            return std::make_unique<Expression>(take());
+        };
+        const auto get_type = [this] {
+            DataType type;
+            get(type);
+            return type;
+        };
+        for (size_t i = 0; i < count; ++i) {
+            IrKind kind;
+            get(kind);
+            switch (kind) {
+                case IrKind::NULL_VALUE: {
+                    const uint64_t op = get_varint();
+                    const DataType type = get_type();
+                    if (op > 2) malformed_expression();
+                    if (op == 1) {
+                        subtrees.push_back({LiteralValue{type, std::monostate{}}, false});
+                    } else {
+                        subtrees.push_back({std::monostate{}, op == 2});
+                    }
+                    break;
+                }
+                case IrKind::COLUMN: {
+                    const uint64_t column = get_varint();
+                    if (column >= columns.size()) malformed_expression();
+                    subtrees.push_back({columns[column], false});
+                    break;
+                }
+                case IrKind::PARAMETER: {
+                    ParameterRef parameter;
+                    get(parameter.index);
+                    subtrees.push_back({parameter, false});
+                    break;
+                }
+                case IrKind::INTEGER: {
+                    LiteralValue literal{get_type(), int64_t{0}};
+                    get(std::get<int64_t>(literal.value));
+                    subtrees.push_back({std::move(literal), false});
+                    break;
+                }
+                case IrKind::DOUBLE: {
+                    LiteralValue literal{get_type(), 0.0};
+                    get(std::get<double>(literal.value));
+                    subtrees.push_back({std::move(literal), false});
+                    break;
+                }
+                case IrKind::BOOLEAN: {
+                    const DataType type = get_type();
+                    const uint64_t flag = get_varint();
+                    if (flag > 1) malformed_expression();
+                    subtrees.push_back({LiteralValue{type, flag != 0}, false});
+                    break;
+                }
+                case IrKind::TEXT: {
+                    LiteralValue literal{get_type(), std::string()};
+                    get(std::get<std::string>(literal.value));
+                    subtrees.push_back({std::move(literal), false});
+                    break;
+                }
+                case IrKind::BINARY: {
+                    auto binary = std::make_unique<BinaryOp>();
+                    const uint64_t op = get_varint();
+                    if (op > BinaryOp::NOT_LIKE) malformed_expression();
+                    binary->op = static_cast<BinaryOp::Op>(op);
+                    binary->right = take();
+                    binary->left = take();
+                    subtrees.push_back({std::move(binary), false});
+                    break;
+                }
+                case IrKind::UNARY: {
+                    auto unary = std::make_unique<UnaryOp>();
+                    const uint64_t op = get_varint();
+                    if (op > UnaryOp::MINUS) malformed_expression();
+                    unary->op = static_cast<UnaryOp::Op>(op);
+                    unary->operand = take_operand();
+                    subtrees.push_back({std::move(unary), false});
+                    break;
+                }
+                case IrKind::FUNCTION: {
+                    auto call = std::make_unique<FunctionCall>();
+                    const uint64_t aggregate = get_varint();
+                    const uint64_t arguments = get_varint();
+                    get(call->name);
+                    if (aggregate > 1 || arguments > subtrees.size()) malformed_expression();
+                    call->is_aggregate = aggregate != 0;
+                    call->args.resize(arguments);
+                    for (size_t arg = arguments; arg-- > 0;) call->args[arg] = take();
+                    subtrees.push_back({std::move(call), false});
+                    break;
+                }
+                case IrKind::CAST: {
+                    auto cast = std::make_unique<CastExpr>();
+                    cast->target_type = get_type();
+                    cast->expr = take_operand();
+                    subtrees.push_back({std::move(cast), false});
+                    break;
+                }
+                default:
+                    malformed_expression();
+            }
+        }
+        if (subtrees.size() != 1) malformed_expression();
+        value = take();
+    }
+
+    std::string_view get_bytes(const size_t length) {
+        if (length > buffer_.size() - position_) truncated();
+        const std::string_view bytes = buffer_.substr(position_, length);
+        position_ += length;
+        return bytes;
+    }
+
+    uint64_t get_varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = get_byte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        throw std::runtime_error("Malformed varint in serialized statement");
+    }
+
+    template <typename T>
+    void get(T &value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            value = get_byte() != 0;
+        } else if constexpr (std::is_same_v<T, char>) {
+            value = static_cast<char>(get_byte());
+        } else if constexpr (std::is_enum_v<T>) {
+            const uint64_t raw = get_varint();
+            if (raw > static_cast<uint64_t>(last_enumerator<T>())) {
+                throw std::runtime_error("Invalid enumerator in serialized statement");
+            }
+            value = static_cast<T>(raw);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            uint64_t bits = 0;
+            for (int shift = 0; shift < 64; shift += 8) bits |= static_cast<uint64_t>(get_byte()) << shift;
+            value = static_cast<T>(std::bit_cast<double>(bits));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            const uint64_t zigzag = get_varint();
+            value = static_cast<T>(static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1));
+        } else if constexpr (std::is_integral_v<T>) {
+            value = static_cast<T>(get_varint());
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            value.assign(get_bytes(get_count()));
+        } else if constexpr (std::is_same_v<T, Symbol>) {
+            value = Symbol(get_bytes(get_count()));
+        } else if constexpr (std::is_same_v<T, std::monostate>) {
+        } else if constexpr (is_optional<T>::value) {
+            if (get_byte() != 0) {
+                get(value.emplace());
+            } else {
+                value.reset();
+            }
+        } else if constexpr (is_vector<T>::value) {
+            const size_t count = get_count();
+            value.clear();
+            value.resize(count);
+            for (auto &element : value) get(element);
+        } else if constexpr (is_pair<T>::value) {
+            get(value.first);
+            get(value.second);
+        } else if constexpr (std::is_same_v<T, Expr>) {
+            get_expr(value);
+        } else if constexpr (std::is_same_v<T, BulkValues>) {
+            describe(value, [this](auto &...fields) { (get(fields), ...); });
+            check_bulk(value);
+        } else if constexpr (is_variant<T>::value) {
+            const uint64_t index = get_varint();
+            if (index >= std::variant_size_v<T>) {
+                throw std::runtime_error("Invalid variant index in serialized statement");
+            }
+            get_alternative(value, static_cast<size_t>(index), std::make_index_sequence<std::variant_size_v<T>>{});
+        } else {
+            describe(value, [this](auto &...fields) { (get(fields), ...); });
+        }
+    }
+};
+
+} // namespace
+
+std::string serialize_statement(const Statement &statement) {
+    std::string out;
+    serialize_statement(statement, out);
+    return out;
+}
+
+void serialize_statement(const Statement &statement, std::string &out) {
+    const size_t start = out.size();
+    try {
+        out.append(magic);
+        Writer writer(out);
+        writer.put(ast_format_version);
+        writer.put(statement);
+    } catch (...) {
+        out.resize(start); // Leave no partial encoding behind
+        throw;
+    }
+}
+
+Statement deserialize_statement(const std::string_view buffer) {
+    Reader reader(buffer);
+    if (reader.get_bytes(std::min(magic.size(), buffer.size())) != magic) {
+        throw std::runtime_error("Not a serialized statement");
+    }
+    if (const uint64_t version = reader.get_varint(); version != ast_format_version) {
+        throw std::runtime_error("Unsupported statement format version " + std::to_string(version));
+    }
+    Statement statement;
+    reader.get(statement);
+    if (!reader.done()) {
+        throw std::runtime_error("Trailing bytes after serialized statement");
+    }
+    return statement;
+}
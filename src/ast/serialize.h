@@ -0,0 +1,55 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_SERIALIZE_H
+#define FLUXO_DB_SERIALIZE_H
+#pragma once
+#include "ast_statements.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Versioned binary encoding of a Statement, for plan caches and for handing parsed statements to another process.
+//
+// Layout: the magic "FXAS", the format version as a varint, then the statement. Fields are written in declaration
+// order; unsigned integers and enums are LEB128 varints, signed integers are zigzag varints, doubles are 8 bytes
+// little-endian, strings and vectors are a varint length followed by their elements, optionals a presence byte, and
+// variants the alternative index followed by the alternative. An expression is written as its ExprIr
+// (src/ir/expr_ir.h): the interned columns, then the nodes in post-order, each a kind followed by its operator, type
+// or inline value; child links are implied by the post-order. The encoding does not depend on the host, so buffers
+// can be stored and read back by another build with the same format version.
+//
+// Bump ast_format_version whenever a field is added, removed or reordered in ast_expr.h or ast_statements.h.
+constexpr uint32_t ast_format_version = 2;
+
+// Only expressions nest without bound, and they are written flat, so encoding and decoding use no stack in proportion
+// to the depth of the statement.
+std::string serialize_statement(const Statement &statement);
+// Append the encoding of `statement` to `out`
+void serialize_statement(const Statement &statement, std::string &out);
+
+// Decode a buffer produced by serialize_statement. Strings are read as views of `buffer` and copied once into the AST;
+// bulk INSERT columns are rebuilt in place. Expression nodes are allocated from the current AstArena, if any.
+// Throws std::runtime_error on a wrong magic or version, or on truncated, trailing or malformed data.
+Statement deserialize_statement(std::string_view buffer);
+
+#endif //FLUXO_DB_SERIALIZE_H
@@ -0,0 +1,166 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "symbol.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint32_t shard_bits = 4;
+constexpr uint32_t shard_count = 1u << shard_bits;
+// Chunk k of a shard holds 2^(first_chunk_bits + k) entries, so entries never move as a shard grows and the chunk
+// directory stays a few pointers long. 22 chunks cover the 28 bits of an id left after the shard bits.
+constexpr size_t first_chunk_bits = 6;
+constexpr size_t max_chunks = 22;
+constexpr size_t max_entries = (size_t{1} << first_chunk_bits) * ((size_t{1} << max_chunks) - 1);
+
+struct Location {
+    size_t chunk;
+    size_t offset;
+};
+
+Location locate(const size_t index) {
+    const size_t biased = index + (size_t{1} << first_chunk_bits);
+    const size_t chunk = std::bit_width(biased) - 1 - first_chunk_bits;
+    return {chunk, biased - (size_t{1} << (first_chunk_bits + chunk))};
+}
+
+uint64_t hash_text(const std::string_view text) {
+    uint64_t h = 0xcbf29ce484222325ull; // FNV-1a 64, finished with MurmurHash3 fmix64 so the low bits pick shards well
+    for (const char c : text) {
+        h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace
+
+struct SymbolTable::Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string_view, uint32_t> ids; // Keys view the text of their entry, which never moves
+    size_t count = 0; // Guarded by `mutex`
+    std::array<std::atomic<Entry *>, max_chunks> chunks{};
+
+    [[nodiscard]] const Entry &at(const size_t index) const {
+        const auto [chunk, offset] = locate(index);
+        return chunks[chunk].load(std::memory_order_acquire)[offset];
+    }
+};
+
+SymbolTable::SymbolTable() : shards_(new Shard[shard_count]) {
+    // Id 0 is the empty name: index 0 of shard 0, never entered in a map, so it needs no lookup
+    Shard &first = shards_[0];
+    auto *entries = new Entry[size_t{1} << first_chunk_bits];
+    entries[0].hash = hash_text({});
+    first.chunks[0].store(entries, std::memory_order_release);
+    first.count = 1;
+}
+
+SymbolTable::~SymbolTable() {
+    for (uint32_t s = 0; s < shard_count; ++s) {
+        for (auto &chunk : shards_[s].chunks) delete[] chunk.load(std::memory_order_relaxed);
+    }
+    delete[] shards_;
+}
+
+uint32_t SymbolTable::intern(const std::string_view text) {
+    if (text.empty()) {
+        return 0;
+    }
+    const uint64_t hash = hash_text(text);
+    const uint32_t shard_index = static_cast<uint32_t>(hash) & (shard_count - 1);
+    Shard &shard = shards_[shard_index];
+    {
+        const std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.ids.find(text); it != shard.ids.end()) {
+            return it->second;
+        }
+    }
+
+    const std::unique_lock lock(shard.mutex);
+    // Another thread may have added the name between the two locks
+    if (const auto it = shard.ids.find(text); it != shard.ids.end()) {
+        return it->second;
+    }
+    if (shard.count >= max_entries) {
+        throw std::length_error("Symbol table is full");
+    }
+    const size_t index = shard.count;
+    const auto [chunk, offset] = locate(index);
+    Entry *entries = shard.chunks[chunk].load(std::memory_order_relaxed);
+    if (entries == nullptr) {
+        entries = new Entry[size_t{1} << (first_chunk_bits + chunk)];
+        shard.chunks[chunk].store(entries, std::memory_order_release);
+    }
+    Entry &entry = entries[offset];
+    entry.text.assign(text);
+    entry.hash = hash;
+
+    const auto id = static_cast<uint32_t>(index << shard_bits | shard_index);
+    shard.ids.emplace(entry.text, id);
+    ++shard.count;
+    return id;
+}
+
+std::optional<uint32_t> SymbolTable::find(const std::string_view text) const {
+    if (text.empty()) {
+        return 0;
+    }
+    const Shard &shard = shards_[static_cast<uint32_t>(hash_text(text)) & (shard_count - 1)];
+    const std::shared_lock lock(shard.mutex);
+    if (const auto it = shard.ids.find(text); it != shard.ids.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+const SymbolTable::Entry &SymbolTable::entry(const uint32_t id) const {
+    return shards_[id & (shard_count - 1)].at(id >> shard_bits);
+}
+
+size_t SymbolTable::size() const {
+    size_t total = 0;
+    for (uint32_t s = 0; s < shard_count; ++s) {
+        const std::shared_lock lock(shards_[s].mutex);
+        total += shards_[s].count;
+    }
+    return total;
+}
+
+SymbolTable &SymbolTable::global() {
+    // Never destroyed, so symbols stay valid in other static destructors
+    static auto *table = new SymbolTable();
+    return *table;
+}
@@ -0,0 +1,116 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_SYMBOL_H
+#define FLUXO_DB_SYMBOL_H
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Interned identifier: a 32-bit id into the process-wide SymbolTable. Equal names always get equal ids, so
+// comparing or hashing symbols never touches their text. Symbols are created while parsing and are cheap to copy.
+// The default symbol is the empty name.
+class Symbol {
+private:
+    uint32_t id_ = 0;
+
+    struct FromId {};
+    constexpr Symbol(FromId, const uint32_t id) : id_(id) {}
+
+public:
+    constexpr Symbol() = default;
+    Symbol(std::string_view text);
+    Symbol(const char *text) : Symbol(std::string_view(text)) {}
+    Symbol(const std::string &text) : Symbol(std::string_view(text)) {}
+
+    // The symbol with a given id. The id must have come from Symbol::id() in this process.
+    static constexpr Symbol from_id(const uint32_t id) { return {FromId{}, id}; }
+
+    [[nodiscard]] constexpr uint32_t id() const { return id_; }
+    [[nodiscard]] constexpr bool empty() const { return id_ == 0; }
+    [[nodiscard]] const std::string &str() const;
+    [[nodiscard]] std::string_view view() const { return str(); }
+    // 64-bit hash of the text, computed once when the name is interned. Unlike the id it does not depend on
+    // interning order, so it is stable across processes.
+    [[nodiscard]] uint64_t text_hash() const;
+
+    friend constexpr bool operator==(Symbol, Symbol) = default;
+    friend bool operator==(const Symbol symbol, const std::string_view text) { return symbol.view() == text; }
+    friend bool operator==(const Symbol symbol, const char *text) { return symbol.view() == text; }
+    friend bool operator==(const Symbol symbol, const std::string &text) { return symbol.view() == text; }
+
+    friend std::ostream &operator<<(std::ostream &out, const Symbol symbol) { return out << symbol.view(); }
+};
+
+template <>
+struct std::hash<Symbol> {
+    size_t operator()(const Symbol symbol) const noexcept { return std::hash<uint32_t>{}(symbol.id()); }
+};
+
+// Process-wide, append-only table of interned names. Interning takes a per-shard lock (shared on a hit, exclusive
+// only to add a new name); mapping an id back to its text is lock-free. Interned names live until the process exits.
+// An id handed to another thread must be published through the usual synchronization (a queue, a mutex, a join);
+// the table itself adds none on the id-to-text path.
+class SymbolTable {
+public:
+    struct Entry {
+        std::string text;
+        uint64_t hash = 0;
+    };
+
+    // Id of `text`, adding it on first use. Throws std::length_error once the 32-bit id space is exhausted.
+    uint32_t intern(std::string_view text);
+    // Id of `text` if it has been interned, without adding it
+    [[nodiscard]] std::optional<uint32_t> find(std::string_view text) const;
+    [[nodiscard]] const Entry &entry(uint32_t id) const;
+    // Number of distinct names interned so far, including the empty name
+    [[nodiscard]] size_t size() const;
+
+    static SymbolTable &global();
+
+    SymbolTable();
+    ~SymbolTable();
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+private:
+    struct Shard;
+    Shard *shards_;
+};
+
+inline Symbol::Symbol(const std::string_view text) : id_(SymbolTable::global().intern(text)) {
+}
+
+inline const std::string &Symbol::str() const {
+    return SymbolTable::global().entry(id_).text;
+}
+
+inline uint64_t Symbol::text_hash() const {
+    return SymbolTable::global().entry(id_).hash;
+}
+
+#endif //FLUXO_DB_SYMBOL_H
@@ -0,0 +1,637 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "catalog.h"
+#include "epoch.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+[[noreturn]] void conflict(const std::string &message) {
+    throw std::runtime_error(message);
+}
+
+[[noreturn]] void unsupported(const std::string &message) {
+    throw std::invalid_argument(message);
+}
+
+std::string quoted(const Symbol name) {
+    return "\"" + name.str() + "\"";
+}
+
+// The version being built by one DDL statement. Entries are shared with the current version until they are first
+// written; own() swaps the shared entry for a private copy, once per entry and statement.
+class CatalogEdit {
+private:
+    CatalogSnapshot &next_;
+    std::unordered_set<const void *> owned_;
+
+public:
+    explicit CatalogEdit(CatalogSnapshot &next) : next_(next) {}
+
+    [[nodiscard]] const CatalogSnapshot &snapshot() const { return next_; }
+    uint64_t new_object_id() { return next_.next_object_id++; }
+
+    template <typename T>
+    T &own(std::shared_ptr<const T> &slot) {
+        if (!owned_.contains(slot.get())) {
+            auto copy = std::make_shared<T>(*slot);
+            owned_.insert(copy.get());
+            slot = std::move(copy);
+        }
+        return const_cast<T &>(*slot); // Created non-const by this edit
+    }
+
+    template <typename T>
+    std::shared_ptr<const T> adopt(T &&entry) {
+        auto created = std::make_shared<T>(std::move(entry));
+        owned_.insert(created.get());
+        return created;
+    }
+
+    std::unordered_map<Symbol, std::shared_ptr<const DatabaseEntry>> &databases() { return next_.databases; }
+
+    DatabaseEntry &database(const Symbol name) {
+        const auto it = next_.databases.find(name);
+        if (it == next_.databases.end()) {
+            conflict("Database " + quoted(name) + " does not exist");
+        }
+        return own(it->second);
+    }
+
+    SchemaEntry &schema(const SearchPath &path) {
+        DatabaseEntry &database = this->database(path.database);
+        const auto it = database.schemas.find(path.schema);
+        if (it == database.schemas.end()) {
+            conflict("Schema " + quoted(path.schema) + " does not exist");
+        }
+        return own(it->second);
+    }
+};
+
+SchemaEntry empty_schema(const Symbol name, std::optional<std::string> owner = std::nullopt) {
+    SchemaEntry schema;
+    schema.name = name;
+    schema.owner = std::move(owner);
+    return schema;
+}
+
+bool name_taken(const SchemaEntry &schema, const Symbol name) {
+    return schema.tables.contains(name) || schema.indexes.contains(name);
+}
+
+ColumnDef *find_column(TableEntry &table, const Symbol name) {
+    const auto it = std::ranges::find(table.columns, name, &ColumnDef::name);
+    return it == table.columns.end() ? nullptr : &*it;
+}
+
+ColumnDef &require_column(TableEntry &table, const Symbol name) {
+    ColumnDef *column = find_column(table, name);
+    if (column == nullptr) {
+        conflict("Column " + quoted(name) + " of table " + quoted(table.name) + " does not exist");
+    }
+    return *column;
+}
+
+// Index entries of `table`, each made private to the edit
+std::vector<IndexEntry *> own_indexes_of(CatalogEdit &edit, SchemaEntry &schema, const Symbol table) {
+    std::vector<IndexEntry *> indexes;
+    for (auto &[name, index] : schema.indexes) {
+        if (index->table == table) {
+            indexes.push_back(&edit.own(index));
+        }
+    }
+    return indexes;
+}
+
+bool create_table(CatalogEdit &edit, const SearchPath &path, const CreateTableStmt &stmt) {
+    SchemaEntry &schema = edit.schema(path);
+    if (name_taken(schema, stmt.table_name)) {
+        if (stmt.if_not_exists && schema.tables.contains(stmt.table_name)) {
+            return false;
+        }
+        conflict("Relation " + quoted(stmt.table_name) + " already exists");
+    }
+
+    TableEntry table;
+    table.name = stmt.table_name;
+    table.tablespace = stmt.tablespace;
+    for (const ColumnDef &column : stmt.columns) {
+        if (find_column(table, column.name) != nullptr) {
+            conflict("Column " + quoted(column.name) + " specified more than once");
+        }
+        table.columns.push_back(column);
+    }
+    for (const TableConstraint &constraint : stmt.constraints) {
+        for (const Symbol column : constraint.columns) {
+            require_column(table, column);
+        }
+        table.constraints.push_back(ConstraintEntry{constraint.type, constraint.name, constraint.columns,
+                                                    constraint.foreign_table, constraint.foreign_columns});
+    }
+    table.id = edit.new_object_id();
+    schema.tables.emplace(table.name, edit.adopt(std::move(table)));
+    return true;
+}
+
+bool create_index(CatalogEdit &edit, const SearchPath &path, const CreateIndexStmt &stmt) {
+    SchemaEntry &schema = edit.schema(path);
+    const auto table = schema.tables.find(stmt.table_name);
+    if (table == schema.tables.end()) {
+        conflict("Table " + quoted(stmt.table_name) + " does not exist");
+    }
+
+    IndexEntry index;
+    index.name = stmt.index_name;
+    index.table = stmt.table_name;
+    index.unique = stmt.unique;
+    index.partial = stmt.where.has_value();
+    index.method = stmt.method;
+    for (const IndexElem &elem : stmt.params) {
+        IndexColumn &column = index.columns.emplace_back();
+        column.ordering = elem.ordering;
+        column.nulls_first = elem.nulls_first;
+        if (elem.name) {
+            if (table->second->column(*elem.name) == nullptr) {
+                conflict("Column " + quoted(*elem.name) + " of table " + quoted(stmt.table_name) + " does not exist");
+            }
+            column.column = *elem.name;
+        }
+    }
+
+    if (name_taken(schema, index.name)) {
+        if (stmt.if_not_exists && schema.indexes.contains(index.name)) {
+            return false;
+        }
+        conflict("Relation " + quoted(index.name) + " already exists");
+    }
+    index.id = edit.new_object_id();
+    schema.indexes.emplace(index.name, edit.adopt(std::move(index)));
+    return true;
+}
+
+bool create_database(CatalogEdit &edit, const CreateDatabaseStmt &stmt) {
+    const Symbol name(stmt.name);
+    if (edit.databases().contains(name)) {
+        if (stmt.if_not_exists) {
+            return false;
+        }
+        conflict("Database " + quoted(name) + " already exists");
+    }
+    DatabaseEntry database;
+    database.name = name;
+    database.owner = stmt.user_name;
+    database.encoding = stmt.encoding;
+    database.tablespace = stmt.tablespace_name;
+    database.allow_connections = stmt.allow_conn;
+    database.connection_limit = stmt.conn_limit;
+    database.schemas.emplace(Symbol(default_schema), edit.adopt(empty_schema(Symbol(default_schema))));
+    edit.databases().emplace(name, edit.adopt(std::move(database)));
+    return true;
+}
+
+bool create_schema(CatalogEdit &edit, const SearchPath &path, const CreateSchemaStmt &stmt) {
+    DatabaseEntry &database = edit.database(path.database);
+    if (database.schemas.contains(stmt.schema_name)) {
+        if (stmt.if_not_exists) {
+            return false;
+        }
+        conflict("Schema " + quoted(stmt.schema_name) + " already exists");
+    }
+    database.schemas.emplace(stmt.schema_name, edit.adopt(empty_schema(stmt.schema_name, stmt.authorization)));
+
+    if (stmt.schema_elements) {
+        const SearchPath inside{path.database, stmt.schema_name};
+        for (const SchemaElement &element : *stmt.schema_elements) {
+            if (const auto *table = std::get_if<CreateTableStmt>(&element)) {
+                create_table(edit, inside, *table);
+            } else if (const auto *index = std::get_if<CreateIndexStmt>(&element)) {
+                create_index(edit, inside, *index);
+            } else {
+                unsupported("CREATE SCHEMA: only tables and indexes are kept in the catalog");
+            }
+        }
+    }
+    return true;
+}
+
+// Foreign keys of other tables in `schema` that point at `table`
+bool referenced_elsewhere(const SchemaEntry &schema, const Symbol table) {
+    for (const auto &[name, other] : schema.tables) {
+        if (name == table) {
+            continue;
+        }
+        for (const ConstraintEntry &constraint : other->constraints) {
+            if (constraint.foreign_table == table) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void drop_foreign_keys_to(CatalogEdit &edit, SchemaEntry &schema, const Symbol table) {
+    for (auto &[name, other] : schema.tables) {
+        if (name == table) {
+            continue;
+        }
+        const auto points_here = [table](const ConstraintEntry &constraint) {
+            return constraint.foreign_table == table;
+        };
+        if (std::ranges::any_of(other->constraints, points_here)) {
+            std::erase_if(edit.own(other).constraints, points_here);
+        }
+    }
+}
+
+void drop_table(CatalogEdit &edit, SchemaEntry &schema, const Symbol name, const bool cascade) {
+    if (referenced_elsewhere(schema, name)) {
+        if (!cascade) {
+            conflict("Table " + quoted(name) + " is referenced by a foreign key; use CASCADE");
+        }
+        drop_foreign_keys_to(edit, schema, name);
+    }
+    std::erase_if(schema.indexes, [name](const auto &entry) { return entry.second->table == name; });
+    schema.tables.erase(name);
+}
+
+bool drop(CatalogEdit &edit, const SearchPath &path, const DropStmt &stmt) {
+    bool changed = false;
+    for (const Symbol name : stmt.names) {
+        bool exists = false;
+        switch (stmt.object_type) {
+            case ObjectType::TABLE: {
+                SchemaEntry &schema = edit.schema(path);
+                if ((exists = schema.tables.contains(name))) {
+                    drop_table(edit, schema, name, stmt.cascade);
+                }
+                break;
+            }
+            case ObjectType::INDEX: {
+                SchemaEntry &schema = edit.schema(path);
+                exists = schema.indexes.erase(name) > 0;
+                break;
+            }
+            case ObjectType::SCHEMA: {
+                DatabaseEntry &database = edit.database(path.database);
+                if (const auto it = database.schemas.find(name); it != database.schemas.end()) {
+                    exists = true;
+                    if (!stmt.cascade && (!it->second->tables.empty() || !it->second->indexes.empty())) {
+                        conflict("Schema " + quoted(name) + " is not empty; use CASCADE");
+                    }
+                    database.schemas.erase(it);
+                }
+                break;
+            }
+            case ObjectType::DATABASE:
+                exists = edit.databases().erase(name) > 0;
+                break;
+            default:
+                unsupported("DROP: only databases, schemas, tables and indexes are kept in the catalog");
+        }
+        if (!exists && !stmt.if_exists) {
+            conflict("Object " + quoted(name) + " does not exist");
+        }
+        changed = changed || exists;
+    }
+    return changed;
+}
+
+// Applies ALTER TABLE actions in order to one table, which may change name and schema along the way
+class TableAlteration {
+private:
+    CatalogEdit &edit_;
+    SearchPath path_;
+    Symbol name_;
+
+    SchemaEntry &schema() { return edit_.schema(path_); }
+    TableEntry &table() { return edit_.own(schema().tables.at(name_)); }
+
+public:
+    TableAlteration(CatalogEdit &edit, const SearchPath &path, const Symbol name)
+        : edit_(edit), path_(path), name_(name) {}
+
+    void operator()(const AddAction &action) {
+        if (const auto *add = std::get_if<AddColumnAction>(&action)) {
+            TableEntry &table = this->table();
+            if (find_column(table, add->column_def.name) != nullptr) {
+                if (add->if_not_exists) {
+                    return;
+                }
+                conflict("Column " + quoted(add->column_def.name) + " of table " + quoted(name_) + " already exists");
+            }
+            table.columns.push_back(add->column_def);
+        } else {
+            const auto &constraint = std::get<AddConstraintAction>(action);
+            ColumnDef &column = require_column(table(), constraint.column_name);
+            column.not_null = column.not_null || constraint.not_null || constraint.primary_key;
+            column.unique = column.unique || constraint.unique;
+            column.primary_key = column.primary_key || constraint.primary_key;
+        }
+    }
+
+    void operator()(const DropAction &action) {
+        if (const auto *drop = std::get_if<DropColumnAction>(&action)) {
+            TableEntry &table = this->table();
+            if (find_column(table, drop->column_name) == nullptr) {
+                if (drop->if_exists) {
+                    return;
+                }
+                require_column(table, drop->column_name);
+            }
+            const Symbol column = drop->column_name;
+            const auto uses_column = [column](const ConstraintEntry &constraint) {
+                return std::ranges::find(constraint.columns, column) != constraint.columns.end();
+            };
+            const auto index_uses_column = [this, column](const auto &entry) {
+                const std::vector<IndexColumn> &keys = entry.second->columns;
+                return entry.second->table == name_ &&
+                       std::ranges::find(keys, column, &IndexColumn::column) != keys.end();
+            };
+            SchemaEntry &schema = this->schema();
+            if (std::ranges::any_of(table.constraints, uses_column) ||
+                std::ranges::any_of(schema.indexes, index_uses_column)) {
+                if (!drop->cascade) {
+                    conflict("Column " + quoted(column) + " is used by a constraint or index; use CASCADE");
+                }
+                std::erase_if(table.constraints, uses_column);
+                std::erase_if(schema.indexes, index_uses_column);
+            }
+            std::erase_if(table.columns, [column](const ColumnDef &def) { return def.name == column; });
+        } else {
+            const auto &constraint = std::get<DropConstraintAction>(action);
+            const size_t erased = std::erase_if(table().constraints, [&constraint](const ConstraintEntry &entry) {
+                return entry.name == constraint.constraint_name;
+            });
+            if (erased == 0 && !constraint.if_exists) {
+                conflict("Constraint " + quoted(constraint.constraint_name) + " of table " + quoted(name_) +
+                         " does not exist");
+            }
+        }
+    }
+
+    void operator()(const AlterColumnAction &action) {
+        if (const auto *type = std::get_if<AlterColumnTypeAction>(&action)) {
+            require_column(table(), type->column_name).type = type->new_type;
+        } else if (const auto *not_null = std::get_if<AlterColumnNotNullAction>(&action)) {
+            ColumnDef &column = require_column(table(), not_null->column_name);
+            if (!not_null->set_not_null && column.primary_key) {
+                conflict("Column " + quoted(column.name) + " is in a primary key");
+            }
+            column.not_null = not_null->set_not_null;
+        } else {
+            unsupported("ALTER COLUMN: column defaults are not kept in the catalog");
+        }
+    }
+
+    void operator()(const RenameAction &action) {
+        if (const auto *column = std::get_if<RenameColumnAction>(&action)) {
+            TableEntry &table = this->table();
+            if (find_column(table, column->new_name) != nullptr) {
+                conflict("Column " + quoted(column->new_name) + " of table " + quoted(name_) + " already exists");
+            }
+            require_column(table, column->old_name).name = column->new_name;
+            for (ConstraintEntry &constraint : table.constraints) {
+                std::ranges::replace(constraint.columns, column->old_name, column->new_name);
+            }
+            for (IndexEntry *index : own_indexes_of(edit_, schema(), name_)) {
+                for (IndexColumn &key : index->columns) {
+                    key.column = key.column == column->old_name ? column->new_name : key.column;
+                }
+            }
+        } else if (const auto *rename = std::get_if<RenameTableAction>(&action)) {
+            SchemaEntry &schema = this->schema();
+            if (name_taken(schema, rename->new_name)) {
+                conflict("Relation " + quoted(rename->new_name) + " already exists");
+            }
+            for (IndexEntry *index : own_indexes_of(edit_, schema, name_)) {
+                index->table = rename->new_name;
+            }
+            for (auto &[name, other] : schema.tables) {
+                for (const ConstraintEntry &constraint : other->constraints) {
+                    if (constraint.foreign_table == name_) {
+                        for (ConstraintEntry &owned : edit_.own(other).constraints) {
+                            owned.foreign_table = owned.foreign_table == name_ ? rename->new_name : owned.foreign_table;
+                        }
+                        break;
+                    }
+                }
+            }
+            auto node = schema.tables.extract(name_);
+            node.key() = rename->new_name;
+            schema.tables.insert(std::move(node));
+            name_ = rename->new_name;
+            table().name = name_;
+        } else {
+            const auto &constraint = std::get<RenameConstraintAction>(action);
+            TableEntry &table = this->table();
+            const auto it = std::ranges::find(table.constraints, constraint.old_name, &ConstraintEntry::name);
+            if (it == table.constraints.end()) {
+                conflict("Constraint " + quoted(constraint.old_name) + " of table " + quoted(name_) +
+                         " does not exist");
+            }
+            it->name = constraint.new_name;
+        }
+    }
+
+    void operator()(const SetSchemaAction &action) {
+        const SearchPath target{path_.database, action.schema_name};
+        if (target.schema == path_.schema) {
+            return;
+        }
+        SchemaEntry &from = schema();
+        SchemaEntry &to = edit_.schema(target);
+        if (name_taken(to, name_)) {
+            conflict("Relation " + quoted(name_) + " already exists in schema " + quoted(target.schema));
+        }
+        for (auto it = from.indexes.begin(); it != from.indexes.end();) {
+            if (it->second->table == name_) {
+                if (name_taken(to, it->first)) {
+                    conflict("Relation " + quoted(it->first) + " already exists in schema " + quoted(target.schema));
+                }
+                to.indexes.insert(from.indexes.extract(it++));
+            } else {
+                ++it;
+            }
+        }
+        to.tables.insert(from.tables.extract(name_));
+        path_ = target;
+    }
+
+    void operator()(const OwnerToAction &action) {
+        table().owner = action.new_owner;
+    }
+};
+
+bool alter_table(CatalogEdit &edit, const SearchPath &path, const AlterTableStmt &stmt) {
+    if (!edit.schema(path).tables.contains(stmt.table_name)) {
+        if (stmt.if_exists) {
+            return false;
+        }
+        conflict("Table " + quoted(stmt.table_name) + " does not exist");
+    }
+    TableAlteration alteration(edit, path, stmt.table_name);
+    for (const AlterAction &action : stmt.actions) {
+        std::visit(alteration, action);
+    }
+    return true;
+}
+
+bool apply_create(CatalogEdit &edit, const SearchPath &path, const CreateStmt &stmt) {
+    if (const auto *table = std::get_if<CreateTableStmt>(&stmt)) return create_table(edit, path, *table);
+    if (const auto *index = std::get_if<CreateIndexStmt>(&stmt)) return create_index(edit, path, *index);
+    if (const auto *schema = std::get_if<CreateSchemaStmt>(&stmt)) return create_schema(edit, path, *schema);
+    if (const auto *database = std::get_if<CreateDatabaseStmt>(&stmt)) return create_database(edit, *database);
+    unsupported("CREATE: only databases, schemas, tables and indexes are kept in the catalog");
+}
+
+} // namespace
+
+const ColumnDef *TableEntry::column(const Symbol name) const {
+    const auto it = std::ranges::find(columns, name, &ColumnDef::name);
+    return it == columns.end() ? nullptr : &*it;
+}
+
+const DatabaseEntry *CatalogSnapshot::database(const Symbol name) const {
+    const auto it = databases.find(name);
+    return it == databases.end() ? nullptr : it->second.get();
+}
+
+const SchemaEntry *CatalogSnapshot::schema(const SearchPath &path) const {
+    const DatabaseEntry *database = this->database(path.database);
+    if (database == nullptr) {
+        return nullptr;
+    }
+    const auto it = database->schemas.find(path.schema);
+    return it == database->schemas.end() ? nullptr : it->second.get();
+}
+
+const TableEntry *CatalogSnapshot::table(const SearchPath &path, const Symbol name) const {
+    const SchemaEntry *schema = this->schema(path);
+    if (schema == nullptr) {
+        return nullptr;
+    }
+    const auto it = schema->tables.find(name);
+    return it == schema->tables.end() ? nullptr : it->second.get();
+}
+
+const IndexEntry *CatalogSnapshot::index(const SearchPath &path, const Symbol name) const {
+    const SchemaEntry *schema = this->schema(path);
+    if (schema == nullptr) {
+        return nullptr;
+    }
+    const auto it = schema->indexes.find(name);
+    return it == schema->indexes.end() ? nullptr : it->second.get();
+}
+
+std::vector<const IndexEntry *> CatalogSnapshot::indexes_of(const SearchPath &path, const Symbol table) const {
+    std::vector<const IndexEntry *> indexes;
+    if (const SchemaEntry *schema = this->schema(path)) {
+        for (const auto &[name, index] : schema->indexes) {
+            if (index->table == table) {
+                indexes.push_back(index.get());
+            }
+        }
+    }
+    return indexes;
+}
+
+CatalogView::~CatalogView() {
+    if (snapshot_ != nullptr) {
+        unpin_epoch();
+    }
+}
+
+Catalog::Catalog() {
+    auto initial = std::make_unique<CatalogSnapshot>();
+    initial->version = 1;
+    CatalogEdit edit(*initial);
+    CreateDatabaseStmt database;
+    database.name = default_database;
+    create_database(edit, database);
+    current_.store(initial.release());
+}
+
+Catalog::~Catalog() {
+    for (const Retired &retired : retired_) {
+        delete retired.snapshot;
+    }
+    delete current_.load();
+}
+
+CatalogView Catalog::view() const {
+    pin_epoch();
+    return CatalogView(current_.load());
+}
+
+uint64_t Catalog::version() const {
+    const CatalogView view = this->view();
+    return view->version;
+}
+
+uint64_t Catalog::apply(const Statement &statement, const SearchPath &path) {
+    const std::lock_guard lock(writer_);
+    // Only writers retire versions, so the current one cannot be freed while the lock is held
+    const CatalogSnapshot *current = current_.load(std::memory_order_acquire);
+    auto next = std::make_unique<CatalogSnapshot>(*current);
+    CatalogEdit edit(*next);
+
+    bool changed;
+    if (const auto *create = std::get_if<CreateStmt>(&statement)) {
+        changed = apply_create(edit, path, *create);
+    } else if (const auto *drop = std::get_if<DropStmt>(&statement)) {
+        changed = ::drop(edit, path, *drop);
+    } else if (const auto *alter = std::get_if<AlterTableStmt>(&statement)) {
+        changed = alter_table(edit, path, *alter);
+    } else {
+        unsupported("Not a DDL statement");
+    }
+    if (!changed) {
+        return current->version;
+    }
+
+    next->version = current->version + 1;
+    const uint64_t version = next->version;
+    const CatalogSnapshot *replaced = current_.exchange(next.release());
+    retired_.push_back(Retired{advance_epoch(), replaced});
+    reclaim();
+    return version;
+}
+
+void Catalog::reclaim() {
+    const uint64_t oldest = oldest_pinned_epoch();
+    std::erase_if(retired_, [oldest](const Retired &retired) {
+        if (retired.epoch < oldest) {
+            delete retired.snapshot;
+            return true;
+        }
+        return false;
+    });
+}
+
+size_t Catalog::retired_versions() const {
+    const std::lock_guard lock(writer_);
+    return retired_.size();
+}
@@ -0,0 +1,183 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_CATALOG_H
+#define FLUXO_DB_CATALOG_H
+#pragma once
+#include "../ast/ast_statements.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Database and schema every catalog starts with
+inline constexpr std::string_view default_database = "fluxo";
+inline constexpr std::string_view default_schema = "public";
+
+// Where unqualified table and index names resolve
+struct SearchPath {
+    Symbol database{default_database};
+    Symbol schema{default_schema};
+};
+
+// Table constraint as the catalog keeps it; CHECK expressions are not kept
+struct ConstraintEntry {
+    TableConstraint::Type type;
+    Symbol name;
+    std::vector<Symbol> columns;
+    std::optional<Symbol> foreign_table;
+    std::vector<Symbol> foreign_columns;
+};
+
+struct TableEntry {
+    uint64_t id = 0;
+    Symbol name;
+    std::vector<ColumnDef> columns;
+    std::vector<ConstraintEntry> constraints;
+    std::optional<std::string> owner;
+    std::optional<std::string> tablespace;
+
+    [[nodiscard]] const ColumnDef *column(Symbol name) const;
+};
+
+struct IndexColumn {
+    Symbol column; // Empty for an expression element
+    OrderDirection ordering = OrderDirection::ASC;
+    std::optional<bool> nulls_first;
+};
+
+struct IndexEntry {
+    uint64_t id = 0;
+    Symbol name;
+    Symbol table;
+    bool unique = false;
+    bool partial = false; // Has a WHERE clause
+    std::optional<std::string> method;
+    std::vector<IndexColumn> columns;
+};
+
+struct SchemaEntry {
+    Symbol name;
+    std::optional<std::string> owner;
+    std::unordered_map<Symbol, std::shared_ptr<const TableEntry>> tables;
+    std::unordered_map<Symbol, std::shared_ptr<const IndexEntry>> indexes;
+};
+
+struct DatabaseEntry {
+    Symbol name;
+    std::string owner;
+    std::string encoding;
+    std::string tablespace;
+    bool allow_connections = true;
+    int64_t connection_limit = -1;
+    std::unordered_map<Symbol, std::shared_ptr<const SchemaEntry>> schemas;
+};
+
+// One immutable version of the catalog. Versions share every entry a DDL statement did not touch, so publishing a
+// version copies only the path from the root to what changed.
+struct CatalogSnapshot {
+    uint64_t version = 0;
+    uint64_t next_object_id = 1;
+    std::unordered_map<Symbol, std::shared_ptr<const DatabaseEntry>> databases;
+
+    // Lookups return nullptr when the object does not exist
+    [[nodiscard]] const DatabaseEntry *database(Symbol name) const;
+    [[nodiscard]] const SchemaEntry *schema(const SearchPath &path) const;
+    [[nodiscard]] const TableEntry *table(const SearchPath &path, Symbol name) const;
+    [[nodiscard]] const IndexEntry *index(const SearchPath &path, Symbol name) const;
+    // Indexes on `table`, in no particular order
+    [[nodiscard]] std::vector<const IndexEntry *> indexes_of(const SearchPath &path, Symbol table) const;
+};
+
+// A pinned catalog version. Everything reached through it stays valid, and unchanged, until the view is destroyed,
+// however many DDL statements run meanwhile. A view belongs to the thread that took it.
+class CatalogView {
+private:
+    const CatalogSnapshot *snapshot_ = nullptr;
+
+    friend class Catalog;
+    explicit CatalogView(const CatalogSnapshot *snapshot) : snapshot_(snapshot) {}
+
+public:
+    CatalogView(CatalogView &&other) noexcept : snapshot_(std::exchange(other.snapshot_, nullptr)) {}
+    CatalogView(const CatalogView&) = delete;
+    CatalogView& operator=(const CatalogView&) = delete;
+    CatalogView& operator=(CatalogView &&other) noexcept {
+        std::swap(snapshot_, other.snapshot_); // `other` releases the version this view held
+        return *this;
+    }
+    ~CatalogView();
+
+    const CatalogSnapshot &operator*() const { return *snapshot_; }
+    const CatalogSnapshot *operator->() const { return snapshot_; }
+};
+
+// System catalog of databases, schemas, tables and indexes, built for a workload of constant lookups and rare DDL.
+//
+// Readers never lock: view() pins the reclamation epoch (see epoch.h) and loads the current version with a single
+// atomic load. DDL statements run one at a time; each builds the next version next to the current one and
+// publishes it with one pointer swap, so readers see a statement entirely or not at all, including a CREATE SCHEMA
+// that creates several objects. Replaced versions are freed once no view can still reach them.
+//
+// A catalog starts at version 1 with database `fluxo` holding schema `public`; new databases start with a `public`
+// schema too. The catalog must outlive every view taken from it.
+class Catalog {
+private:
+    struct Retired {
+        uint64_t epoch;
+        const CatalogSnapshot *snapshot;
+    };
+
+    std::atomic<const CatalogSnapshot *> current_;
+    mutable std::mutex writer_; // Serializes DDL and guards retired_
+    std::vector<Retired> retired_;
+
+    void reclaim();
+
+public:
+    Catalog();
+    ~Catalog();
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    [[nodiscard]] CatalogView view() const;
+    [[nodiscard]] uint64_t version() const;
+
+    // Execute one DDL statement: CREATE DATABASE, SCHEMA, TABLE or INDEX, DROP of any of those, or ALTER TABLE, with
+    // unqualified names resolved in `path`. Returns the version the statement published, or the current version
+    // when it changed nothing (IF [NOT] EXISTS). Throws std::runtime_error when the statement conflicts with the
+    // catalog and std::invalid_argument for a statement the catalog does not keep (SELECT, CREATE VIEW, column
+    // defaults, ...); either way nothing is published.
+    uint64_t apply(const Statement &statement, const SearchPath &path = {});
+
+    // Replaced versions still waiting for their last reader
+    [[nodiscard]] size_t retired_versions() const;
+};
+
+#endif //FLUXO_DB_CATALOG_H
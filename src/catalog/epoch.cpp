@@ -0,0 +1,99 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "epoch.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+std::atomic<uint64_t> global_epoch{0};
+
+// One per thread that has ever pinned. Slots are never freed: a thread gives its slot back when it exits and the
+// next new reader thread takes it over, so the list is as long as the most threads ever reading at once.
+struct alignas(64) ReaderSlot {
+    std::atomic<uint64_t> epoch{unpinned_epoch};
+    std::atomic<bool> claimed{true};
+    ReaderSlot *next = nullptr;
+};
+
+std::atomic<ReaderSlot *> slots{nullptr};
+
+ReaderSlot *claim_slot() {
+    for (ReaderSlot *slot = slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        bool expected = false;
+        if (!slot->claimed.load(std::memory_order_relaxed) &&
+            slot->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+    auto *slot = new ReaderSlot;
+    slot->next = slots.load(std::memory_order_relaxed);
+    while (!slots.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return slot;
+}
+
+struct ThreadSlot {
+    ReaderSlot *slot = claim_slot();
+    uint32_t depth = 0;
+
+    ~ThreadSlot() {
+        slot->epoch.store(unpinned_epoch, std::memory_order_release);
+        slot->claimed.store(false, std::memory_order_release);
+    }
+};
+
+ThreadSlot &thread_slot() {
+    thread_local ThreadSlot slot;
+    return slot;
+}
+
+} // namespace
+
+void pin_epoch() {
+    ThreadSlot &local = thread_slot();
+    if (local.depth++ == 0) {
+        // Sequentially consistent, so the pin is visible to writers before the caller loads anything it protects
+        local.slot->epoch.store(global_epoch.load());
+    }
+}
+
+void unpin_epoch() {
+    ThreadSlot &local = thread_slot();
+    if (--local.depth == 0) {
+        local.slot->epoch.store(unpinned_epoch, std::memory_order_release);
+    }
+}
+
+uint64_t advance_epoch() {
+    return global_epoch.fetch_add(1);
+}
+
+uint64_t oldest_pinned_epoch() {
+    uint64_t oldest = unpinned_epoch;
+    for (const ReaderSlot *slot = slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        oldest = std::min(oldest, slot->epoch.load());
+    }
+    return oldest;
+}
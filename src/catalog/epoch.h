@@ -0,0 +1,59 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_EPOCH_H
+#define FLUXO_DB_EPOCH_H
+#pragma once
+#include <cstdint>
+#include <limits>
+
+// Epoch-based reclamation for structures that are read far more often than they change.
+//
+// A reader pins the current epoch before it loads a shared pointer and unpins when it is done with what it loaded;
+// pinning is two atomic stores to a slot owned by the calling thread, so readers never wait for anyone. A writer that
+// swaps a pointer out calls advance_epoch() and tags the old object with the epoch it returns; the object may be
+// freed once oldest_pinned_epoch() is greater than that tag, since every reader that could still see it pinned an
+// epoch no later than the tag.
+//
+// Pins nest per thread, and a pin must be released on the thread that took it.
+
+inline constexpr uint64_t unpinned_epoch = std::numeric_limits<uint64_t>::max();
+
+void pin_epoch();
+void unpin_epoch();
+
+// Move to the next epoch; returns the epoch that was current before
+uint64_t advance_epoch();
+
+// Smallest epoch pinned by any thread, or unpinned_epoch when no thread holds a pin
+uint64_t oldest_pinned_epoch();
+
+// Pins the epoch for its lifetime
+class EpochGuard {
+public:
+    EpochGuard() { pin_epoch(); }
+    ~EpochGuard() { unpin_epoch(); }
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+#endif //FLUXO_DB_EPOCH_H
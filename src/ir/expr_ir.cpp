@@ -0,0 +1,365 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "expr_ir.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+template <typename T>
+uint32_t append(std::vector<T> &pool, T value) {
+    if (pool.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Expression IR exceeds 32-bit index space");
+    }
+    pool.push_back(std::move(value));
+    return static_cast<uint32_t>(pool.size() - 1);
+}
+
+// (qualifier id + 1) << 32 | name id, with a qualifier of 0 when the column is unqualified
+uint64_t column_key(const ColumnRef &column) {
+    const uint64_t qualifier = column.table_name ? uint64_t{column.table_name->id()} + 1 : 0;
+    return qualifier << 32 | column.name.id();
+}
+
+size_t column_slot(const uint64_t key, const size_t mask) {
+    return static_cast<size_t>((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+}
+
+} // namespace
+
+uint32_t ExprIr::push(const IrNode &node) {
+    return append(nodes, node);
+}
+
+void ExprIr::grow_column_slots() {
+    column_slots_.assign(std::max<size_t>(16, column_slots_.size() * 2), 0);
+    const size_t mask = column_slots_.size() - 1;
+    for (uint32_t id = 0; id < columns.size(); ++id) {
+        size_t slot = column_slot(column_key(columns[id]), mask);
+        while (column_slots_[slot] != 0) slot = (slot + 1) & mask;
+        column_slots_[slot] = id + 1;
+    }
+}
+
+uint32_t ExprIr::intern_column(const ColumnRef &column) {
+    // Keep the table at most half full, so probe runs stay short
+    if ((columns.size() + 1) * 2 > column_slots_.size()) {
+        grow_column_slots();
+    }
+    const uint64_t key = column_key(column);
+    const size_t mask = column_slots_.size() - 1;
+    for (size_t slot = column_slot(key, mask);; slot = (slot + 1) & mask) {
+        const uint32_t entry = column_slots_[slot];
+        if (entry == 0) {
+            const uint32_t id = append(columns, column);
+            column_slots_[slot] = id + 1;
+            return id;
+        }
+        if (column_key(columns[entry - 1]) == key) {
+            return entry - 1;
+        }
+    }
+}
+
+uint32_t ExprIr::add_string(const std::string_view text) {
+    if (text.size() > std::numeric_limits<uint32_t>::max() - string_data.size()) {
+        throw std::runtime_error("Expression IR exceeds 32-bit index space");
+    }
+    string_data.append(text);
+    append(string_offsets, static_cast<uint32_t>(string_data.size()));
+    return static_cast<uint32_t>(string_offsets.size() - 2);
+}
+
+std::string_view ExprIr::string(const uint32_t index) const {
+    return std::string_view(string_data).substr(string_offsets[index], string_offsets[index + 1] - string_offsets[index]);
+}
+
+IrNode ExprIr::make_leaf(const Expr &expr) {
+    IrNode node;
+    if (const auto *column = std::get_if<ColumnRef>(&expr)) {
+        node.kind = IrKind::COLUMN;
+        node.a = intern_column(*column);
+    } else if (const auto *literal = std::get_if<LiteralValue>(&expr)) {
+        node.type = literal->type;
+        if (const auto *integer = std::get_if<int64_t>(&literal->value)) {
+            node.kind = IrKind::INTEGER;
+            node.a = append(integers, *integer);
+        } else if (const auto *real = std::get_if<double>(&literal->value)) {
+            node.kind = IrKind::DOUBLE;
+            node.a = append(doubles, *real);
+        } else if (const auto *boolean = std::get_if<bool>(&literal->value)) {
+            node.kind = IrKind::BOOLEAN;
+            node.a = *boolean ? 1 : 0;
+        } else if (const auto *text = std::get_if<std::string>(&literal->value)) {
+            node.kind = IrKind::TEXT;
+            node.a = add_string(*text);
+        } else {
+            node.op = 1; // NULL literal, as opposed to an empty expression
+        }
+    } else if (const auto *parameter = std::get_if<ParameterRef>(&expr)) {
+        node.kind = IrKind::PARAMETER;
+        node.a = parameter->index;
+    }
+    return node;
+}
+
+uint32_t ExprIr::lower(const Expr &expr) {
+    // Post-order over an explicit stack: a node is pushed once to schedule its children and once more, below them, to
+    // be emitted after them. Emitted roots wait on lowered_ until their parent takes them.
+    lower_steps_.clear();
+    lowered_.clear();
+    lower_steps_.push_back({&expr, false});
+    while (!lower_steps_.empty()) {
+        const LowerStep step = lower_steps_.back();
+        lower_steps_.pop_back();
+        if (step.expr == nullptr) {
+            lowered_.push_back(push(IrNode{IrKind::NULL_VALUE, 2}));
+            continue;
+        }
+        const Expr &node_expr = *step.expr;
+        if (!step.children_done) {
+            if (const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(&node_expr)) {
+                lower_steps_.push_back({step.expr, true});
+                lower_steps_.push_back({&(*binary)->right, false});
+                lower_steps_.push_back({&(*binary)->left, false});
+                continue;
+            }
+            if (const auto *unary = std::get_if<std::unique_ptr<UnaryOp>>(&node_expr)) {
+                lower_steps_.push_back({step.expr, true});
+                lower_steps_.push_back({(*unary)->operand.get(), false});
+                continue;
+            }
+            if (const auto *call = std::get_if<std::unique_ptr<FunctionCall>>(&node_expr)) {
+                lower_steps_.push_back({step.expr, true});
+                for (auto arg = (*call)->args.rbegin(); arg != (*call)->args.rend(); ++arg) {
+                    lower_steps_.push_back({&*arg, false});
+                }
+                continue;
+            }
+            if (const auto *cast = std::get_if<std::unique_ptr<CastExpr>>(&node_expr)) {
+                lower_steps_.push_back({step.expr, true});
+                lower_steps_.push_back({(*cast)->expr.get(), false});
+                continue;
+            }
+            lowered_.push_back(push(make_leaf(node_expr)));
+            continue;
+        }
+
+        // Every child is lowered: its root is on top of lowered_, the last child topmost
+        IrNode node;
+        if (const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(&node_expr)) {
+            node.kind = IrKind::BINARY;
+            node.op = static_cast<uint8_t>((*binary)->op);
+            node.b = lowered_.back();
+            lowered_.pop_back();
+            node.a = lowered_.back();
+            lowered_.pop_back();
+        } else if (const auto *unary = std::get_if<std::unique_ptr<UnaryOp>>(&node_expr)) {
+            node.kind = IrKind::UNARY;
+            node.op = static_cast<uint8_t>((*unary)->op);
+            node.a = lowered_.back();
+            lowered_.pop_back();
+        } else if (const auto *call = std::get_if<std::unique_ptr<FunctionCall>>(&node_expr)) {
+            const size_t count = (*call)->args.size();
+            node.kind = IrKind::FUNCTION;
+            node.op = (*call)->is_aggregate ? 1 : 0;
+            node.a = static_cast<uint32_t>(arguments.size());
+            node.b = static_cast<uint32_t>(count);
+            node.c = add_string((*call)->name);
+            arguments.insert(arguments.end(), lowered_.end() - static_cast<ptrdiff_t>(count), lowered_.end());
+            lowered_.resize(lowered_.size() - count);
+        } else if (const auto *cast = std::get_if<std::unique_ptr<CastExpr>>(&node_expr)) {
+            node.kind = IrKind::CAST;
+            node.type = (*cast)->target_type;
+            node.a = lowered_.back();
+            lowered_.pop_back();
+        }
+        lowered_.push_back(push(node));
+    }
+    return lowered_.back();
+}
+
+void ExprIr::clear() {
+    nodes.clear();
+    columns.clear();
+    integers.clear();
+    doubles.clear();
+    string_offsets.resize(1);
+    string_data.clear();
+    arguments.clear();
+    std::ranges::fill(column_slots_, 0);
+}
+
+LiteralValue ExprIr::literal(const uint32_t index) const {
+    const IrNode &node = nodes[index];
+    switch (node.kind) {
+        case IrKind::INTEGER: return LiteralValue{node.type, integers[node.a]};
+        case IrKind::DOUBLE: return LiteralValue{node.type, doubles[node.a]};
+        case IrKind::BOOLEAN: return LiteralValue{node.type, node.a != 0};
+        case IrKind::TEXT: return LiteralValue{node.type, std::string(string(node.a))};
+        case IrKind::NULL_VALUE: return LiteralValue{node.type, std::monostate{}};
+        default:
+            throw std::runtime_error("Expression IR node is not a literal");
+    }
+}
+
+bool ExprIr::is_literal(const uint32_t index) const {
+    switch (nodes[index].kind) {
+        case IrKind::INTEGER:
+        case IrKind::DOUBLE:
+        case IrKind::BOOLEAN:
+        case IrKind::TEXT:
+            return true;
+        case IrKind::NULL_VALUE:
+            return nodes[index].op == 1;
+        default:
+            return false;
+    }
+}
+
+Expr ExprIr::raise(const uint32_t root) const {
+    if (root >= nodes.size()) {
+        throw std::runtime_error("Expression IR root out of range");
+    }
+    struct Step {
+        uint32_t index;
+        bool children_done;
+    };
+    // Per-thread scratch, as raising does not nest. It is emptied on every exit, since the subtrees it holds may live
+    // in an arena that does not outlive the call.
+    thread_local std::vector<Step> steps;
+    thread_local std::vector<Expr> raised; // Subtrees built so far, awaiting their parent; the last child topmost
+    struct Release {
+        ~Release() {
+            steps.clear();
+            raised.clear();
+        }
+    } release;
+    steps.assign(1, {root, false});
+    const auto take = [] {
+        Expr child = std::move(raised.back());
+        raised.pop_back();
+        return child;
+    };
+    // An absent operand raises to a null ExprPtr, any other node to a boxed subtree
+    const auto take_operand = [this, &take](const uint32_t index) -> ExprPtr {
+        Expr child = take();
+        if (nodes[index].kind == IrKind::NULL_VALUE && nodes[index].op == 2) {
+            return nullptr;
+        }
+        return std::make_unique<Expression>(std::move(child));
+    };
+
+    while (!steps.empty()) {
+        const Step step = steps.back();
+        steps.pop_back();
+        const IrNode &node = nodes[step.index];
+        if (!step.children_done) {
+            switch (node.kind) {
+                case IrKind::BINARY:
+                    steps.push_back({step.index, true});
+                    steps.push_back({node.b, false});
+                    steps.push_back({node.a, false});
+                    continue;
+                case IrKind::UNARY:
+                case IrKind::CAST:
+                    steps.push_back({step.index, true});
+                    steps.push_back({node.a, false});
+                    continue;
+                case IrKind::FUNCTION:
+                    steps.push_back({step.index, true});
+                    for (uint32_t arg = node.b; arg-- > 0;) steps.push_back({arguments[node.a + arg], false});
+                    continue;
+                default:
+                    break;
+            }
+        }
+
+        switch (node.kind) {
+            case IrKind::NULL_VALUE:
+                if (node.op == 1) {
+                    raised.emplace_back(LiteralValue{node.type, std::monostate{}});
+                } else {
+                    raised.emplace_back(std::monostate{});
+                }
+                break;
+            case IrKind::COLUMN:
+                raised.emplace_back(columns[node.a]);
+                break;
+            case IrKind::INTEGER:
+            case IrKind::DOUBLE:
+            case IrKind::BOOLEAN:
+            case IrKind::TEXT:
+                raised.emplace_back(literal(step.index));
+                break;
+            case IrKind::PARAMETER:
+                raised.emplace_back(ParameterRef{node.a});
+                break;
+            case IrKind::BINARY: {
+                auto binary = std::make_unique<BinaryOp>();
+                binary->op = static_cast<BinaryOp::Op>(node.op);
+                binary->right = take();
+                binary->left = take();
+                raised.emplace_back(std::move(binary));
+                break;
+            }
+            case IrKind::UNARY: {
+                auto unary = std::make_unique<UnaryOp>();
+                unary->op = static_cast<UnaryOp::Op>(node.op);
+                unary->operand = take_operand(node.a);
+                raised.emplace_back(std::move(unary));
+                break;
+            }
+            case IrKind::FUNCTION: {
+                auto call = std::make_unique<FunctionCall>();
+                call->name = string(node.c);
+                call->is_aggregate = node.op != 0;
+                call->args.resize(node.b);
+                for (uint32_t arg = node.b; arg-- > 0;) call->args[arg] = take();
+                raised.emplace_back(std::move(call));
+                break;
+            }
+            case IrKind::CAST: {
+                auto cast = std::make_unique<CastExpr>();
+                cast->target_type = node.type;
+                cast->expr = take_operand(node.a);
+                raised.emplace_back(std::move(cast));
+                break;
+            }
+            default:
+                throw std::runtime_error("Unknown expression IR node kind");
+        }
+    }
+    Expr expr = std::move(raised.back());
+    raised.pop_back();
+    return expr;
+}
+
+ExprIr lower_expr(const Expr &expr) {
+    ExprIr ir;
+    ir.lower(expr);
+    return ir;
+}
@@ -0,0 +1,103 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_EXPR_IR_H
+#define FLUXO_DB_EXPR_IR_H
+#pragma once
+#include "../ast/ast_expr.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class IrKind : uint8_t {
+    NULL_VALUE, // op = 0 for an empty expression, 1 for a NULL literal, 2 for an absent operand (null ExprPtr)
+    COLUMN,     // a = index into ExprIr::columns
+    INTEGER,    // a = index into ExprIr::integers
+    DOUBLE,     // a = index into ExprIr::doubles
+    BOOLEAN,    // a = value (0 or 1)
+    TEXT,       // a = string index (ExprIr::string)
+    BINARY,     // op = BinaryOp::Op, a = left node, b = right node
+    UNARY,      // op = UnaryOp::Op, a = operand node
+    FUNCTION,   // op = is_aggregate, a = first entry in ExprIr::arguments, b = argument count, c = string index (name)
+    CAST,       // a = operand node, type = target type
+    PARAMETER   // a = parameter slot (1-based)
+};
+
+// One expression node. Children always come before their parent, so a forward scan visits operands first.
+struct IrNode {
+    IrKind kind = IrKind::NULL_VALUE;
+    uint8_t op = 0;
+    DataType type = DataType::NULL_TYPE; // Literal type, or target type of a CAST
+    uint32_t a = 0;
+    uint32_t b = 0;
+    uint32_t c = 0;
+};
+
+// Flat form of one or more Expr trees: a node array in post-order with 32-bit child indices, literal values kept in
+// typed pools and column references interned, so walking an expression is a linear scan over contiguous memory.
+// Lowering and raising use explicit stacks, so tree depth is bounded by memory rather than by the call stack. After
+// clear() an ExprIr keeps its capacity: reusing one as scratch space lowers further trees without allocating.
+class ExprIr {
+private:
+    struct LowerStep {
+        const Expr *expr; // nullptr for an absent operand
+        bool children_done;
+    };
+
+    std::vector<uint32_t> column_slots_; // Open-addressed column ids + 1 (0 = free), sized a power of two
+    std::vector<LowerStep> lower_steps_;
+    std::vector<uint32_t> lowered_; // Roots of the subtrees lowered so far, awaiting their parent
+
+    uint32_t push(const IrNode &node);
+    uint32_t intern_column(const ColumnRef &column);
+    void grow_column_slots();
+    IrNode make_leaf(const Expr &expr);
+
+public:
+    std::vector<IrNode> nodes;
+    std::vector<ColumnRef> columns;
+    std::vector<int64_t> integers;
+    std::vector<double> doubles;
+    std::vector<uint32_t> string_offsets{0}; // String i is string_data[string_offsets[i], string_offsets[i + 1])
+    std::string string_data;                 // TEXT literals and function names
+    std::vector<uint32_t> arguments;         // Function argument node indices, in call order
+
+    // Append `expr` and return the index of its root node
+    uint32_t lower(const Expr &expr);
+    // Rebuild the tree rooted at `root`
+    [[nodiscard]] Expr raise(uint32_t root) const;
+    // Drop every node and pooled value, keeping the allocated capacity
+    void clear();
+
+    // Append `text` to the string pool and return its index
+    uint32_t add_string(std::string_view text);
+    [[nodiscard]] std::string_view string(uint32_t index) const;
+    [[nodiscard]] size_t string_count() const { return string_offsets.size() - 1; }
+    [[nodiscard]] LiteralValue literal(uint32_t index) const;
+    [[nodiscard]] bool is_literal(uint32_t index) const;
+};
+
+// Lower a single expression; its root is the last node
+ExprIr lower_expr(const Expr &expr);
+
+#endif //FLUXO_DB_EXPR_IR_H
@@ -22,7 +22,229 @@
 
 #include "lexer.h"
 
-Lexer::Lexer(const std::string &input) : input(input) {
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+struct Keyword {
+    std::string_view name;
+    TokenType type;
+};
+
+// Postgres keywords are case-insensitive; names here are stored in UPPER case
+constexpr Keyword keywords[] = {
+    {"SELECT", TokenType::SELECT},
+    {"INSERT", TokenType::INSERT},
+    {"INTO", TokenType::INTO},
+    {"VALUES", TokenType::VALUES},
+    {"FROM", TokenType::FROM},
+    {"WHERE", TokenType::WHERE},
+    {"CREATE", TokenType::CREATE},
+    {"TABLE", TokenType::TABLE},
+    {"DROP", TokenType::DROP},
+    {"DELETE", TokenType::DELETE},
+    {"UPDATE", TokenType::UPDATE},
+    {"SET", TokenType::SET},
+    {"PRIMARY", TokenType::PRIMARY},
+    {"KEY", TokenType::KEY},
+    {"NOT", TokenType::NOT},
+    {"UNIQUE", TokenType::UNIQUE},
+    {"IF", TokenType::IF},
+    {"EXISTS", TokenType::EXISTS},
+    {"CASCADE", TokenType::CASCADE},
+    {"RESTRICT", TokenType::RESTRICT},
+    {"ONLY", TokenType::ONLY},
+    {"RENAME", TokenType::RENAME},
+    {"CONSTRAINT", TokenType::CONSTRAINT},
+    {"ALTER", TokenType::ALTER},
+    {"ATTACH", TokenType::ATTACH},
+    {"DETACH", TokenType::DETACH},
+    {"OWNED", TokenType::OWNED},
+    {"FOR", TokenType::FOR},
+    {"DEFAULT", TokenType::DEFAULT},
+    {"COLUMN", TokenType::COLUMN},
+    {"TO", TokenType::TO},
+    {"SCHEMA", TokenType::SCHEMA},
+    {"OWNER", TokenType::OWNER},
+    {"ADD", TokenType::ADD},
+    {"TYPE", TokenType::TYPE},
+    {"USING", TokenType::USING},
+    {"COLLATE", TokenType::COLLATE},
+    {"DATABASE", TokenType::DATABASE},
+    {"VIEW", TokenType::VIEW},
+    {"INDEX", TokenType::INDEX},
+    {"TRIGGER", TokenType::TRIGGER},
+    {"COLLATION", TokenType::COLLATION},
+    {"USER", TokenType::USER},
+    {"SEQUENCE", TokenType::SEQUENCE},
+    {"CONCURRENTLY", TokenType::CONCURRENTLY},
+    {"FOREIGN", TokenType::FOREIGN},
+    {"CHECK", TokenType::CHECK},
+    {"REFERENCES", TokenType::REFERENCES},
+    {"LOCALE", TokenType::LOCALE},
+    {"DETERMINISTIC", TokenType::DETERMINISTIC},
+    {"PROVIDER", TokenType::PROVIDER},
+    {"RULES", TokenType::RULES},
+    {"TRUE", TokenType::TRUE},
+    {"FALSE", TokenType::FALSE},
+    {"TABLESPACE", TokenType::TABLESPACE},
+    {"ALLOW_CONNECTIONS", TokenType::ALLOW_CONNECTIONS},
+    {"CONNECTION_LIMIT", TokenType::CONNECTION_LIMIT},
+    {"ENCODING", TokenType::ENCODING},
+    {"ON", TokenType::ON},
+    {"ASC", TokenType::ASC},
+    {"ASCENDING", TokenType::ASC},
+    {"DESC", TokenType::DESC},
+    {"DESCENDING", TokenType::DESC},
+    {"NULLS", TokenType::NULLS},
+    {"FIRST", TokenType::FIRST},
+    {"LAST", TokenType::LAST},
+    {"BEFORE", TokenType::BEFORE},
+    {"AFTER", TokenType::AFTER},
+    {"INSTEAD", TokenType::INSTEAD},
+    {"OF", TokenType::OF},
+    {"TRUNCATE", TokenType::TRUNCATE},
+    {"OR", TokenType::OR},
+    {"EXECUTE", TokenType::EXECUTE},
+    {"FUNCTION", TokenType::FUNCTION},
+    {"EACH", TokenType::EACH},
+    {"ROW", TokenType::ROW},
+    {"STATEMENT", TokenType::STATEMENT},
+    {"WHEN", TokenType::WHEN},
+    {"AUTHORIZATION", TokenType::AUTHORIZATION},
+    {"TEMPORARY", TokenType::TEMPORARY},
+    {"TEMP", TokenType::TEMPORARY},
+    {"INCREMENT", TokenType::INCREMENT},
+    {"BY", TokenType::BY},
+    {"MINVALUE", TokenType::MINVALUE},
+    {"MAXVALUE", TokenType::MAXVALUE},
+    {"CYCLE", TokenType::CYCLE},
+    {"START", TokenType::START},
+    {"WITH", TokenType::WITH},
+    {"NO", TokenType::NO},
+    {"CACHE", TokenType::CACHE},
+    {"NONE", TokenType::NONE},
+    {"ROLE", TokenType::ROLE},
+    {"PASSWORD", TokenType::PASSWORD},
+    {"LOGIN", TokenType::LOGIN},
+    {"NOLOGIN", TokenType::NO_LOGIN},
+    {"SUPERUSER", TokenType::SUPERUSER},
+    {"CONNECTION", TokenType::CONNECTION},
+    {"LIMIT", TokenType::LIMIT},
+    {"VALID", TokenType::VALID},
+    {"UNTIL", TokenType::UNTIL},
+    {"NOSUPERUSER", TokenType::NO_SUPERUSER},
+    {"CREATEROLE", TokenType::CREATE_ROLE},
+    {"NOCREATEROLE", TokenType::NO_CREATE_ROLE},
+    {"INHERIT", TokenType::INHERIT},
+    {"NOINHERIT", TokenType::NO_INHERIT},
+    {"CREATEDB", TokenType::CREATE_DB},
+    {"NOCREATEDB", TokenType::NO_CREATE_DB},
+    {"NULL", TokenType::NULL_TYPE},
+    {"CAST", TokenType::CAST},
+    {"AS", TokenType::AS},
+};
+
+constexpr char toUpperAscii(const char c) {
+    return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// FNV-1a over the upper-cased bytes, so "select" and "SELECT" land in the same slot
+constexpr uint32_t hashKeyword(const std::string_view ident, const uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed ^ static_cast<uint32_t>(ident.length());
+    for (const char c : ident) {
+        hash ^= static_cast<uint8_t>(toUpperAscii(c));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+constexpr size_t keywordSlotBits = 10;
+constexpr size_t keywordSlotCount = size_t{1} << keywordSlotBits;
+
+constexpr size_t keywordSlot(const std::string_view ident, const uint32_t seed) {
+    return hashKeyword(ident, seed) >> (32 - keywordSlotBits);
+}
+
+// Search for a seed under which every keyword gets its own slot, i.e. the hash is perfect over the keyword set
+constexpr uint32_t findPerfectSeed() {
+    for (uint32_t seed = 0; seed < 100000; ++seed) {
+        std::array<bool, keywordSlotCount> used{};
+        bool collision = false;
+        for (const auto &[name, type] : keywords) {
+            const size_t slot = keywordSlot(name, seed);
+            if (used[slot]) {
+                collision = true;
+                break;
+            }
+            used[slot] = true;
+        }
+        if (!collision) return seed;
+    }
+    return UINT32_MAX;
+}
+
+constexpr uint32_t keywordSeed = findPerfectSeed();
+static_assert(keywordSeed != UINT32_MAX, "No perfect hash seed found for the keyword table");
+static_assert(std::size(keywords) < UINT8_MAX, "Keyword slots store 8-bit indices");
+
+// Slot -> 1-based index into keywords, 0 for an empty slot
+constexpr std::array<uint8_t, keywordSlotCount> keywordSlots = [] {
+    std::array<uint8_t, keywordSlotCount> slots{};
+    for (size_t i = 0; i < std::size(keywords); ++i) {
+        slots[keywordSlot(keywords[i].name, keywordSeed)] = static_cast<uint8_t>(i + 1);
+    }
+    return slots;
+}();
+
+constexpr size_t minKeywordLength = std::ranges::min(keywords, {}, [](const Keyword &kw) { return kw.name.length(); }).name.length();
+constexpr size_t maxKeywordLength = std::ranges::max(keywords, {}, [](const Keyword &kw) { return kw.name.length(); }).name.length();
+
+} // namespace
+
+TokenType lookupKeyword(const std::string_view ident) {
+    if (ident.length() < minKeywordLength || ident.length() > maxKeywordLength) {
+        return TokenType::IDENTIFIER;
+    }
+    const uint8_t slot = keywordSlots[keywordSlot(ident, keywordSeed)];
+    if (slot == 0) {
+        return TokenType::IDENTIFIER;
+    }
+    // The slot only tells us which keyword the identifier could be; confirm it byte by byte
+    const Keyword &candidate = keywords[slot - 1];
+    if (candidate.name.length() != ident.length()) {
+        return TokenType::IDENTIFIER;
+    }
+    for (size_t i = 0; i < ident.length(); ++i) {
+        if (toUpperAscii(ident[i]) != candidate.name[i]) {
+            return TokenType::IDENTIFIER;
+        }
+    }
+    return candidate.type;
+}
+
+// Token offsets are 32-bit
+static std::string_view checkedInput(const std::string_view input) {
+    if (input.length() > UINT32_MAX) {
+        throw std::length_error("Lexer input exceeds 4 GiB");
+    }
+    return input;
+}
+
+Lexer::Lexer(const std::string &input) : storage(input), input(checkedInput(storage)) {
+    readChar();
+}
+
+Lexer::Lexer(const std::string_view input, BorrowInput) : input(checkedInput(input)) {
+    readChar();
+}
+
+Lexer::Lexer(const std::string_view input, BorrowInput, const int line, const int column)
+    : input(checkedInput(input)), baseLine(line), baseColumn(column) {
     readChar();
 }
 
@@ -34,59 +256,68 @@ void Lexer::readChar() {
     }
     position = readPosition;
     readPosition++;
-    column++;
 }
 
-void Lexer::skipWhitespace() {
-    while (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
-        if (ch == '\n') {
-            line++;
-            column = 0;
+// Jump over `count` characters, with the same effect as `count` readChar() calls
+void Lexer::skipChars(const size_t count) {
+    position += count;
+    readPosition = position + 1;
+    ch = position < input.length() ? input[position] : 0;
+}
+
+SourceLocation Lexer::location(const uint32_t offset) const {
+    const size_t end = std::min<size_t>(offset, input.length());
+    while (newlinesScanned < end) {
+        const void *hit = std::memchr(input.data() + newlinesScanned, '\n', end - newlinesScanned);
+        if (hit == nullptr) {
+            newlinesScanned = end;
+            break;
         }
-        readChar();
+        const auto at = static_cast<size_t>(static_cast<const char *>(hit) - input.data());
+        newlines.push_back(static_cast<uint32_t>(at));
+        newlinesScanned = at + 1;
     }
+    // Newlines before `offset` give the line; the column counts from the last of them
+    const auto next = std::ranges::lower_bound(newlines, offset);
+    const auto linesBefore = static_cast<int>(next - newlines.begin());
+    if (linesBefore == 0) {
+        return {baseLine, baseColumn + static_cast<int>(offset)};
+    }
+    return {baseLine + linesBefore, static_cast<int>(offset - *(next - 1))};
+}
+
+// Bytes left from the current character to the end of the input
+size_t Lexer::remaining() const {
+    return position < input.length() ? input.length() - position : 0;
 }
 
-std::string Lexer::readIdentifier() {
+void Lexer::skipWhitespace() {
+    skipChars(scan.whitespace(input.data() + position, remaining()));
+}
+
+std::string_view Lexer::readIdentifier() {
     const size_t startPosition = position;
     // Allow alphanumeric and underscore
-    while (isalpha(ch) || ch == '_' || isdigit(ch)) {
-        readChar();
-    }
+    skipChars(scan.identifier(input.data() + position, remaining()));
     // Return the substring representing the identifier
     return input.substr(startPosition, position - startPosition);
 }
 
-std::string Lexer::readNumber() {
+std::string_view Lexer::readNumber() {
     const size_t startPosition = position;
-    while (isdigit(ch) || ch == '.') {
-        readChar();
-    }
+    skipChars(scan.number(input.data() + position, remaining()));
     return input.substr(startPosition, position - startPosition);
 }
 
-// Helper to distinguish between keywords and identifiers
-TokenType Lexer::lookupIdent(const std::string& ident) {
-    // Postgres keywords are case-insensitive. Convert to UPPER for lookup
-    std::string upperIdent = ident;
-    for (auto & c : upperIdent) c = toupper(c);
-
-    if (keywords.contains(upperIdent)) {
-        return keywords[upperIdent];
-    }
-    return TokenType::IDENTIFIER;
-}
-
-std::string Lexer::readString() {
+std::string_view Lexer::readString() {
     const size_t startPosition = position + 1; // Skip opening quote
     readChar(); // Move past the opening quote
 
-    while (ch != '\'' && ch != 0) {
-        readChar();
-    }
+    // Everything up to the closing quote (or end of input) is the literal; it may span lines
+    skipChars(scan.stringBody(input.data() + position, remaining()));
 
     // Capture the string literal
-    std::string str = input.substr(startPosition, position - startPosition);
+    const std::string_view str = input.substr(startPosition, position - startPosition);
 
     if (ch == '\'') {
         readChar(); // Consume the closing quote
@@ -98,63 +329,78 @@ Token Lexer::NextToken() {
     Token tok;
     skipWhitespace();
 
-    tok.line = line;
-    tok.column = column;
+    const auto start = static_cast<uint32_t>(position);
 
     switch (ch) {
         case ',':
-            tok = {TokenType::COMMA, std::string(1, ch), line, column};
+            tok = {TokenType::COMMA, input.substr(position, 1), start};
             break;
         case ';':
-            tok = {TokenType::SEMICOLON, std::string(1, ch), line, column};
+            tok = {TokenType::SEMICOLON, input.substr(position, 1), start};
             break;
         case '*':
-            tok = {TokenType::ASTERISK, std::string(1, ch), line, column};
+            tok = {TokenType::ASTERISK, input.substr(position, 1), start};
             break;
         case '.':
-            tok = {TokenType::DOT, std::string(1, ch), line, column};
+            tok = {TokenType::DOT, input.substr(position, 1), start};
             break;
         case '=':
-            tok = {TokenType::EQUALS, std::string(1, ch), line, column};
+            tok = {TokenType::EQUALS, input.substr(position, 1), start};
             break;
         case '(':
-            tok = {TokenType::LPAREN, std::string(1, ch), line, column};
+            tok = {TokenType::LPAREN, input.substr(position, 1), start};
             break;
         case ')':
-            tok = {TokenType::RPAREN, std::string(1, ch), line, column};
+            tok = {TokenType::RPAREN, input.substr(position, 1), start};
             break;
         case '+':
-            tok = {TokenType::PLUS, std::string(1, ch), line, column};
+            tok = {TokenType::PLUS, input.substr(position, 1), start};
             break;
         case '-':
-            tok = {TokenType::MINUS, std::string(1, ch), line, column};
+            tok = {TokenType::MINUS, input.substr(position, 1), start};
+            break;
+        case '/':
+            tok = {TokenType::SLASH, input.substr(position, 1), start};
             break;
         case '%':
-            tok = {TokenType::PERCENT, std::string(1, ch), line, column};
+            tok = {TokenType::PERCENT, input.substr(position, 1), start};
             break;
         case '^':
-            tok = {TokenType::CARET, std::string(1, ch), line, column};
+            tok = {TokenType::CARET, input.substr(position, 1), start};
+            break;
+        case '?':
+            tok = {TokenType::PARAMETER, input.substr(position, 1), start};
             break;
+        case '$': {
+            // $n placeholder; a lone '$' stays illegal
+            size_t digits = 0;
+            while (position + 1 + digits < input.length() && isdigit(input[position + 1 + digits])) {
+                digits++;
+            }
+            if (digits == 0) {
+                tok = {TokenType::ILLEGAL, input.substr(position, 1), start};
+                break;
+            }
+            const std::string_view placeholder = input.substr(position, digits + 1);
+            skipChars(digits + 1);
+            return {TokenType::PARAMETER, placeholder, start};
+        }
         case '\'':
-            tok.type = TokenType::STRING;
-            tok.literal = readString();
-            tok.line = line;
-            tok.column = column;
-            return tok;
+            return {TokenType::STRING, readString(), start};
         case 0:
-            tok = {TokenType::EOF_TOKEN, std::string(1, ch), line, column};
+            tok = {TokenType::EOF_TOKEN, input.substr(input.length()), start};
             break;
         default:
             if (isalpha(ch) || ch == '_') {
                 // It's a keyword or identifier
-                const std::string ident = readIdentifier();
-                const TokenType type = lookupIdent(ident);
-                return {type, ident, line, column - static_cast<int>(ident.length())};
+                const std::string_view ident = readIdentifier();
+                const TokenType type = lookupKeyword(ident);
+                return {type, ident, start};
             } else if (isdigit(ch)) {
-                const std::string number = readNumber();
-                return {TokenType::NUMBER, number, line, column - static_cast<int>(number.length())};
+                const std::string_view number = readNumber();
+                return {TokenType::NUMBER, number, start};
             } else {
-                tok = {TokenType::ILLEGAL, std::string(1, ch), line, column};
+                tok = {TokenType::ILLEGAL, input.substr(position, 1), start};
             }
     }
 
@@ -22,8 +22,12 @@
 
 #ifndef FLUXO_DB_LEXER_H
 #define FLUXO_DB_LEXER_H
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
+
+#include "scan.h"
 
 // Enum for all possible token types
 enum class TokenType {
@@ -35,12 +39,13 @@ enum class TokenType {
     CONNECTION_LIMIT, ENCODING, ON, ASC, DESC, NULLS, FIRST, LAST, BEFORE, AFTER, INSTEAD, OF, OR, TRUNCATE, EXECUTE,
     FUNCTION, EACH, ROW, STATEMENT, WHEN, AUTHORIZATION, TEMPORARY, INCREMENT, BY, MINVALUE, MAXVALUE, CYCLE, START,
     WITH, NO, CACHE, NONE, ROLE, PASSWORD, LOGIN, NO_LOGIN, SUPERUSER, CONNECTION, LIMIT, VALID, UNTIL, NO_SUPERUSER, CREATE_ROLE,
-    NO_CREATE_ROLE, INHERIT, NO_INHERIT, CREATE_DB, NO_CREATE_DB, NULL_TYPE,
+    NO_CREATE_ROLE, INHERIT, NO_INHERIT, CREATE_DB, NO_CREATE_DB, NULL_TYPE, CAST, AS,
 
     // Literals
     IDENTIFIER, // Table names, column names, etc.
     STRING,
     NUMBER,
+    PARAMETER, // Placeholder: ? or $1, $2, ...
 
     // Symbols
     COMMA, // ,
@@ -67,145 +72,75 @@ enum class TokenType {
     UNKNOWN,
 };
 
+// A token's literal is a view into the buffer the lexer reads from, so it is only valid while that buffer is alive.
+// Copy it into a std::string when it has to outlive the input (the parser does so for every name it stores in the AST).
+// Positions are kept as byte offsets and only turned into a line and column (Lexer::location) when one is reported.
 struct Token {
     TokenType type;
-    std::string literal;
-    int line;
-    int column;
+    std::string_view literal;
+    uint32_t offset; // Byte offset of the token's first character in the lexer's input
+};
+
+// 1-based line and column of a position in the script
+struct SourceLocation {
+    int line = 1;
+    int column = 1;
+};
+
+// Distinguish keywords from identifiers. Keywords are matched case-insensitively against a table built at compile time,
+// so the lookup neither allocates nor depends on any Lexer instance.
+TokenType lookupKeyword(std::string_view ident);
+
+// Tag for the zero-copy Lexer constructor: the lexer reads straight from the caller's buffer instead of copying it
+struct BorrowInput {
+    explicit BorrowInput() = default;
 };
+inline constexpr BorrowInput borrow_input{};
 
 class Lexer {
 private:
-    std::string input;
+    std::string storage; // Owned copy of the input, empty when the input is borrowed
+    std::string_view input;
     size_t position = 0;
     size_t readPosition = 0;
     char ch = 0;
-    int line = 1;
-    int column = 0;
-
-    // Map string keywords to enum TokenType
-    std::unordered_map<std::string, TokenType> keywords = {
-        {"SELECT", TokenType::SELECT},
-        {"INSERT", TokenType::INSERT},
-        {"INTO", TokenType::INTO},
-        {"VALUES", TokenType::VALUES},
-        {"FROM", TokenType::FROM},
-        {"WHERE", TokenType::WHERE},
-        {"CREATE", TokenType::CREATE},
-        {"TABLE", TokenType::TABLE},
-        {"DROP", TokenType::DROP},
-        {"DELETE", TokenType::DELETE},
-        {"UPDATE", TokenType::UPDATE},
-        {"SET", TokenType::SET},
-        {"PRIMARY", TokenType::PRIMARY},
-        {"KEY", TokenType::KEY},
-        {"NOT", TokenType::NOT},
-        {"UNIQUE", TokenType::UNIQUE},
-        {"IF", TokenType::IF},
-        {"EXISTS", TokenType::EXISTS},
-        {"CASCADE", TokenType::CASCADE},
-        {"RESTRICT", TokenType::RESTRICT},
-        {"ONLY", TokenType::ONLY},
-        {"RENAME", TokenType::RENAME},
-        {"CONSTRAINT", TokenType::CONSTRAINT},
-        {"ALTER", TokenType::ALTER},
-        {"ATTACH", TokenType::ATTACH},
-        {"DETACH", TokenType::DETACH},
-        {"OWNED", TokenType::OWNED},
-        {"FOR", TokenType::FOR},
-        {"DEFAULT", TokenType::DEFAULT},
-        {"COLUMN", TokenType::COLUMN},
-        {"TO", TokenType::TO},
-        {"SCHEMA", TokenType::SCHEMA},
-        {"OWNER", TokenType::OWNER},
-        {"ADD", TokenType::ADD},
-        {"TYPE", TokenType::TYPE},
-        {"USING", TokenType::USING},
-        {"COLLATE", TokenType::COLLATE},
-        {"DATABASE", TokenType::DATABASE},
-        {"VIEW", TokenType::VIEW},
-        {"INDEX", TokenType::INDEX},
-        {"TRIGGER", TokenType::TRIGGER},
-        {"COLLATION", TokenType::COLLATION},
-        {"USER", TokenType::USER},
-        {"SEQUENCE", TokenType::SEQUENCE},
-        {"CONCURRENTLY", TokenType::CONCURRENTLY},
-        {"FOREIGN", TokenType::FOREIGN},
-        {"CHECK", TokenType::CHECK},
-        {"REFERENCES", TokenType::REFERENCES},
-        {"LOCALE", TokenType::LOCALE},
-        {"DETERMINISTIC", TokenType::DETERMINISTIC},
-        {"PROVIDER", TokenType::PROVIDER},
-        {"RULES", TokenType::RULES},
-        {"TRUE", TokenType::TRUE},
-        {"FALSE", TokenType::FALSE},
-        {"TABLESPACE", TokenType::TABLESPACE},
-        {"ALLOW_CONNECTIONS", TokenType::ALLOW_CONNECTIONS},
-        {"CONNECTION_LIMIT", TokenType::CONNECTION_LIMIT},
-        {"ENCODING", TokenType::ENCODING},
-        {"ON", TokenType::ON},
-        {"ASC", TokenType::ASC},
-        {"ASCENDING", TokenType::ASC},
-        {"DESC", TokenType::DESC},
-        {"DESCENDING", TokenType::DESC},
-        {"NULLS", TokenType::NULLS},
-        {"FIRST", TokenType::FIRST},
-        {"LAST", TokenType::LAST},
-        {"BEFORE", TokenType::BEFORE},
-        {"AFTER", TokenType::AFTER},
-        {"INSTEAD", TokenType::INSTEAD},
-        {"OF", TokenType::OF},
-        {"TRUNCATE", TokenType::TRUNCATE},
-        {"OR", TokenType::OR},
-        {"EXECUTE", TokenType::EXECUTE},
-        {"FUNCTION", TokenType::FUNCTION},
-        {"EACH", TokenType::EACH},
-        {"ROW", TokenType::ROW},
-        {"STATEMENT", TokenType::STATEMENT},
-        {"WHEN", TokenType::WHEN},
-        {"AUTHORIZATION", TokenType::AUTHORIZATION},
-        {"TEMPORARY", TokenType::TEMPORARY},
-        {"TEMP", TokenType::TEMPORARY},
-        {"INCREMENT", TokenType::INCREMENT},
-        {"BY", TokenType::BY},
-        {"MINVALUE", TokenType::MINVALUE},
-        {"MAXVALUE", TokenType::MAXVALUE},
-        {"CYCLE", TokenType::CYCLE},
-        {"START", TokenType::START},
-        {"WITH", TokenType::WITH},
-        {"NO", TokenType::NO},
-        {"CACHE", TokenType::CACHE},
-        {"NONE", TokenType::NONE},
-        {"ROLE", TokenType::ROLE},
-        {"PASSWORD", TokenType::PASSWORD},
-        {"LOGIN", TokenType::LOGIN},
-        {"NOLOGIN", TokenType::NO_LOGIN},
-        {"SUPERUSER", TokenType::SUPERUSER},
-        {"CONNECTION", TokenType::CONNECTION},
-        {"LIMIT", TokenType::LIMIT},
-        {"VALID", TokenType::VALID},
-        {"UNTIL", TokenType::UNTIL},
-        {"NOSUPERUSER", TokenType::NO_SUPERUSER},
-        {"CREATEROLE", TokenType::CREATE_ROLE},
-        {"NOCREATEROLE", TokenType::NO_CREATE_ROLE},
-        {"INHERIT", TokenType::INHERIT},
-        {"NOINHERIT", TokenType::NO_INHERIT},
-        {"CREATEDB", TokenType::CREATE_DB},
-        {"NOCREATEDB", TokenType::NO_CREATE_DB},
-        {"NULL", TokenType::NULL_TYPE},
-    };
+    int baseLine = 1;   // Script position of the first input character
+    int baseColumn = 1;
+
+    // Offsets of the newlines in input[0, newlinesScanned), filled in by location() as far as it has been asked about
+    mutable std::vector<uint32_t> newlines;
+    mutable size_t newlinesScanned = 0;
+
+    // Vectorized run scanners picked for this CPU; the scalar ones are the fallback
+    const ScanKernels &scan = activeScanKernels();
 
     void readChar();
+    void skipChars(size_t count);
+    [[nodiscard]] size_t remaining() const;
     void skipWhitespace();
-    std::string readIdentifier();
-    std::string readNumber();
-    std::string readString();
-    TokenType lookupIdent(const std::string& ident);
+    std::string_view readIdentifier();
+    std::string_view readNumber();
+    std::string_view readString();
 
     friend class Parser;
 public:
+    // Copies the input; tokens stay valid for the lifetime of the lexer
     explicit Lexer(const std::string &input);
+    // Borrows the input; the caller keeps the buffer alive for as long as any token from this lexer is in use.
+    // Inputs are limited to 4 GiB, the range of Token::offset (std::length_error otherwise).
+    Lexer(std::string_view input, BorrowInput);
+    // Borrows a slice of a larger script whose first character sits at (line, column) of that script, so token
+    // positions are reported relative to the whole script
+    Lexer(std::string_view input, BorrowInput, int line, int column);
+
+    // Tokens point into the lexer (or its borrowed buffer), so the lexer is pinned in place
+    Lexer(const Lexer&) = delete;
+    Lexer& operator=(const Lexer&) = delete;
 
     Token NextToken();
+
+    // Line and column of a token offset. The newline table behind it is built on the first call, so lexing itself
+    // never tracks lines; later calls only scan input they have not seen yet.
+    [[nodiscard]] SourceLocation location(uint32_t offset) const;
 };
 #endif //FLUXO_DB_LEXER_H
\ No newline at end of file
@@ -0,0 +1,242 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "scan.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FLUXO_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool isIdentifierChar(const char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool isNumberChar(const char c) {
+    return (c >= '0' && c <= '9') || c == '.';
+}
+
+bool isWhitespaceChar(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isStringBodyChar(const char c) {
+    return c != '\'' && c != 0;
+}
+
+template <bool (*Matches)(char)>
+size_t scalarRun(const char *data, const size_t length, size_t i = 0) {
+    while (i < length && Matches(data[i])) {
+        ++i;
+    }
+    return i;
+}
+
+size_t scalarIdentifier(const char *data, const size_t length) { return scalarRun<isIdentifierChar>(data, length); }
+size_t scalarNumber(const char *data, const size_t length) { return scalarRun<isNumberChar>(data, length); }
+size_t scalarWhitespace(const char *data, const size_t length) { return scalarRun<isWhitespaceChar>(data, length); }
+size_t scalarStringBody(const char *data, const size_t length) { return scalarRun<isStringBodyChar>(data, length); }
+
+constexpr ScanKernels scalarKernels{
+    "scalar", scalarIdentifier, scalarNumber, scalarWhitespace, scalarStringBody,
+};
+
+#ifdef FLUXO_SCAN_X86
+
+// --- SSE4.2 ---
+// PCMPISTRI treats the first NUL in the data block as its end, and with negative polarity every position at or past
+// the end counts as a mismatch, so the returned index is the end of the run or the NUL, whichever comes first.
+
+template <int Mode>
+__attribute__((target("sse4.2")))
+size_t sse42Run(const char *data, const size_t length, const __m128i set, bool (*tailMatches)(char)) {
+    size_t i = 0;
+    while (i + 16 <= length) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const int index = _mm_cmpistri(set, block, Mode);
+        if (index != 16) {
+            return i + index;
+        }
+        i += 16;
+    }
+    while (i < length && tailMatches(data[i])) {
+        ++i;
+    }
+    return i;
+}
+
+constexpr int sse42RangesMode = _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT;
+constexpr int sse42AnyMode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT;
+
+__attribute__((target("sse4.2")))
+size_t sse42Identifier(const char *data, const size_t length) {
+    const __m128i ranges = _mm_setr_epi8('A', 'Z', 'a', 'z', '0', '9', '_', '_', 0, 0, 0, 0, 0, 0, 0, 0);
+    return sse42Run<sse42RangesMode>(data, length, ranges, isIdentifierChar);
+}
+
+__attribute__((target("sse4.2")))
+size_t sse42Number(const char *data, const size_t length) {
+    const __m128i ranges = _mm_setr_epi8('0', '9', '.', '.', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    return sse42Run<sse42RangesMode>(data, length, ranges, isNumberChar);
+}
+
+__attribute__((target("sse4.2")))
+size_t sse42Whitespace(const char *data, const size_t length) {
+    const __m128i set = _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    return sse42Run<sse42AnyMode>(data, length, set, isWhitespaceChar);
+}
+
+// Looking for a byte (the quote or NUL) rather than the end of a class: plain compares are cheaper than PCMPISTRI
+__attribute__((target("sse4.2")))
+size_t sse42StringBody(const char *data, const size_t length) {
+    const __m128i quote = _mm_set1_epi8('\'');
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    while (i + 16 <= length) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, zero));
+        if (const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(stop)); mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+        i += 16;
+    }
+    return scalarRun<isStringBodyChar>(data, length, i);
+}
+
+// --- AVX2 ---
+// Each helper yields a byte mask of the characters that belong to the run; the run ends at the first zero bit.
+
+__attribute__((target("avx2")))
+__m256i avx2InRange(const __m256i block, const char low, const char high) {
+    // Signed compares: bytes >= 0x80 are negative and never fall into an ASCII range
+    return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(static_cast<char>(low - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(high + 1)), block));
+}
+
+__attribute__((target("avx2")))
+__m256i avx2IdentifierMask(const __m256i block) {
+    // Setting 0x20 folds 'A'-'Z' onto 'a'-'z' without pulling any non-letter into that range
+    const __m256i letters = avx2InRange(_mm256_or_si256(block, _mm256_set1_epi8(0x20)), 'a', 'z');
+    const __m256i digits = avx2InRange(block, '0', '9');
+    const __m256i underscore = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(_mm256_or_si256(letters, digits), underscore);
+}
+
+__attribute__((target("avx2")))
+__m256i avx2NumberMask(const __m256i block) {
+    return _mm256_or_si256(avx2InRange(block, '0', '9'), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('.')));
+}
+
+__attribute__((target("avx2")))
+__m256i avx2WhitespaceMask(const __m256i block) {
+    const __m256i space = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+    const __m256i tab = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t'));
+    const __m256i newline = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'));
+    const __m256i carriage = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'));
+    return _mm256_or_si256(_mm256_or_si256(space, tab), _mm256_or_si256(newline, carriage));
+}
+
+__attribute__((target("avx2")))
+__m256i avx2StringBodyMask(const __m256i block) {
+    const __m256i quote = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\''));
+    const __m256i zero = _mm256_cmpeq_epi8(block, _mm256_setzero_si256());
+    return _mm256_xor_si256(_mm256_or_si256(quote, zero), _mm256_set1_epi8(-1));
+}
+
+template <__m256i (*Mask)(__m256i), bool (*Matches)(char)>
+__attribute__((target("avx2")))
+size_t avx2Run(const char *data, const size_t length) {
+    size_t i = 0;
+    while (i + 32 <= length) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        if (const auto outside = ~static_cast<unsigned>(_mm256_movemask_epi8(Mask(block))); outside != 0) {
+            return i + __builtin_ctz(outside);
+        }
+        i += 32;
+    }
+    return scalarRun<Matches>(data, length, i);
+}
+
+__attribute__((target("avx2")))
+size_t avx2Identifier(const char *data, const size_t length) {
+    return avx2Run<avx2IdentifierMask, isIdentifierChar>(data, length);
+}
+
+__attribute__((target("avx2")))
+size_t avx2Number(const char *data, const size_t length) {
+    return avx2Run<avx2NumberMask, isNumberChar>(data, length);
+}
+
+__attribute__((target("avx2")))
+size_t avx2Whitespace(const char *data, const size_t length) {
+    return avx2Run<avx2WhitespaceMask, isWhitespaceChar>(data, length);
+}
+
+__attribute__((target("avx2")))
+size_t avx2StringBody(const char *data, const size_t length) {
+    return avx2Run<avx2StringBodyMask, isStringBodyChar>(data, length);
+}
+
+constexpr ScanKernels sse42Kernels{
+    "sse4.2", sse42Identifier, sse42Number, sse42Whitespace, sse42StringBody,
+};
+
+constexpr ScanKernels avx2Kernels{
+    "avx2", avx2Identifier, avx2Number, avx2Whitespace, avx2StringBody,
+};
+
+#endif // FLUXO_SCAN_X86
+
+} // namespace
+
+const ScanKernels &scalarScanKernels() {
+    return scalarKernels;
+}
+
+const ScanKernels *sse42ScanKernels() {
+#ifdef FLUXO_SCAN_X86
+    if (__builtin_cpu_supports("sse4.2")) {
+        return &sse42Kernels;
+    }
+#endif
+    return nullptr;
+}
+
+const ScanKernels *avx2ScanKernels() {
+#ifdef FLUXO_SCAN_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return &avx2Kernels;
+    }
+#endif
+    return nullptr;
+}
+
+const ScanKernels &activeScanKernels() {
+    static const ScanKernels &active = []() -> const ScanKernels & {
+        if (const ScanKernels *kernels = avx2ScanKernels()) return *kernels;
+        if (const ScanKernels *kernels = sse42ScanKernels()) return *kernels;
+        return scalarScanKernels();
+    }();
+    return active;
+}
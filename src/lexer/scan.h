@@ -0,0 +1,48 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_SCAN_H
+#define FLUXO_DB_SCAN_H
+#include <cstddef>
+
+// Character-class scanners used by the Lexer to find the end of a run in one call instead of one readChar() per byte.
+// Every kernel returns the length of the run that starts at data[0], looking at no more than `length` bytes.
+// A NUL byte always ends a run, matching the scalar lexer which treats NUL as end of input.
+struct ScanKernels {
+    const char *name;
+    size_t (*identifier)(const char *data, size_t length); // [A-Za-z0-9_]
+    size_t (*number)(const char *data, size_t length);     // [0-9.]
+    size_t (*whitespace)(const char *data, size_t length); // ' ', '\t', '\n', '\r'
+    size_t (*stringBody)(const char *data, size_t length); // anything up to the closing quote
+};
+
+// Portable byte-at-a-time kernels; the reference every vectorized variant must agree with
+const ScanKernels &scalarScanKernels();
+// 16 bytes per step (PCMPISTRI); nullptr when the CPU or the build target lacks SSE4.2
+const ScanKernels *sse42ScanKernels();
+// 32 bytes per step; nullptr when the CPU or the build target lacks AVX2
+const ScanKernels *avx2ScanKernels();
+
+// Best kernels for the running CPU, chosen once on first use
+const ScanKernels &activeScanKernels();
+
+#endif //FLUXO_DB_SCAN_H
@@ -0,0 +1,387 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "constant_folding.h"
+#include "../ast/ast_visit.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+bool is_null(const LiteralValue &literal) {
+    return std::holds_alternative<std::monostate>(literal.value);
+}
+
+const LiteralValue *as_literal(const Expr &expr) {
+    return std::get_if<LiteralValue>(&expr);
+}
+
+bool is_integer_literal(const Expr &expr, const int64_t value) {
+    const LiteralValue *literal = as_literal(expr);
+    const auto *integer = literal ? std::get_if<int64_t>(&literal->value) : nullptr;
+    return integer && *integer == value;
+}
+
+bool is_boolean_literal(const Expr &expr, const bool value) {
+    const LiteralValue *literal = as_literal(expr);
+    const auto *boolean = literal ? std::get_if<bool>(&literal->value) : nullptr;
+    return boolean && *boolean == value;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+    return text;
+}
+
+template <typename T>
+std::optional<bool> compare(const BinaryOp::Op op, const T &left, const T &right) {
+    switch (op) {
+        case BinaryOp::EQ: return left == right;
+        case BinaryOp::NEQ: return left != right;
+        case BinaryOp::LT: return left < right;
+        case BinaryOp::LTE: return left <= right;
+        case BinaryOp::GT: return left > right;
+        case BinaryOp::GTE: return left >= right;
+        default: return std::nullopt;
+    }
+}
+
+bool fits_integer(const int64_t value) {
+    return value >= std::numeric_limits<int32_t>::min() && value <= std::numeric_limits<int32_t>::max();
+}
+
+// INTEGER values are 32 bits at run time (and in storage), BIGINT values 64. A result that does not fit its type
+// would fail when evaluated, so it is not folded.
+std::optional<LiteralValue> integer_literal(const DataType type, const int64_t value) {
+    if (type == DataType::INTEGER && !fits_integer(value)) {
+        return std::nullopt;
+    }
+    return LiteralValue{type, value};
+}
+
+// Type of an integer operand. The parser tags every integer literal INTEGER; one too wide for 32 bits is a BIGINT,
+// as a bare literal of that size is in PostgreSQL.
+DataType integer_type(const LiteralValue &literal, const int64_t value) {
+    return literal.type == DataType::BIGINT || !fits_integer(value) ? DataType::BIGINT : DataType::INTEGER;
+}
+
+std::optional<LiteralValue> fold_integers(const BinaryOp::Op op, const int64_t left, const int64_t right,
+                                          const DataType type) {
+    int64_t result = 0;
+    switch (op) {
+        case BinaryOp::PLUS:
+            if (__builtin_add_overflow(left, right, &result)) return std::nullopt;
+            break;
+        case BinaryOp::MINUS:
+            if (__builtin_sub_overflow(left, right, &result)) return std::nullopt;
+            break;
+        case BinaryOp::MUL:
+            if (__builtin_mul_overflow(left, right, &result)) return std::nullopt;
+            break;
+        case BinaryOp::DIV:
+        case BinaryOp::MOD:
+            if (right == 0 || (left == INT64_MIN && right == -1)) return std::nullopt;
+            result = op == BinaryOp::DIV ? left / right : left % right; // Both truncate toward zero, as in SQL
+            break;
+        default:
+            if (const std::optional<bool> truth = compare(op, left, right)) return LiteralValue::Boolean(*truth);
+            return std::nullopt;
+    }
+    return integer_literal(type, result);
+}
+
+std::optional<LiteralValue> fold_doubles(const BinaryOp::Op op, const double left, const double right) {
+    double result = 0;
+    switch (op) {
+        case BinaryOp::PLUS: result = left + right; break;
+        case BinaryOp::MINUS: result = left - right; break;
+        case BinaryOp::MUL: result = left * right; break;
+        case BinaryOp::DIV:
+            if (right == 0) return std::nullopt;
+            result = left / right;
+            break;
+        default:
+            if (const std::optional<bool> truth = compare(op, left, right)) return LiteralValue::Boolean(*truth);
+            return std::nullopt;
+    }
+    if (!std::isfinite(result)) return std::nullopt;
+    return LiteralValue::Double(result);
+}
+
+std::optional<LiteralValue> fold_binary(const BinaryOp::Op op, const LiteralValue &left, const LiteralValue &right) {
+    if (op == BinaryOp::AND || op == BinaryOp::OR) {
+        const auto *l = std::get_if<bool>(&left.value);
+        const auto *r = std::get_if<bool>(&right.value);
+        if ((!l && !is_null(left)) || (!r && !is_null(right))) return std::nullopt;
+        // The dominant value (FALSE for AND, TRUE for OR) wins even over NULL
+        const bool dominant = op == BinaryOp::OR;
+        if ((l && *l == dominant) || (r && *r == dominant)) return LiteralValue::Boolean(dominant);
+        if (!l || !r) return LiteralValue::Null();
+        return LiteralValue::Boolean(!dominant);
+    }
+    if (is_null(left) || is_null(right)) {
+        return LiteralValue::Null();
+    }
+
+    const auto *li = std::get_if<int64_t>(&left.value);
+    const auto *ri = std::get_if<int64_t>(&right.value);
+    if (li && ri) {
+        const DataType type = integer_type(left, *li) == DataType::BIGINT || integer_type(right, *ri) == DataType::BIGINT
+                                      ? DataType::BIGINT
+                                      : DataType::INTEGER;
+        return fold_integers(op, *li, *ri, type);
+    }
+    const auto *ld = std::get_if<double>(&left.value);
+    const auto *rd = std::get_if<double>(&right.value);
+    if ((li || ld) && (ri || rd)) {
+        return fold_doubles(op, ld ? *ld : static_cast<double>(*li), rd ? *rd : static_cast<double>(*ri));
+    }
+
+    // Text ordering depends on the collation, so only equality of strings is decided here
+    const auto *ls = std::get_if<std::string>(&left.value);
+    const auto *rs = std::get_if<std::string>(&right.value);
+    if (ls && rs && (op == BinaryOp::EQ || op == BinaryOp::NEQ)) {
+        return LiteralValue::Boolean((*ls == *rs) == (op == BinaryOp::EQ));
+    }
+    const auto *lb = std::get_if<bool>(&left.value);
+    const auto *rb = std::get_if<bool>(&right.value);
+    if (lb && rb && (op == BinaryOp::EQ || op == BinaryOp::NEQ)) {
+        return LiteralValue::Boolean((*lb == *rb) == (op == BinaryOp::EQ));
+    }
+    return std::nullopt;
+}
+
+std::optional<LiteralValue> fold_unary(const UnaryOp::Op op, const LiteralValue &operand) {
+    switch (op) {
+        case UnaryOp::IS_NULL: return LiteralValue::Boolean(is_null(operand));
+        case UnaryOp::IS_NOT_NULL: return LiteralValue::Boolean(!is_null(operand));
+        default: break;
+    }
+    if (is_null(operand)) {
+        return LiteralValue::Null();
+    }
+    if (op == UnaryOp::NOT) {
+        if (const auto *boolean = std::get_if<bool>(&operand.value)) return LiteralValue::Boolean(!*boolean);
+        return std::nullopt;
+    }
+    if (const auto *integer = std::get_if<int64_t>(&operand.value)) {
+        if (*integer == INT64_MIN) return std::nullopt;
+        return integer_literal(integer_type(operand, *integer), -*integer);
+    }
+    if (const auto *number = std::get_if<double>(&operand.value)) {
+        return LiteralValue::Double(-*number);
+    }
+    return std::nullopt;
+}
+
+std::optional<bool> parse_boolean(std::string_view text) {
+    text = trim(text);
+    std::string lower(text);
+    std::ranges::transform(lower, lower.begin(), [](const char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; });
+    if (lower == "t" || lower == "true" || lower == "y" || lower == "yes" || lower == "on" || lower == "1") return true;
+    if (lower == "f" || lower == "false" || lower == "n" || lower == "no" || lower == "off" || lower == "0") return false;
+    return std::nullopt;
+}
+
+std::optional<LiteralValue> fold_cast(const LiteralValue &operand, const DataType target) {
+    if (is_null(operand)) {
+        return LiteralValue::Null();
+    }
+    const auto *integer = std::get_if<int64_t>(&operand.value);
+    const auto *number = std::get_if<double>(&operand.value);
+    const auto *boolean = std::get_if<bool>(&operand.value);
+    const auto *text = std::get_if<std::string>(&operand.value);
+
+    switch (target) {
+        case DataType::INTEGER:
+        case DataType::BIGINT: {
+            if (integer) return integer_literal(target, *integer);
+            if (boolean) return LiteralValue{target, int64_t{*boolean}};
+            if (number) {
+                // Round half to even, like the run-time cast; 2^63 itself is already out of range
+                const double rounded = std::nearbyint(*number);
+                if (!(rounded >= -0x1p63 && rounded < 0x1p63)) return std::nullopt;
+                return integer_literal(target, static_cast<int64_t>(rounded));
+            }
+            const std::string_view digits = trim(*text);
+            int64_t value = 0;
+            const char *end = digits.data() + digits.size();
+            if (const auto [ptr, ec] = std::from_chars(digits.data(), end, value); ec != std::errc{} || ptr != end) {
+                return std::nullopt;
+            }
+            return integer_literal(target, value);
+        }
+        case DataType::DOUBLE: {
+            if (integer) return LiteralValue::Double(static_cast<double>(*integer));
+            if (number) return operand;
+            if (boolean) return std::nullopt;
+            const std::string_view digits = trim(*text);
+            double value = 0;
+            const char *end = digits.data() + digits.size();
+            if (const auto [ptr, ec] = std::from_chars(digits.data(), end, value); ec != std::errc{} || ptr != end) {
+                return std::nullopt;
+            }
+            return LiteralValue::Double(value);
+        }
+        case DataType::TEXT:
+        case DataType::VARCHAR: {
+            if (text) return LiteralValue{target, *text};
+            if (boolean) return LiteralValue{target, std::string(*boolean ? "true" : "false")};
+            if (integer) return LiteralValue{target, std::to_string(*integer)};
+            char buffer[32];
+            const auto [ptr, ec] = std::to_chars(std::begin(buffer), std::end(buffer), *number); // Shortest round trip
+            return LiteralValue{target, std::string(buffer, ptr)};
+        }
+        case DataType::BOOLEAN: {
+            if (boolean) return operand;
+            if (integer) return LiteralValue::Boolean(*integer != 0);
+            if (text) {
+                if (const std::optional<bool> value = parse_boolean(*text)) return LiteralValue::Boolean(*value);
+            }
+            return std::nullopt;
+        }
+        default:
+            return std::nullopt; // DATE and TIMESTAMP literals are not parsed yet
+    }
+}
+
+// Identities that drop one operand of a binary node. Returns the operand that survives, if any.
+Expr *simplify_binary(BinaryOp &binary) {
+    Expr &left = binary.left;
+    Expr &right = binary.right;
+    switch (binary.op) {
+        case BinaryOp::PLUS:
+            if (is_integer_literal(right, 0)) return &left;
+            if (is_integer_literal(left, 0)) return &right;
+            break;
+        case BinaryOp::MINUS:
+            if (is_integer_literal(right, 0)) return &left;
+            break;
+        case BinaryOp::MUL:
+            if (is_integer_literal(right, 1)) return &left;
+            if (is_integer_literal(left, 1)) return &right;
+            break;
+        case BinaryOp::DIV:
+            if (is_integer_literal(right, 1)) return &left;
+            break;
+        case BinaryOp::AND:
+        case BinaryOp::OR: {
+            const bool dominant = binary.op == BinaryOp::OR;
+            if (is_boolean_literal(right, dominant)) return &right;
+            if (is_boolean_literal(left, dominant)) return &left;
+            if (is_boolean_literal(right, !dominant)) return &left;
+            if (is_boolean_literal(left, !dominant)) return &right;
+            break;
+        }
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+// Rewrite one node whose children are already folded. Returns true if `expr` was replaced.
+bool fold_node(Expr &expr) {
+    std::optional<LiteralValue> folded;
+    Expr *survivor = nullptr;
+
+    if (const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(&expr)) {
+        BinaryOp &node = **binary;
+        const LiteralValue *left = as_literal(node.left);
+        const LiteralValue *right = as_literal(node.right);
+        if (left && right) {
+            folded = fold_binary(node.op, *left, *right);
+        } else {
+            survivor = simplify_binary(node);
+        }
+    } else if (const auto *unary = std::get_if<std::unique_ptr<UnaryOp>>(&expr)) {
+        if (const Expression *operand = (*unary)->operand.get()) {
+            if (const LiteralValue *literal = as_literal(*operand)) folded = fold_unary((*unary)->op, *literal);
+        }
+    } else if (const auto *cast = std::get_if<std::unique_ptr<CastExpr>>(&expr)) {
+        if (const Expression *operand = (*cast)->expr.get()) {
+            if (const LiteralValue *literal = as_literal(*operand)) folded = fold_cast(*literal, (*cast)->target_type);
+        }
+    }
+
+    // Move the result out before assigning, since assigning to `expr` destroys the node that owns it
+    if (folded) {
+        expr = std::move(*folded);
+        return true;
+    }
+    if (survivor) {
+        Expr kept = std::move(*survivor);
+        expr = std::move(kept);
+        return true;
+    }
+    return false;
+}
+
+// Post-order over an explicit stack, so that arbitrarily deep trees (long chains of AND or +) cannot overflow the
+// call stack. A node is pushed once to schedule its children and once more, below them, to be folded after them.
+size_t fold(Expr &root) {
+    struct Step {
+        Expr *expr;
+        bool children_done;
+    };
+    std::vector<Step> stack{{&root, false}};
+    size_t rewrites = 0;
+    while (!stack.empty()) {
+        const Step step = stack.back();
+        stack.pop_back();
+        if (step.children_done) {
+            rewrites += fold_node(*step.expr);
+            continue;
+        }
+        Expr &expr = *step.expr;
+        stack.push_back({&expr, true});
+        if (const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(&expr)) {
+            stack.push_back({&(*binary)->right, false});
+            stack.push_back({&(*binary)->left, false});
+        } else if (const auto *unary = std::get_if<std::unique_ptr<UnaryOp>>(&expr)) {
+            if (Expression *operand = (*unary)->operand.get()) stack.push_back({operand, false});
+        } else if (const auto *cast = std::get_if<std::unique_ptr<CastExpr>>(&expr)) {
+            if (Expression *operand = (*cast)->expr.get()) stack.push_back({operand, false});
+        } else if (const auto *call = std::get_if<std::unique_ptr<FunctionCall>>(&expr)) {
+            for (auto arg = (*call)->args.rbegin(); arg != (*call)->args.rend(); ++arg) stack.push_back({&*arg, false});
+        }
+    }
+    return rewrites;
+}
+
+} // namespace
+
+size_t fold_constants(Expr &expr) {
+    return fold(expr);
+}
+
+size_t fold_constants(Statement &statement) {
+    size_t rewrites = 0;
+    for_each_expr_root(statement, [&rewrites](Expr &root) { rewrites += fold(root); });
+    return rewrites;
+}
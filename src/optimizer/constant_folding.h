@@ -0,0 +1,46 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_CONSTANT_FOLDING_H
+#define FLUXO_DB_CONSTANT_FOLDING_H
+#pragma once
+#include "../ast/ast_statements.h"
+#include <cstddef>
+
+// Constant folding and algebraic simplification, run once per statement before it is executed or cached.
+//
+// Folded: BinaryOp, UnaryOp and CastExpr nodes whose operands are all literals, bottom-up, so 1 + 2 * 3 becomes 7 and
+// CAST('5' AS INTEGER) becomes 5. NULL propagates through arithmetic and comparisons, AND / OR follow three-valued
+// logic, and integer arithmetic is int64 with BIGINT winning over INTEGER and DOUBLE over both.
+// A node whose evaluation would fail at run time is left as it is, so the error is still raised when (and if) the
+// executor evaluates it: integer overflow, division by zero, a non-finite double result, or a cast that does not
+// convert.
+//
+// Simplified: x + 0, 0 + x, x - 0, x * 1, 1 * x and x / 1 become x when the constant is an integer literal, which
+// keeps the result type of any numeric x; x AND TRUE and x OR FALSE become x, x AND FALSE becomes FALSE and x OR TRUE
+// becomes TRUE. x * 0 is kept, since it is NULL rather than 0 when x is NULL.
+//
+// Both overloads return the number of nodes rewritten.
+size_t fold_constants(Expr &expr);
+size_t fold_constants(Statement &statement);
+
+#endif //FLUXO_DB_CONSTANT_FOLDING_H
@@ -0,0 +1,147 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "parallel_parser.h"
+#include "statement_splitter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Chunks are at least this large, so small scripts do not pay for threads they cannot use
+constexpr size_t min_chunk_bytes = 64 * 1024;
+// Chunks per worker; more than one evens out chunks whose statements are unusually expensive to parse
+constexpr size_t chunks_per_worker = 4;
+
+struct Chunk {
+    std::string_view text;
+    int line;
+    int column;
+};
+
+std::vector<Chunk> split_into_chunks(const std::string_view script, const size_t target_bytes) {
+    std::vector<Chunk> chunks;
+    size_t start = 0;
+    size_t position = 0;
+    bool in_string = false;
+    int line = 1;
+    int column = 1;
+    while (start < script.length()) {
+        size_t end = start;
+        while (end - start < target_bytes) {
+            const size_t statement_end = find_statement_end(script, position, in_string);
+            if (statement_end == std::string_view::npos) {
+                end = script.length();
+                break;
+            }
+            end = statement_end;
+        }
+        const std::string_view text = script.substr(start, end - start);
+        chunks.push_back(Chunk{text, line, column});
+        advance_script_position(text, line, column);
+        start = end;
+    }
+    return chunks;
+}
+
+} // namespace
+
+std::expected<std::vector<Statement>, ParseError> try_parse_parallel(const std::string_view script, size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t target_bytes = std::max(min_chunk_bytes, script.length() / (threads * chunks_per_worker) + 1);
+    const std::vector<Chunk> chunks = split_into_chunks(script, target_bytes);
+
+    std::vector<std::optional<std::expected<std::vector<Statement>, ParseError>>> results(chunks.size());
+    std::atomic<size_t> next_chunk{0};
+    // The earliest chunk known to fail; later chunks cannot contribute to the result and are skipped
+    std::atomic<size_t> first_failed{chunks.size()};
+    std::exception_ptr worker_exception;
+    std::atomic_flag exception_taken;
+
+    const auto work = [&] {
+        try {
+            while (true) {
+                const size_t i = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                if (i >= chunks.size()) {
+                    break;
+                }
+                if (i > first_failed.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+                const Chunk &chunk = chunks[i];
+                Lexer lexer(chunk.text, borrow_input, chunk.line, chunk.column);
+                Parser parser(lexer);
+                results[i] = parser.try_parse();
+                if (!*results[i]) {
+                    size_t failed = first_failed.load(std::memory_order_relaxed);
+                    while (i < failed && !first_failed.compare_exchange_weak(failed, i, std::memory_order_relaxed)) {
+                    }
+                }
+            }
+        } catch (...) {
+            if (!exception_taken.test_and_set()) {
+                worker_exception = std::current_exception();
+            }
+            next_chunk.store(chunks.size(), std::memory_order_relaxed);
+        }
+    };
+
+    const size_t workers = std::min(threads, chunks.size());
+    {
+        std::vector<std::jthread> pool;
+        for (size_t w = 1; w < workers; ++w) {
+            pool.emplace_back(work);
+        }
+        work(); // The calling thread takes a share as well
+    }
+    if (worker_exception) {
+        std::rethrow_exception(worker_exception);
+    }
+
+    std::vector<Statement> statements;
+    for (auto &result : results) {
+        if (!result) {
+            break; // Skipped because an earlier chunk failed
+        }
+        if (!*result) {
+            return std::unexpected(std::move(result->error()));
+        }
+        std::ranges::move(**result, std::back_inserter(statements));
+    }
+    return statements;
+}
+
+std::vector<Statement> parse_parallel(const std::string_view script, const size_t threads) {
+    std::expected<std::vector<Statement>, ParseError> statements = try_parse_parallel(script, threads);
+    if (!statements) {
+        throw std::runtime_error(statements.error().to_string());
+    }
+    return std::move(*statements);
+}
@@ -0,0 +1,43 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_PARALLEL_PARSER_H
+#define FLUXO_DB_PARALLEL_PARSER_H
+#pragma once
+#include "parser.h"
+#include <cstddef>
+#include <expected>
+#include <string_view>
+#include <vector>
+
+// Parsing of a large in-memory script on several threads. A sequential pre-scan cuts the script at top-level
+// semicolons into chunks of whole statements; workers then lex and parse the chunks independently, each starting
+// from the script position of its chunk. Statements come back in script order, and both they and any error (the
+// first one in script order, with its line and column in the whole script) are identical to a sequential parse.
+
+// `threads` == 0 uses std::thread::hardware_concurrency()
+std::expected<std::vector<Statement>, ParseError> try_parse_parallel(std::string_view script, size_t threads = 0);
+
+// Same as try_parse_parallel(), but a syntax error is thrown as std::runtime_error exactly like Parser::parse()
+std::vector<Statement> parse_parallel(std::string_view script, size_t threads = 0);
+
+#endif //FLUXO_DB_PARALLEL_PARSER_H
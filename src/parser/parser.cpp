@@ -20,10 +20,13 @@
 // Created by mikai on 27.12.2025.
 //
 #include "parser.h"
+#include "trace.h"
 
 #include <algorithm>
-#include <iostream>
+#include <charconv>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
 
 static int get_precedence(const TokenType type) {
     switch (type) {
@@ -44,7 +47,7 @@ static int get_precedence(const TokenType type) {
     }
 }
 
-static BinaryOp::Op token_to_binop(const TokenType type) {
+static std::optional<BinaryOp::Op> token_to_binop(const TokenType type) {
     switch (type) {
         case TokenType::PLUS:
             return BinaryOp::Op::PLUS;
@@ -59,7 +62,7 @@ static BinaryOp::Op token_to_binop(const TokenType type) {
         case TokenType::PERCENT:
             return BinaryOp::Op::MOD;
         default:
-            throw std::runtime_error("Unknown binary operator token");
+            return std::nullopt;
     }
 }
 
@@ -69,13 +72,9 @@ int64_t Parser::determine_sign() {
     return sign;
 }
 
-static std::string errMsg(const Token& token, const std::string& msg) {
-    return msg + " at line " + std::to_string(token.line) + ", column " + std::to_string(token.column);
-}
-
-static DataType token_to_data_type(const Token& token) {
+static std::optional<DataType> token_to_data_type(const Token& token) {
     if (token.type == TokenType::IDENTIFIER) {
-        std::string type_name = token.literal;
+        std::string type_name(token.literal);
         std::ranges::transform(type_name, type_name.begin(), ::toupper);
 
         if (type_name == "INT" || type_name == "INTEGER") {
@@ -100,44 +99,50 @@ static DataType token_to_data_type(const Token& token) {
             return DataType::DATE;
         }
     }
-    throw std::runtime_error("Unknown data type: " + token.literal + "at line: " +
-        std::to_string(token.line) + ", column: " +
-        std::to_string(token.column));
+    return std::nullopt;
 }
 
 Parser::Parser(Lexer &lexer) : lexer_(lexer) {
-    // Tokenize the entire input upfront
-    Token token = lexer_.NextToken();
-    while (token.type != TokenType::EOF_TOKEN) {
-        tokens.push_back(token);
-        token = lexer_.NextToken();
-    }
-    tokens.push_back(token); // Add EOF token
-    current_token_ = tokens[0];
 }
 
-// Current token without advancing
-Token Parser::current() const {
-    if (position < tokens.size()) { // Check boundaries
-        return tokens[position];
+// Token at an absolute index, lexing up to it if needed. Past the end of input, and after a syntax error, this is the
+// EOF token.
+const Token &Parser::token_at(const size_t index) {
+    if (error_) [[unlikely]] {
+        return poisoned_;
+    }
+    // A grammar bug, not bad input: checked in every build, since an evicted slot would silently hold a later token
+    if (index + lookahead_capacity < lexed_) [[unlikely]] {
+        throw std::logic_error("Parser read token " + std::to_string(index) + " after it left the lookahead ring");
     }
-    return Token{TokenType::EOF_TOKEN, "", -1, -1};
+    while (lexed_ <= index && !lexer_done_) {
+        Token &slot = ring_[lexed_ % lookahead_capacity];
+        slot = lexer_.NextToken();
+        lexer_done_ = slot.type == TokenType::EOF_TOKEN;
+        lexed_++;
+    }
+    if (index >= lexed_) {
+        return ring_[(lexed_ - 1) % lookahead_capacity]; // The EOF token
+    }
+    return ring_[index % lookahead_capacity];
+}
+
+// Current token without advancing
+const Token &Parser::current() {
+    return token_at(position);
 }
 
 // Advance to the next token and return the current one
-Token Parser::advance() {
-    if (position < tokens.size()) { // Check boundaries
-        return tokens[position++];
-    }
-    return Token{TokenType::EOF_TOKEN, "", -1, -1};
+const Token &Parser::advance() {
+    return token_at(position++);
 }
 
 // Peek at a token ahead without advancing
-Token Parser::peek(const size_t offset) const {
-    if (const size_t peekPosition = position + offset; peekPosition < tokens.size()) { // Check boundaries
-        return tokens[peekPosition];
+const Token &Parser::peek(const size_t offset) {
+    if (offset + 1 >= lookahead_capacity) [[unlikely]] {
+        throw std::logic_error("Parser peeked " + std::to_string(offset) + " tokens ahead, past the lookahead ring");
     }
-    return Token{TokenType::EOF_TOKEN, "", -1, -1};
+    return token_at(position + offset);
 }
 
 // Match the current token type and advance if it matches
@@ -149,31 +154,108 @@ bool Parser::match(const TokenType type) {
     return false;
 }
 
-// Expect a specific token type, throw an error if it doesn't match
-Token Parser::expect(const TokenType type, const std::string& error_msg) {
+// Expect a specific token type and record a syntax error if it doesn't match.
+// The message is a static string; the position is only formatted into it once a mismatch actually happens.
+const Token &Parser::expect(const TokenType type, const char *error_msg) {
     if (match(type)) {
-        return tokens[position - 1]; // Return the matched token
+        return token_at(position - 1); // Return the matched token
+    }
+    fail(current(), error_msg);
+    return current();
+}
+
+// Record a syntax error at `token`; only the first error of a parse is kept. This is the only place error text is
+// built, so successful steps pay nothing for it.
+// Nothing is thrown: from here on every token reads as EOF, so each grammar rule falls through its normal end-of-input
+// paths and the caller checks error_ once the statement returns.
+void Parser::fail(const Token &token, const std::string_view message) {
+    if (error_) {
+        return;
+    }
+    const SourceLocation where = lexer_.location(token.offset);
+    poisoned_ = Token{TokenType::EOF_TOKEN, token.literal.substr(0, 0), token.offset};
+    error_ = ParseError{std::string(message), where.line, where.column};
+}
+
+std::string ParseError::to_string() const {
+    return message + " at line " + std::to_string(line) + ", column " + std::to_string(column);
+}
+
+// Convert a NUMBER token to an integer; fractional or out-of-range text is a syntax error
+int64_t Parser::parse_integer(const Token &token) {
+    int64_t value = 0;
+    const char *end = token.literal.data() + token.literal.size();
+    if (const auto [ptr, ec] = std::from_chars(token.literal.data(), end, value); ec != std::errc{} || ptr != end) {
+        fail(token, "Invalid integer " + std::string(token.literal));
+        return 0;
+    }
+    return value;
+}
+
+// Consume a type name and map it to a DataType
+DataType Parser::parse_data_type() {
+    const Token &type_token = advance();
+    if (const std::optional<DataType> type = token_to_data_type(type_token)) {
+        return *type;
     }
-    throw std::runtime_error(error_msg + " at line " +
-        std::to_string(current().line) + ", column " +
-        std::to_string(current().column));
+    fail(type_token, "Unknown data type: " + std::string(type_token.literal));
+    return DataType::NULL_TYPE;
 }
 
 // Check if we've reached the end of the token stream
-bool Parser::is_end() const {
+bool Parser::is_end() {
     return current().type == TokenType::EOF_TOKEN;
 }
 
 std::vector<Statement> Parser::parse() {
+    std::expected<std::vector<Statement>, ParseError> statements = try_parse();
+    if (!statements) {
+        throw std::runtime_error(statements.error().to_string());
+    }
+    return std::move(*statements);
+}
+
+std::expected<std::vector<Statement>, ParseError> Parser::try_parse() {
     std::vector<Statement> statements;
     while (!is_end()) {
-        statements.push_back(parse_statement());
+        Statement statement = parse_statement();
+        if (error_) {
+            return std::unexpected(*error_);
+        }
+        statements.push_back(std::move(statement));
         match(TokenType::SEMICOLON);
     }
     return statements;
 }
 
+std::optional<Statement> Parser::next_statement() {
+    if (is_end()) {
+        return std::nullopt;
+    }
+    Statement statement = parse_statement();
+    if (error_) {
+        throw std::runtime_error(error_->to_string());
+    }
+    match(TokenType::SEMICOLON);
+    return statement;
+}
+
+std::optional<ArenaStatement> Parser::next_arena_statement() {
+    auto arena = std::make_unique<AstArena>();
+    std::optional<Statement> statement;
+    {
+        AstArena::Scope scope(*arena);
+        statement = next_statement();
+    }
+    if (!statement) {
+        return std::nullopt;
+    }
+    return ArenaStatement{std::move(arena), std::move(*statement)};
+}
+
 Statement Parser::parse_statement() {
+    parameter_count_ = 0;
+    positional_parameters_ = 0;
     if (match(TokenType::SELECT)) {
         return parse_select_stmt();
     }
@@ -181,7 +263,7 @@ Statement Parser::parse_statement() {
         return parse_insert_stmt();
     }
     if (match(TokenType::CREATE)) {
-        return parse_create_table_stmt();
+        return parse_create_stmt();
     }
     if (match(TokenType::DROP)) {
         return parse_drop_stmt();
@@ -189,9 +271,8 @@ Statement Parser::parse_statement() {
     if (match(TokenType::ALTER)) {
         return parse_alter_table_stmt();
     }
-    throw std::runtime_error("Unsupported statement type at line " +
-        std::to_string(current().line) + ", column " +
-        std::to_string(current().column));
+    fail(current(), "Unsupported statement type");
+    return SelectStmt{};
 }
 
 SelectStmt Parser::parse_select_stmt() {
@@ -210,8 +291,8 @@ SelectStmt Parser::parse_select_stmt() {
     // 2. Parse FROM clause
     if (match(TokenType::FROM)) {
         do {
-            const Token table_token = expect(TokenType::IDENTIFIER, "Expected table name after FROM");
-            TableRef table_ref{table_token.literal, std::nullopt};
+            const Token &table_token = expect(TokenType::IDENTIFIER, "Expected table name after FROM");
+            TableRef table_ref{Symbol(table_token.literal), std::nullopt};
             stmt.from.push_back(table_ref);
         } while (match(TokenType::COMMA));
     }
@@ -224,50 +305,193 @@ SelectStmt Parser::parse_select_stmt() {
     return stmt;
 }
 
+// Bring the typed buffer of `column` up to `rows` slots; the padding slots belong to NULL rows
+static void pad_column(ColumnBuffer &column, const size_t rows) {
+    switch (column.type) {
+        case DataType::DOUBLE:
+            column.doubles.resize(rows);
+            break;
+        case DataType::TEXT:
+            column.string_offsets.resize(rows + 1, static_cast<uint32_t>(column.string_data.size()));
+            break;
+        case DataType::NULL_TYPE:
+            break;
+        default:
+            column.integers.resize(rows);
+            break;
+    }
+}
+
+// Turn the rows collected in `bulk` back into expressions: complete rows go to `rows`, the first `partial_cells`
+// cells of the row being read go to `partial_row`. Used once a VALUES list turns out not to be all literals.
+static void materialize_bulk(const BulkValues &bulk, std::vector<std::vector<Expr>> &rows,
+                             std::vector<Expr> &partial_row, const size_t partial_cells) {
+    rows.reserve(bulk.row_count + 1);
+    for (size_t row = 0; row < bulk.row_count; ++row) {
+        std::vector<Expr> &values = rows.emplace_back();
+        values.reserve(bulk.columns.size());
+        for (const ColumnBuffer &column : bulk.columns) {
+            values.push_back(column.literal(row));
+        }
+    }
+    for (size_t cell = 0; cell < partial_cells; ++cell) {
+        partial_row.push_back(bulk.columns[cell].literal(bulk.row_count));
+    }
+}
+
+// Append the current token to column `cell` of the row being read, provided it is a literal that makes up the whole
+// cell. A minus sign directly before a number is folded into the cell, as constant folding would fold the negation.
+// Returns false without consuming anything when the cell needs the general expression parser: it is not a lone
+// literal, it does not match the column's literal type, it widens the row, or the number does not convert.
+bool Parser::append_bulk_cell(BulkValues &bulk, const size_t cell) {
+    const bool negative = current().type == TokenType::MINUS && peek().type == TokenType::NUMBER;
+    const Token &token = negative ? peek() : current();
+    if (const TokenType next = peek(negative ? 2 : 1).type; next != TokenType::COMMA && next != TokenType::RPAREN) {
+        return false;
+    }
+    DataType type;
+    switch (token.type) {
+        case TokenType::NUMBER:
+            type = token.literal.find('.') != std::string_view::npos ? DataType::DOUBLE : DataType::INTEGER;
+            break;
+        case TokenType::STRING: type = DataType::TEXT; break;
+        case TokenType::TRUE:
+        case TokenType::FALSE: type = DataType::BOOLEAN; break;
+        case TokenType::NULL_TYPE: type = DataType::NULL_TYPE; break;
+        default: return false;
+    }
+
+    const size_t row = bulk.row_count;
+    if (cell >= bulk.columns.size()) {
+        if (row > 0) {
+            return false;
+        }
+        bulk.columns.emplace_back();
+    }
+    ColumnBuffer &column = bulk.columns[cell];
+    if (type != DataType::NULL_TYPE && type != column.type) {
+        if (column.type != DataType::NULL_TYPE) {
+            return false;
+        }
+        column.type = type;
+    }
+
+    const char *begin = token.literal.data();
+    const char *end = begin + token.literal.size();
+    switch (type) {
+        case DataType::INTEGER: {
+            int64_t value = 0;
+            if (const auto [ptr, ec] = std::from_chars(begin, end, value); ec != std::errc{} || ptr != end) {
+                return false;
+            }
+            pad_column(column, row);
+            column.integers.push_back(negative ? -value : value);
+            break;
+        }
+        case DataType::DOUBLE: {
+            double value = 0;
+            if (const auto [ptr, ec] = std::from_chars(begin, end, value); ec != std::errc{} || ptr != end) {
+                return false;
+            }
+            pad_column(column, row);
+            column.doubles.push_back(negative ? -value : value);
+            break;
+        }
+        case DataType::TEXT:
+            pad_column(column, row);
+            column.string_data.append(token.literal);
+            column.string_offsets.push_back(static_cast<uint32_t>(column.string_data.size()));
+            break;
+        case DataType::BOOLEAN:
+            pad_column(column, row);
+            column.integers.push_back(token.type == TokenType::TRUE ? 1 : 0);
+            break;
+        default:
+            column.nulls.resize(std::max(column.nulls.size(), row / 64 + 1));
+            column.nulls[row / 64] |= uint64_t{1} << (row % 64);
+            break;
+    }
+    if (negative) {
+        advance();
+    }
+    advance();
+    return true;
+}
+
 InsertStmt Parser::parse_insert_stmt() {
     InsertStmt stmt;
 
     // Expect: INTO table_name
-    expect(TokenType::INSERT, "Expected INSERT keyword at line " +
-        std::to_string(current().line) + ", column " +
-        std::to_string(current().column));
-    const Token table_token = expect(TokenType::IDENTIFIER, "Expected table name after INSERT");
+    expect(TokenType::INTO, "Expected INTO keyword after INSERT");
+    const Token &table_token = expect(TokenType::IDENTIFIER, "Expected table name after INSERT");
     stmt.table_name = table_token.literal;
 
     // Expect: (column1, column2, ...)
     if (match(TokenType::LPAREN)) {
         do {
-            Token col = expect(TokenType::IDENTIFIER, "Expected column name in INSERT");
-            stmt.columns.push_back(col.literal);
+            const Token &col = expect(TokenType::IDENTIFIER, "Expected column name in INSERT");
+            stmt.columns.emplace_back(col.literal);
         } while (match(TokenType::COMMA));
-        expect(TokenType::VALUES, "Expected VALUES keyword after column list in INSERT");
+        expect(TokenType::RPAREN, "Expected ')' after column list in INSERT");
     }
+    expect(TokenType::VALUES, "Expected VALUES keyword in INSERT");
     // Parse list of values: (1, 'a'), (2, 'b'), ...
+    // Rows of plain literals go straight into column buffers. The first cell that is anything else moves the rows
+    // read so far into `values` and the rest of the list takes the general expression path.
+    BulkValues bulk;
+    bool columnar = true;
     do {
         expect(TokenType::LPAREN, "Expected '(' before values list");
         std::vector<Expr> value_row;
+        size_t cells = 0;
         do {
+            if (columnar && append_bulk_cell(bulk, cells)) {
+                cells++;
+                continue;
+            }
+            if (columnar) {
+                materialize_bulk(bulk, stmt.values, value_row, cells);
+                columnar = false;
+            }
             value_row.push_back(parse_expression());
+            cells++;
         } while (match(TokenType::COMMA));
         expect(TokenType::RPAREN, "Expected ')' after values list");
-        stmt.values.push_back(std::move(value_row));
+
+        if (columnar && cells != bulk.columns.size()) {
+            // Narrower than the first row
+            materialize_bulk(bulk, stmt.values, value_row, cells);
+            columnar = false;
+        }
+        if (columnar) {
+            bulk.row_count++;
+        } else {
+            stmt.values.push_back(std::move(value_row));
+        }
     } while (match(TokenType::COMMA));
+
+    if (columnar && !error_) {
+        for (ColumnBuffer &column : bulk.columns) {
+            pad_column(column, bulk.row_count);
+        }
+        stmt.bulk = std::move(bulk);
+    }
     return stmt;
 }
 
 AlterTableStmt Parser::parse_alter_table_stmt() {
     AlterTableStmt stmt;
 
-    expect(TokenType::TABLE, errMsg(current(), "Expected TABLE keyword after ALTER"));
+    expect(TokenType::TABLE, "Expected TABLE keyword after ALTER");
 
     // Parse optional IF EXISTS
     if (match(TokenType::IF)) {
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after IF in ALTER TABLE"));
+        expect(TokenType::EXISTS, "Expected EXISTS after IF in ALTER TABLE");
         stmt.if_exists = true;
     }
 
     // Parse table name
-    const Token table_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected table name after ALTER TABLE"));
+    const Token &table_token = expect(TokenType::IDENTIFIER, "Expected table name after ALTER TABLE");
     stmt.table_name = table_token.literal;
 
     do {
@@ -296,9 +520,8 @@ AlterAction Parser::parse_alter_table_action() {
     if (match(TokenType::OWNER)) {
         return parse_owner_to_action();
     }
-    throw std::runtime_error("Unknown ALTER TABLE action at line " +
-                             std::to_string(current().line) + ", column " +
-                             std::to_string(current().column));
+    fail(current(), "Unknown ALTER TABLE action");
+    return AddAction{};
 }
 
 AddAction Parser::parse_add_action() {
@@ -308,60 +531,53 @@ AddAction Parser::parse_add_action() {
 
         // Parse optional IF NOT EXISTS
         if (match(TokenType::IF)) {
-            expect(TokenType::NOT, errMsg(current(), "Expected NOT after IF in ADD COLUMN"));
-            expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after NOT in ADD COLUMN"));
+            expect(TokenType::NOT, "Expected NOT after IF in ADD COLUMN");
+            expect(TokenType::EXISTS, "Expected EXISTS after NOT in ADD COLUMN");
             action.if_not_exists = true;
         }
 
-        const Token col_name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name after ADD COLUMN"));
+        const Token &col_name_token = expect(TokenType::IDENTIFIER, "Expected column name after ADD COLUMN");
         action.column_def.name = col_name_token.literal;
 
-        const Token type_token = advance();
-        action.column_def.type = token_to_data_type(type_token);
+        action.column_def.type = parse_data_type();
 
         // Parse optional constraints
         while (current().type != TokenType::COMMA && current().type != TokenType::SEMICOLON && current().type != TokenType::EOF_TOKEN) {
             if (match(TokenType::NOT)) {
-                expect(TokenType::NULL_TYPE, errMsg(current(), "Expected NULL after NOT in column constraint"));
+                expect(TokenType::NULL_TYPE, "Expected NULL after NOT in column constraint");
                 action.column_def.not_null = true;
             } else if (match(TokenType::UNIQUE)) {
                 action.column_def.unique = true;
             } else if (match(TokenType::PRIMARY)) {
-                expect(TokenType::KEY, errMsg(current(), "Expected KEY after PRIMARY in column constraint"));
+                expect(TokenType::KEY, "Expected KEY after PRIMARY in column constraint");
                 action.column_def.primary_key = true;
             } else {
-                throw std::runtime_error("Unknown column constraint in ADD COLUMN at line " +
-                    std::to_string(current().line) + ", column " +
-                    std::to_string(current().column));
+                fail(current(), "Unknown column constraint in ADD COLUMN");
             }
         }
         add_action.emplace<AddColumnAction>(action);
     } else if (match(TokenType::CONSTRAINT)) {
         AddConstraintAction action;
-        const Token col_name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name after ADD CONSTRAINT"));
+        const Token &col_name_token = expect(TokenType::IDENTIFIER, "Expected column name after ADD CONSTRAINT");
         action.column_name = col_name_token.literal;
 
         // Parse constraints
         while (current().type != TokenType::COMMA && current().type != TokenType::SEMICOLON && current().type != TokenType::EOF_TOKEN) {
             if (match(TokenType::NOT)) {
-                expect(TokenType::NULL_TYPE, errMsg(current(), "Expected NULL after NOT in constraint"));
+                expect(TokenType::NULL_TYPE, "Expected NULL after NOT in constraint");
                 action.not_null = true;
             } else if (match(TokenType::UNIQUE)) {
                 action.unique = true;
             } else if (match(TokenType::PRIMARY)) {
-                expect(TokenType::KEY, errMsg(current(), "Expected KEY after PRIMARY in constraint"));
+                expect(TokenType::KEY, "Expected KEY after PRIMARY in constraint");
                 action.primary_key = true;
             } else {
-                throw std::runtime_error("Unknown constraint in ADD CONSTRAINT at line " +
-                    std::to_string(current().line) + ", column " +
-                    std::to_string(current().column));
+                fail(current(), "Unknown constraint in ADD CONSTRAINT");
             }
         }
         add_action.emplace<AddConstraintAction>(action);
     } else {
-        throw std::runtime_error("Expected COLUMN or CONSTRAINT after ADD in ALTER TABLE at line " +
-            std::to_string(current().line) + ", column " +
-            std::to_string(current().column));
+        fail(current(), "Expected COLUMN or CONSTRAINT after ADD in ALTER TABLE");
     }
     return add_action;
 }
@@ -373,11 +589,11 @@ DropAction Parser::parse_drop_action() {
 
         // Parse optional IF EXISTS
         if (match(TokenType::IF)) {
-            expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after IF in DROP COLUMN"));
+            expect(TokenType::EXISTS, "Expected EXISTS after IF in DROP COLUMN");
             action.if_exists = true;
         }
 
-        const Token col_name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name after DROP COLUMN"));
+        const Token &col_name_token = expect(TokenType::IDENTIFIER, "Expected column name after DROP COLUMN");
         action.column_name = col_name_token.literal;
 
         // Parse optional CASCADE
@@ -391,11 +607,11 @@ DropAction Parser::parse_drop_action() {
 
         // Parse optional IF EXISTS
         if (match(TokenType::IF)) {
-            expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after IF in DROP CONSTRAINT"));
+            expect(TokenType::EXISTS, "Expected EXISTS after IF in DROP CONSTRAINT");
             action.if_exists = true;
         }
 
-        const Token constraint_name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected constraint name after DROP CONSTRAINT"));
+        const Token &constraint_name_token = expect(TokenType::IDENTIFIER, "Expected constraint name after DROP CONSTRAINT");
         action.constraint_name = constraint_name_token.literal;
 
         // Parse optional CASCADE
@@ -405,9 +621,7 @@ DropAction Parser::parse_drop_action() {
 
         drop_action.emplace<DropConstraintAction>(action);
     } else {
-        throw std::runtime_error("Expected COLUMN or CONSTRAINT after DROP in ALTER TABLE at line " +
-            std::to_string(current().line) + ", column " +
-            std::to_string(current().column));
+        fail(current(), "Expected COLUMN or CONSTRAINT after DROP in ALTER TABLE");
     }
     return drop_action;
 }
@@ -415,16 +629,15 @@ DropAction Parser::parse_drop_action() {
 AlterColumnAction Parser::parse_alter_column_action() {
     AlterColumnAction alter_column_action;
 
-    expect(TokenType::COLUMN, errMsg(current(), "Expected COLUMN after ALTER in ALTER TABLE"));
-    const Token col_name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name after ALTER COLUMN"));
-    const std::string column_name = col_name_token.literal;
+    expect(TokenType::COLUMN, "Expected COLUMN after ALTER in ALTER TABLE");
+    const Token &col_name_token = expect(TokenType::IDENTIFIER, "Expected column name after ALTER COLUMN");
+    const Symbol column_name(col_name_token.literal);
 
     if (match(TokenType::TYPE)) {
         AlterColumnTypeAction action;
         action.column_name = column_name;
 
-        const Token type_token = advance();
-        action.new_type = token_to_data_type(type_token);
+        action.new_type = parse_data_type();
 
         // Optional USING expression
         if (match(TokenType::USING)) {
@@ -433,7 +646,7 @@ AlterColumnAction Parser::parse_alter_column_action() {
 
         // Optional COLLATE
         if (match(TokenType::COLLATE)) {
-            const Token collation_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected collation name after COLLATE"));
+            const Token &collation_token = expect(TokenType::IDENTIFIER, "Expected collation name after COLLATE");
             action.collation = collation_token.literal;
         }
 
@@ -445,7 +658,7 @@ AlterColumnAction Parser::parse_alter_column_action() {
             action.default_expr = parse_expression();
             alter_column_action.emplace<AlterColumnDefaultAction>(std::move(action));
         } else if (match(TokenType::NOT)) {
-            expect(TokenType::NULL_TYPE, errMsg(current(), "Expected NULL after NOT in ALTER COLUMN"));
+            expect(TokenType::NULL_TYPE, "Expected NULL after NOT in ALTER COLUMN");
             AlterColumnNotNullAction action;
             action.column_name = column_name;
             action.set_not_null = true;
@@ -458,7 +671,7 @@ AlterColumnAction Parser::parse_alter_column_action() {
             action.is_drop = true;
             alter_column_action.emplace<AlterColumnDefaultAction>(std::move(action));
         } else if (match(TokenType::NOT)) {
-            expect(TokenType::NULL_TYPE, errMsg(current(), "Expected NULL after NOT in ALTER COLUMN"));
+            expect(TokenType::NULL_TYPE, "Expected NULL after NOT in ALTER COLUMN");
             AlterColumnNotNullAction action;
             action.column_name = column_name;
             action.set_not_null = false;
@@ -473,15 +686,15 @@ RenameAction Parser::parse_rename_action() {
 
     if (match(TokenType::COLUMN)) {
         RenameColumnAction action;
-        action.old_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected old column name after RENAME COLUMN")).literal;
-        expect(TokenType::TO, errMsg(current(), "Expected TO after old column name in RENAME COLUMN"));
-        action.new_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected new column name after TO in RENAME COLUMN")).literal;
+        action.old_name = expect(TokenType::IDENTIFIER, "Expected old column name after RENAME COLUMN").literal;
+        expect(TokenType::TO, "Expected TO after old column name in RENAME COLUMN");
+        action.new_name = expect(TokenType::IDENTIFIER, "Expected new column name after TO in RENAME COLUMN").literal;
         rename_action.emplace<RenameColumnAction>(action);
     } else if (match(TokenType::CONSTRAINT)) {
         RenameConstraintAction action;
-        action.old_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected old constraint name after RENAME CONSTRAINT")).literal;
-        expect(TokenType::TO, errMsg(current(), "Expected TO after old constraint name in RENAME CONSTRAINT"));
-        action.new_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected new constraint name after TO in RENAME CONSTRAINT")).literal;
+        action.old_name = expect(TokenType::IDENTIFIER, "Expected old constraint name after RENAME CONSTRAINT").literal;
+        expect(TokenType::TO, "Expected TO after old constraint name in RENAME CONSTRAINT");
+        action.new_name = expect(TokenType::IDENTIFIER, "Expected new constraint name after TO in RENAME CONSTRAINT").literal;
         rename_action.emplace<RenameConstraintAction>(action);
     } else {
         // Assume RENAME [TO] new_name for table
@@ -489,7 +702,7 @@ RenameAction Parser::parse_rename_action() {
         if(current().type == TokenType::TO) {
             advance();
         }
-        action.new_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected new table name after TO in RENAME TABLE")).literal;
+        action.new_name = expect(TokenType::IDENTIFIER, "Expected new table name after TO in RENAME TABLE").literal;
         rename_action.emplace<RenameTableAction>(action);
     }
     return rename_action;
@@ -497,16 +710,16 @@ RenameAction Parser::parse_rename_action() {
 
 SetSchemaAction Parser::parse_set_schema_action() {
     SetSchemaAction action;
-    expect(TokenType::SCHEMA, errMsg(current(), "Expected SCHEMA after SET in ALTER TABLE"));
-    const Token schema_name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected schema name after SET SCHEMA"));
+    expect(TokenType::SCHEMA, "Expected SCHEMA after SET in ALTER TABLE");
+    const Token &schema_name_token = expect(TokenType::IDENTIFIER, "Expected schema name after SET SCHEMA");
     action.schema_name = schema_name_token.literal;
     return action;
 }
 
 OwnerToAction Parser::parse_owner_to_action() {
     OwnerToAction action;
-    expect(TokenType::TO, errMsg(current(), "Expected TO after OWNER in ALTER TABLE"));
-    const Token new_owner_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected new owner name after TO in SET OWNER"));
+    expect(TokenType::TO, "Expected TO after OWNER in ALTER TABLE");
+    const Token &new_owner_token = expect(TokenType::IDENTIFIER, "Expected new owner name after TO in SET OWNER");
     action.new_owner = new_owner_token.literal;
     return action;
 }
@@ -527,9 +740,8 @@ DropStmt Parser::parse_drop_stmt() {
         case TokenType::USER: stmt.object_type = ObjectType::USER; break;
         case TokenType::TYPE: stmt.object_type = ObjectType::TYPE; break;
         default:
-            throw std::runtime_error("Unknown object type in DROP statement at line " +
-                std::to_string(current().line) + ", column " +
-                std::to_string(current().column));
+            fail(current(), "Unknown object type in DROP statement");
+            return stmt;
     }
     advance(); // Consume the object type keyword
 
@@ -539,14 +751,14 @@ DropStmt Parser::parse_drop_stmt() {
 
     // Parse optional IF EXISTS
     if (match(TokenType::IF)) {
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after IF in DROP statement"));
+        expect(TokenType::EXISTS, "Expected EXISTS after IF in DROP statement");
         stmt.if_exists = true;
     }
 
     // Parse object names
     do {
-        const Token name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected object name in DROP statement"));
-        stmt.names.push_back(name_token.literal);
+        const Token &name_token = expect(TokenType::IDENTIFIER, "Expected object name in DROP statement");
+        stmt.names.emplace_back(name_token.literal);
     } while (match(TokenType::COMMA));
 
     // Parse optional CASCADE or RESTRICT
@@ -588,9 +800,8 @@ CreateStmt Parser::parse_create_stmt() {
         case TokenType::ROLE:
             return parse_create_role_stmt();
         default:
-            throw std::runtime_error("Unknown object type in CREATE statement at line " +
-                std::to_string(current().line) + ", column " +
-                std::to_string(current().column));
+            fail(current(), "Unknown object type in CREATE statement");
+            return CreateTableStmt{};
     }
 }
 
@@ -598,27 +809,24 @@ ColumnDef Parser::parse_column_def() {
     ColumnDef column_def;
 
     // Name
-    const Token col_name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name in column definition"));
+    const Token &col_name_token = expect(TokenType::IDENTIFIER, "Expected column name in column definition");
     column_def.name = col_name_token.literal;
 
     // Type
-    const Token type_token = advance();
-    column_def.type = token_to_data_type(type_token);
+    column_def.type = parse_data_type();
 
     // Inline constraints
-    while (current().type != TokenType::COMMA && current().type != TokenType::RPAREN) {
+    while (current().type != TokenType::COMMA && current().type != TokenType::RPAREN && current().type != TokenType::EOF_TOKEN) {
         if (match(TokenType::NOT)) {
-            expect(TokenType::NULL_TYPE, errMsg(current(), "Expected NULL after NOT in column constraint"));
+            expect(TokenType::NULL_TYPE, "Expected NULL after NOT in column constraint");
             column_def.not_null = true;
         } else if (match(TokenType::UNIQUE)) {
             column_def.unique = true;
         } else if (match(TokenType::PRIMARY)) {
-            expect(TokenType::KEY, errMsg(current(), "Expected KEY after PRIMARY in column constraint"));
+            expect(TokenType::KEY, "Expected KEY after PRIMARY in column constraint");
             column_def.primary_key = true;
         } else {
-            throw std::runtime_error("Unknown column constraint in column definition at line " +
-                std::to_string(current().line) + ", column " +
-                std::to_string(current().column));
+            fail(current(), "Unknown column constraint in column definition");
         }
     }
     return column_def;
@@ -629,7 +837,7 @@ TableConstraint Parser::parse_table_constraint() {
 
     // Handle optional "CONSTRAINT <name>"
     if (match(TokenType::CONSTRAINT)) {
-        const Token name_token = expect(TokenType::IDENTIFIER, "Expected constraint name after CONSTRAINT");
+        const Token &name_token = expect(TokenType::IDENTIFIER, "Expected constraint name after CONSTRAINT");
         constraint.name = name_token.literal;
     }
 
@@ -637,58 +845,56 @@ TableConstraint Parser::parse_table_constraint() {
     switch (current().type) {
         case TokenType::PRIMARY: {
             advance();
-            expect(TokenType::KEY, errMsg(current(), "Expected KEY after PRIMARY in table constraint"));
+            expect(TokenType::KEY, "Expected KEY after PRIMARY in table constraint");
             constraint.type = TableConstraint::Type::PRIMARY_KEY;
 
-            expect(TokenType::LPAREN, errMsg(current(), "Expected '(' after PRIMARY KEY in table constraint"));
+            expect(TokenType::LPAREN, "Expected '(' after PRIMARY KEY in table constraint");
             do {
-                constraint.columns.push_back(expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name in PRIMARY KEY constraint")).literal);
+                constraint.columns.emplace_back(expect(TokenType::IDENTIFIER, "Expected column name in PRIMARY KEY constraint").literal);
             } while (match(TokenType::COMMA));
-            expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after column list in PRIMARY KEY constraint"));
+            expect(TokenType::RPAREN, "Expected ')' after column list in PRIMARY KEY constraint");
             break;
         } case TokenType::UNIQUE: {
             advance();
             constraint.type = TableConstraint::Type::UNIQUE;
 
-            expect(TokenType::LPAREN, errMsg(current(), "Expected '(' after UNIQUE in table constraint"));
+            expect(TokenType::LPAREN, "Expected '(' after UNIQUE in table constraint");
             do {
-                constraint.columns.push_back(expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name in UNIQUE constraint")).literal);
+                constraint.columns.emplace_back(expect(TokenType::IDENTIFIER, "Expected column name in UNIQUE constraint").literal);
             } while (match(TokenType::COMMA));
-            expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after column list in UNIQUE constraint"));
+            expect(TokenType::RPAREN, "Expected ')' after column list in UNIQUE constraint");
             break;
         } case TokenType::FOREIGN: {
             advance();
-            expect(TokenType::KEY, errMsg(current(), "Expected KEY after FOREIGN in table constraint"));
+            expect(TokenType::KEY, "Expected KEY after FOREIGN in table constraint");
             constraint.type = TableConstraint::Type::FOREIGN_KEY;
 
-            expect(TokenType::LPAREN, errMsg(current(), "Expected '(' after FOREIGN KEY in table constraint"));
+            expect(TokenType::LPAREN, "Expected '(' after FOREIGN KEY in table constraint");
             do {
-                constraint.columns.push_back(expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name in FOREIGN KEY constraint")).literal);
+                constraint.columns.emplace_back(expect(TokenType::IDENTIFIER, "Expected column name in FOREIGN KEY constraint").literal);
             } while (match(TokenType::COMMA));
-            expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after column list in FOREIGN KEY constraint"));
+            expect(TokenType::RPAREN, "Expected ')' after column list in FOREIGN KEY constraint");
 
             // References
-            expect(TokenType::REFERENCES, errMsg(current(), "Expected REFERENCES in FOREIGN KEY constraint"));
-            constraint.foreign_table = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected referenced table name in FOREIGN KEY constraint")).literal;
+            expect(TokenType::REFERENCES, "Expected REFERENCES in FOREIGN KEY constraint");
+            constraint.foreign_table = expect(TokenType::IDENTIFIER, "Expected referenced table name in FOREIGN KEY constraint").literal;
 
-            expect(TokenType::LPAREN, errMsg(current(), "Expected '(' after referenced table name in FOREIGN KEY constraint"));
+            expect(TokenType::LPAREN, "Expected '(' after referenced table name in FOREIGN KEY constraint");
             do {
-                constraint.foreign_columns.push_back(expect(TokenType::IDENTIFIER, errMsg(current(), "Expected referenced column name in FOREIGN KEY constraint")).literal);
+                constraint.foreign_columns.emplace_back(expect(TokenType::IDENTIFIER, "Expected referenced column name in FOREIGN KEY constraint").literal);
             } while (match(TokenType::COMMA));
-            expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after referenced column list in FOREIGN KEY constraint"));
+            expect(TokenType::RPAREN, "Expected ')' after referenced column list in FOREIGN KEY constraint");
             break;
         } case TokenType::CHECK: {
             advance();
             constraint.type = TableConstraint::Type::CHECK;
-            expect(TokenType::LPAREN, errMsg(current(), "Expected '(' after CHECK in table constraint"));
+            expect(TokenType::LPAREN, "Expected '(' after CHECK in table constraint");
             constraint.check_expr = parse_expression();
-            expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after CHECK expression in table constraint"));
+            expect(TokenType::RPAREN, "Expected ')' after CHECK expression in table constraint");
             break;
         }
         default:
-            throw std::runtime_error("Unknown table constraint type at line " +
-                std::to_string(current().line) + ", column " +
-                std::to_string(current().column));
+            fail(current(), "Unknown table constraint type");
     }
     return constraint;
 }
@@ -696,27 +902,23 @@ TableConstraint Parser::parse_table_constraint() {
 CreateTableStmt Parser::parse_create_table_stmt() {
     CreateTableStmt stmt;
 
-    expect(TokenType::TABLE, errMsg(current(), "Expected TABLE keyword after CREATE"));
+    expect(TokenType::TABLE, "Expected TABLE keyword after CREATE");
 
     // Parse optional IF NOT EXISTS
     if (match(TokenType::IF)) {
-        expect(TokenType::NOT, errMsg(current(), "Expected NOT after IF in CREATE TABLE"));
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after NOT in CREATE TABLE"));
+        expect(TokenType::NOT, "Expected NOT after IF in CREATE TABLE");
+        expect(TokenType::EXISTS, "Expected EXISTS after NOT in CREATE TABLE");
         stmt.if_not_exists = true;
     }
 
     // Parse table name
-    const Token table_name_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected table name after CREATE TABLE"));
+    const Token &table_name_token = expect(TokenType::IDENTIFIER, "Expected table name after CREATE TABLE");
     stmt.table_name = table_name_token.literal;
 
-    bool first = true;
-    // Loop through comma-separated list of columns or constraints
-    while (current().type != TokenType::RPAREN && current().type != TokenType::EOF_TOKEN) {
-        if (!first) {
-            expect(TokenType::COMMA, errMsg(current(), "Expected ',' between table elements"));
-        }
-        first = false;
+    expect(TokenType::LPAREN, "Expected '(' after table name in CREATE TABLE");
 
+    // Comma-separated list of columns and table constraints
+    do {
         // Check if this is a table constraint
         if (const TokenType t = current().type;
             t == TokenType::CONSTRAINT ||
@@ -728,33 +930,24 @@ CreateTableStmt Parser::parse_create_table_stmt() {
         } else {
             stmt.columns.push_back(parse_column_def());
         }
+    } while (match(TokenType::COMMA));
 
-        expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after table definition"));
-        return stmt;
-    }
-
-    // Parse table constraints
-    while (current().type != TokenType::RPAREN) {
-        stmt.constraints.push_back(parse_table_constraint());
-        match(TokenType::COMMA);
-    }
-
-    expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after column definitions in CREATE TABLE"));
+    expect(TokenType::RPAREN, "Expected ')' after column definitions in CREATE TABLE");
     return stmt;
 }
 
 CreateRoleStmt Parser::parse_create_role_stmt() {
     CreateRoleStmt stmt;
 
-    expect(TokenType::ROLE, errMsg(current(), "Expected ROLE keyword after CREATE"));
+    expect(TokenType::ROLE, "Expected ROLE keyword after CREATE");
 
     if (match(TokenType::IF)) {
-        expect(TokenType::NOT, errMsg(current(), "Expected NOT after IF in CREATE ROLE"));
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after NOT in CREATE ROLE"));
+        expect(TokenType::NOT, "Expected NOT after IF in CREATE ROLE");
+        expect(TokenType::EXISTS, "Expected EXISTS after NOT in CREATE ROLE");
         stmt.if_not_exists = true;
     }
 
-    stmt.role_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected role name after CREATE ROLE")).literal;
+    stmt.role_name = expect(TokenType::IDENTIFIER, "Expected role name after CREATE ROLE").literal;
 
     if (match(TokenType::WITH)) {
         while (current().type != TokenType::SEMICOLON && current().type != TokenType::EOF_TOKEN) {
@@ -774,29 +967,25 @@ CreateRoleStmt Parser::parse_create_role_stmt() {
                     if (match(TokenType::NULL_TYPE)) {
                         stmt.password = std::nullopt;
                     } else {
-                        const Token pwd_token = expect(TokenType::STRING, errMsg(current(), "Expected password string after PASSWORD in CREATE ROLE"));
+                        const Token &pwd_token = expect(TokenType::STRING, "Expected password string after PASSWORD in CREATE ROLE");
                         stmt.password = pwd_token.literal;
                     }
                 } case TokenType::CONNECTION: {
                     advance();
-                    expect(TokenType::LIMIT, errMsg(current(), "Expected LIMIT after CONNECTION in CREATE ROLE"));
+                    expect(TokenType::LIMIT, "Expected LIMIT after CONNECTION in CREATE ROLE");
 
                     const int64_t sign = determine_sign();
 
-                    const Token limit_token = expect(TokenType::NUMBER, errMsg(current(), "Expected number after LIMIT in CREATE ROLE"));
-                    const int64_t limit_value = std::stoi(limit_token.literal);
+                    const Token &limit_token = expect(TokenType::NUMBER, "Expected number after LIMIT in CREATE ROLE");
+                    const int64_t limit_value = parse_integer(limit_token);
                     if (sign < 0 && limit_value != 1) {
-                        throw std::runtime_error("Connection limit cannot be less than -1 in CREATE ROLE at line " +
-                            std::to_string(limit_token.line) + ", column " +
-                            std::to_string(limit_token.column));
+                        fail(limit_token, "Connection limit cannot be less than -1 in CREATE ROLE");
                     }
                     stmt.conn_limit = limit_value * sign;
                     break;
                 }
                 default:
-                    throw std::runtime_error("Unknown option in CREATE ROLE at line " +
-                        std::to_string(current().line) + ", column " +
-                        std::to_string(current().column));
+                    fail(current(), "Unknown option in CREATE ROLE");
                     break;
             }
             advance(); // Consume the matched option
@@ -808,99 +997,91 @@ CreateRoleStmt Parser::parse_create_role_stmt() {
 CreateCollationStmt Parser::parse_create_collation_stmt() {
     CreateCollationStmt stmt;
 
-    expect(TokenType::COLLATION, errMsg(current(), "Expected COLLATION keyword after CREATE"));
+    expect(TokenType::COLLATION, "Expected COLLATION keyword after CREATE");
 
     if (match(TokenType::IF)) {
-        expect(TokenType::NOT, errMsg(current(), "Expected NOT after IF in CREATE COLLATION"));
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after NOT in CREATE COLLATION"));
+        expect(TokenType::NOT, "Expected NOT after IF in CREATE COLLATION");
+        expect(TokenType::EXISTS, "Expected EXISTS after NOT in CREATE COLLATION");
         stmt.if_not_exists = true;
     }
 
-    stmt.collation_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected collation name after CRATE COLLATION")).literal;
+    stmt.collation_name = expect(TokenType::IDENTIFIER, "Expected collation name after CRATE COLLATION").literal;
 
     if (match(TokenType::FROM)) {
-        stmt.existing_collation_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected collation name after FROM in CREATE COLLATION")).literal;
+        stmt.existing_collation_name = expect(TokenType::IDENTIFIER, "Expected collation name after FROM in CREATE COLLATION").literal;
         return stmt;
     }
 
     if (match(TokenType::LPAREN)) {
         do {
             if (match(TokenType::LOCALE)) {
-                expect(TokenType::EQUALS, errMsg(current(), "Expected '=' after LOCALE in CREATE COLLATION"));
-                stmt.locale = expect(TokenType::STRING, errMsg(current(), "Expected locale string after '=' in CREATE COLLATION")).literal;
+                expect(TokenType::EQUALS, "Expected '=' after LOCALE in CREATE COLLATION");
+                stmt.locale = expect(TokenType::STRING, "Expected locale string after '=' in CREATE COLLATION").literal;
             } else if (match(TokenType::DETERMINISTIC)) {
-                expect(TokenType::EQUALS, errMsg(current(), "Expected '=' after DETERMINISTIC in CREATE COLLATION"));
+                expect(TokenType::EQUALS, "Expected '=' after DETERMINISTIC in CREATE COLLATION");
 
-                const Token bool_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected boolean value after '=' in CREATE COLLATION"));
-                std::string bool_str = bool_token.literal;
+                const Token &bool_token = expect(TokenType::IDENTIFIER, "Expected boolean value after '=' in CREATE COLLATION");
+                std::string bool_str(bool_token.literal);
                 std::ranges::transform(bool_str, bool_str.begin(), ::toupper);
 
                 if (bool_str == "TRUE") stmt.deterministic = true;
                 else if (bool_str == "FALSE") stmt.deterministic = false;
-                else throw std::runtime_error("Expected TRUE or FALSE after '=' in CREATE COLLATION at line " +
-                        std::to_string(bool_token.line) + ", column " +
-                        std::to_string(bool_token.column));
+                else fail(bool_token, "Expected TRUE or FALSE after '=' in CREATE COLLATION");
             } else if (match(TokenType::RULES)) {
-                expect(TokenType::EQUALS, errMsg(current(), "Expected '=' after RULES in CREATE COLLATION"));
-                stmt.rules = expect(TokenType::STRING, errMsg(current(), "Expected rules string after '=' in CREATE COLLATION")).literal;
+                expect(TokenType::EQUALS, "Expected '=' after RULES in CREATE COLLATION");
+                stmt.rules = expect(TokenType::STRING, "Expected rules string after '=' in CREATE COLLATION").literal;
             } else if (match(TokenType::PROVIDER)) {
-                expect(TokenType::EQUALS, errMsg(current(), "Expected '=' after PROVIDER in CREATE COLLATION"));
-                stmt.provider = expect(TokenType::STRING, errMsg(current(), "Expected provider string after '=' in CREATE COLLATION")).literal;
+                expect(TokenType::EQUALS, "Expected '=' after PROVIDER in CREATE COLLATION");
+                stmt.provider = expect(TokenType::STRING, "Expected provider string after '=' in CREATE COLLATION").literal;
             } else {
-                throw std::runtime_error("Unknown option in CREATE COLLATION at line " +
-                    std::to_string(current().line) + ", column " +
-                    std::to_string(current().column));
+                fail(current(), "Unknown option in CREATE COLLATION");
             }
         } while (match(TokenType::COMMA)); // Continue if there is a comma
     }
-    expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after options in CREATE COLLATION"));
+    expect(TokenType::RPAREN, "Expected ')' after options in CREATE COLLATION");
     return stmt;
 }
 
 CreateDatabaseStmt Parser::parse_create_database_stmt() {
     CreateDatabaseStmt stmt;
 
-    expect(TokenType::DATABASE, errMsg(current(), "Expected DATABASE keyword after CREATE"));
+    expect(TokenType::DATABASE, "Expected DATABASE keyword after CREATE");
 
     if (match(TokenType::IF)) {
-        expect(TokenType::NOT, errMsg(current(), "Expected NOT after IF in CREATE DATABASE"));
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after NOT in CREATE DATABASE"));
+        expect(TokenType::NOT, "Expected NOT after IF in CREATE DATABASE");
+        expect(TokenType::EXISTS, "Expected EXISTS after NOT in CREATE DATABASE");
         stmt.if_not_exists = true;
     }
 
-    stmt.name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected database name after CREATE DATABASE")).literal;
+    stmt.name = expect(TokenType::IDENTIFIER, "Expected database name after CREATE DATABASE").literal;
 
     // Expected syntax:
     // CREATE DATABASE dbname ( OWNER = owner_name, ENCODING = 'encoding', ALLOW_CONNECTIONS = TRUE/FALSE, CONNECTION_LIMIT = number );
     if (match(TokenType::LPAREN)) {
         do {
             if (match(TokenType::OWNER)) {
-                expect(TokenType::EQUALS, errMsg(current(), "Expected '=' after OWNER in CREATE DATABASE"));
-                stmt.user_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected owner name after '=' in CREATE DATABASE")).literal;
+                expect(TokenType::EQUALS, "Expected '=' after OWNER in CREATE DATABASE");
+                stmt.user_name = expect(TokenType::IDENTIFIER, "Expected owner name after '=' in CREATE DATABASE").literal;
             } else if (match(TokenType::ENCODING)) {
-                expect(TokenType::EQUALS, errMsg(current(), "Expected '=' after ENCODING in CREATE DATABASE"));
-                stmt.encoding = expect(TokenType::STRING, errMsg(current(), "Expected encoding string after '=' in CREATE DATABASE")).literal;
+                expect(TokenType::EQUALS, "Expected '=' after ENCODING in CREATE DATABASE");
+                stmt.encoding = expect(TokenType::STRING, "Expected encoding string after '=' in CREATE DATABASE").literal;
             } else if (match(TokenType::ALLOW_CONNECTIONS)) {
-                expect(TokenType::EQUALS, errMsg(current(), "Expected '=' after TEMPLATE in CREATE DATABASE"));
-                const Token bool_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected template database name after '=' in CREATE DATABASE"));
-                std::string bool_str = bool_token.literal;
+                expect(TokenType::EQUALS, "Expected '=' after TEMPLATE in CREATE DATABASE");
+                const Token &bool_token = expect(TokenType::IDENTIFIER, "Expected template database name after '=' in CREATE DATABASE");
+                std::string bool_str(bool_token.literal);
                 std::ranges::transform(bool_str, bool_str.begin(), ::toupper);
                 if (bool_str == "TRUE") stmt.allow_conn = true;
                 else if (bool_str == "FALSE") stmt.allow_conn = false;
-                else throw std::runtime_error("Expected TRUE or FALSE after '=' in CREATE DATABASE at line " +
-                        std::to_string(bool_token.line) + ", column " +
-                        std::to_string(bool_token.column));
+                else fail(bool_token, "Expected TRUE or FALSE after '=' in CREATE DATABASE");
             } else if (match(TokenType::CONNECTION_LIMIT)) {
-                expect(TokenType::EQUALS, errMsg(current(), "Expected '=' after CONNECTION LIMIT in CREATE DATABASE"));
-                stmt.conn_limit = std::stoi(expect(TokenType::NUMBER, errMsg(current(), "Expected connection limit number after '=' in CREATE DATABASE")).literal);
+                expect(TokenType::EQUALS, "Expected '=' after CONNECTION LIMIT in CREATE DATABASE");
+                stmt.conn_limit = parse_integer(expect(TokenType::NUMBER, "Expected connection limit number after '=' in CREATE DATABASE"));
             } else {
-                throw std::runtime_error("Unknown option in CREATE DATABASE at line " +
-                    std::to_string(current().line) + ", column " +
-                    std::to_string(current().column));
+                fail(current(), "Unknown option in CREATE DATABASE");
             }
         } while (match(TokenType::COMMA));
     }
-    expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after options in CREATE DATABASE"));
+    expect(TokenType::RPAREN, "Expected ')' after options in CREATE DATABASE");
     return stmt;
 }
 
@@ -910,31 +1091,31 @@ CreateIndexStmt Parser::parse_create_index_stmt() {
     if (match(TokenType::UNIQUE)) {
         stmt.unique = true;
     }
-    expect(TokenType::INDEX, errMsg(current(), "Expected INDEX keyword in CREATE INDEX"));
+    expect(TokenType::INDEX, "Expected INDEX keyword in CREATE INDEX");
 
     if (match(TokenType::CONCURRENTLY)) {
         stmt.concurrently = true;
     }
 
     if (match(TokenType::IF)) {
-        expect(TokenType::NOT, errMsg(current(), "Expected NOT after IF in CREATE INDEX"));
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after NOT in CREATE INDEX"));
+        expect(TokenType::NOT, "Expected NOT after IF in CREATE INDEX");
+        expect(TokenType::EXISTS, "Expected EXISTS after NOT in CREATE INDEX");
         stmt.if_not_exists = true;
     }
 
-    stmt.index_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected index name in CREATE INDEX")).literal;
+    stmt.index_name = expect(TokenType::IDENTIFIER, "Expected index name in CREATE INDEX").literal;
 
-    expect(TokenType::ON, errMsg(current(), "Expected ON keyword in CREATE INDEX"));
+    expect(TokenType::ON, "Expected ON keyword in CREATE INDEX");
     if (match(TokenType::ONLY)) {
         stmt.only = true;
     }
-    stmt.table_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected table name in CREATE INDEX")).literal;
+    stmt.table_name = expect(TokenType::IDENTIFIER, "Expected table name in CREATE INDEX").literal;
 
     if (match(TokenType::USING)) {
-        stmt.method = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected index method name after USING in CREATE INDEX")).literal;
+        stmt.method = expect(TokenType::IDENTIFIER, "Expected index method name after USING in CREATE INDEX").literal;
     }
 
-    expect(TokenType::LPAREN, errMsg(current(), "Expected '(' before index columns in CREATE INDEX"));
+    expect(TokenType::LPAREN, "Expected '(' before index columns in CREATE INDEX");
     do {
         IndexElem elem;
 
@@ -947,11 +1128,11 @@ CreateIndexStmt Parser::parse_create_index_stmt() {
         }
 
         if (match(TokenType::COLLATE)) {
-            elem.collation = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected collation name after COLLATE in index element")).literal;
+            elem.collation = expect(TokenType::IDENTIFIER, "Expected collation name after COLLATE in index element").literal;
         }
 
         if (current().type == TokenType::IDENTIFIER) {
-            elem.op_class = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected operator class name in index element")).literal;
+            elem.op_class = expect(TokenType::IDENTIFIER, "Expected operator class name in index element").literal;
         }
 
         if (match(TokenType::ASC)) {
@@ -966,21 +1147,20 @@ CreateIndexStmt Parser::parse_create_index_stmt() {
             } else if (match(TokenType::LAST)) {
                 elem.nulls_first = false;
             } else {
-                throw std::runtime_error("Expected FIRST or LAST after NULLS in index element at line " +
-                    std::to_string(current().line) + ", column " +
-                    std::to_string(current().column));
+                fail(current(), "Expected FIRST or LAST after NULLS in index element");
             }
         }
 
         stmt.params.push_back(std::move(elem));
     } while (match(TokenType::COMMA)); // comma separated list of columns
+    expect(TokenType::RPAREN, "Expected ')' after index columns in CREATE INDEX");
 
     if (match(TokenType::WHERE)) {
         stmt.where = parse_expression();
     }
 
     if (match(TokenType::TABLESPACE)) {
-        stmt.tablespace = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected tablespace name after TABLESPACE in CREATE INDEX")).literal;
+        stmt.tablespace = expect(TokenType::IDENTIFIER, "Expected tablespace name after TABLESPACE in CREATE INDEX").literal;
     }
 
     return stmt;
@@ -989,21 +1169,19 @@ CreateIndexStmt Parser::parse_create_index_stmt() {
 CreateTriggerStmt Parser::parse_create_trigger_stmt() {
     CreateTriggerStmt stmt;
 
-    expect(TokenType::TRIGGER, errMsg(current(), "Expected TRIGGER keyword in CREATE TRIGGER"));
+    expect(TokenType::TRIGGER, "Expected TRIGGER keyword in CREATE TRIGGER");
 
-    stmt.trigger_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected trigger name in CREATE TRIGGER")).literal;
+    stmt.trigger_name = expect(TokenType::IDENTIFIER, "Expected trigger name in CREATE TRIGGER").literal;
 
     if (match(TokenType::BEFORE)) {
         stmt.timing = TriggerTiming::BEFORE;
     } else if (match(TokenType::AFTER)) {
         stmt.timing = TriggerTiming::AFTER;
     } else if (match(TokenType::INSTEAD)){
-        expect(TokenType::OF, errMsg(current(), "Expected OF after INSTEAD in CREATE TRIGGER"));
+        expect(TokenType::OF, "Expected OF after INSTEAD in CREATE TRIGGER");
         stmt.timing = TriggerTiming::INSTEAD_OF;
     } else {
-        throw std::runtime_error("Expected trigger timing (BEFORE, AFTER, INSTEAD OF) in CREATE TRIGGER at line " +
-            std::to_string(current().line) + ", column " +
-            std::to_string(current().column));
+        fail(current(), "Expected trigger timing (BEFORE, AFTER, INSTEAD OF) in CREATE TRIGGER");
     }
 
     // Parse events
@@ -1015,7 +1193,10 @@ CreateTriggerStmt Parser::parse_create_trigger_stmt() {
             if (match(TokenType::OF)) {
                 // Parse optional column list for UPDATE OF
                 do {
-                    const Token col_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name after UPDATE OF in CREATE TRIGGER"));
+                    const Token &col_token = expect(TokenType::IDENTIFIER, "Expected column name after UPDATE OF in CREATE TRIGGER");
+                    if (!stmt.update_of_columns) {
+                        stmt.update_of_columns.emplace();
+                    }
                     stmt.update_of_columns->emplace_back(col_token.literal);
                 } while (match(TokenType::COMMA));
             }
@@ -1024,9 +1205,7 @@ CreateTriggerStmt Parser::parse_create_trigger_stmt() {
         } else if (match(TokenType::TRUNCATE)) {
             stmt.events.push_back(TriggerEvent::TRUNCATE);
         } else {
-            throw std::runtime_error("Expected trigger event (INSERT, UPDATE, DELETE, TRUNCATE) in CREATE TRIGGER at line " +
-                std::to_string(current().line) + ", column " +
-                std::to_string(current().column));
+            fail(current(), "Expected trigger event (INSERT, UPDATE, DELETE, TRUNCATE) in CREATE TRIGGER");
         }
     } while (match(TokenType::OR));
 
@@ -1037,29 +1216,25 @@ CreateTriggerStmt Parser::parse_create_trigger_stmt() {
             } else if (match(TokenType::STATEMENT)) {
                 stmt.for_each = TriggerForEach::STATEMENT;
             } else {
-                throw std::runtime_error("Expected ROW or STATEMENT after EACH in CREATE TRIGGER at line " +
-                    std::to_string(current().line) + ", column " +
-                    std::to_string(current().column));
+                fail(current(), "Expected ROW or STATEMENT after EACH in CREATE TRIGGER");
             }
         } else {
-            throw std::runtime_error("Expected EACH after FOR in CREATE TRIGGER at line " +
-                std::to_string(current().line) + ", column " +
-                std::to_string(current().column));
+            fail(current(), "Expected EACH after FOR in CREATE TRIGGER");
         }
     }
 
     if (match(TokenType::WHEN)) {
-        expect(TokenType::LPAREN, errMsg(current(), "Expected '(' after WHEN in CREATE TRIGGER"));
+        expect(TokenType::LPAREN, "Expected '(' after WHEN in CREATE TRIGGER");
         stmt.when = parse_expression();
-        expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after WHEN expression in CREATE TRIGGER"));
+        expect(TokenType::RPAREN, "Expected ')' after WHEN expression in CREATE TRIGGER");
     }
 
-    expect(TokenType::ON, errMsg(current(), "Expected ON keyword in CREATE TRIGGER"));
-    stmt.table_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected table name in CREATE TRIGGER")).literal;
+    expect(TokenType::ON, "Expected ON keyword in CREATE TRIGGER");
+    stmt.table_name = expect(TokenType::IDENTIFIER, "Expected table name in CREATE TRIGGER").literal;
 
-    expect(TokenType::EXECUTE, errMsg(current(), "Expected EXECUTE keyword in CREATE TRIGGER"));
-    expect(TokenType::FUNCTION, errMsg(current(), "Expected FUNCTION keyword in CREATE TRIGGER"));
-    stmt.function_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected function name in CREATE TRIGGER")).literal;
+    expect(TokenType::EXECUTE, "Expected EXECUTE keyword in CREATE TRIGGER");
+    expect(TokenType::FUNCTION, "Expected FUNCTION keyword in CREATE TRIGGER");
+    stmt.function_name = expect(TokenType::IDENTIFIER, "Expected function name in CREATE TRIGGER").literal;
     if (match(TokenType::LPAREN)) {
         // Parse function arguments
         if (current().type != TokenType::RPAREN) {
@@ -1067,7 +1242,7 @@ CreateTriggerStmt Parser::parse_create_trigger_stmt() {
                 stmt.function_args.push_back(parse_expression());
             } while (match(TokenType::COMMA));
         }
-        expect(TokenType::RPAREN, errMsg(current(), "Expected ')' after function arguments in CREATE TRIGGER"));
+        expect(TokenType::RPAREN, "Expected ')' after function arguments in CREATE TRIGGER");
     }
     return stmt;
 }
@@ -1079,39 +1254,39 @@ CreateSequenceStmt Parser::parse_create_sequence_stmt() {
         stmt.temporary = true;
     }
 
-    expect(TokenType::SEQUENCE, errMsg(current(), "Expected SEQUENCE keyword in CREATE SEQUENCE"));
+    expect(TokenType::SEQUENCE, "Expected SEQUENCE keyword in CREATE SEQUENCE");
     if (match(TokenType::IF)) {
-        expect(TokenType::NOT, errMsg(current(), "Expected NOT after IF in CREATE SEQUENCE"));
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after NOT in CREATE SEQUENCE"));
+        expect(TokenType::NOT, "Expected NOT after IF in CREATE SEQUENCE");
+        expect(TokenType::EXISTS, "Expected EXISTS after NOT in CREATE SEQUENCE");
         stmt.if_not_exists = true;
     }
 
-    stmt.sequence_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected sequence name after CREATE SEQUENCE")).literal;
+    stmt.sequence_name = expect(TokenType::IDENTIFIER, "Expected sequence name after CREATE SEQUENCE").literal;
 
     while (current().type != TokenType::SEMICOLON && current().type != TokenType::EOF_TOKEN) {
         switch (current().type) {
             case TokenType::INCREMENT:{
                 advance(); // consume INCREMENT
-                expect(TokenType::BY, errMsg(current(), "Expected BY after INCREMENT in CREATE SEQUENCE"));
+                expect(TokenType::BY, "Expected BY after INCREMENT in CREATE SEQUENCE");
 
                 const int64_t sign = determine_sign();
 
-                const Token inc_token = expect(TokenType::NUMBER, errMsg(current(), "Expected number after INCREMENT BY in CREATE SEQUENCE"));
-                stmt.increment_by = std::stoi(inc_token.literal) * sign;
+                const Token &inc_token = expect(TokenType::NUMBER, "Expected number after INCREMENT BY in CREATE SEQUENCE");
+                stmt.increment_by = parse_integer(inc_token) * sign;
                 break;
             } case TokenType::MINVALUE: {
                 advance();
                 int64_t sign = determine_sign();
 
-                const Token min_token = expect(TokenType::NUMBER, errMsg(current(), "Expected number after MINVALUE in CREATE SEQUENCE"));
-                stmt.min_value = std::stoi(min_token.literal) * sign;
+                const Token &min_token = expect(TokenType::NUMBER, "Expected number after MINVALUE in CREATE SEQUENCE");
+                stmt.min_value = parse_integer(min_token) * sign;
                 break;
             } case TokenType::MAXVALUE: {
                 advance();
                 int64_t sign = determine_sign();
 
-                const Token max_token = expect(TokenType::NUMBER, errMsg(current(), "Expected number after MAXVALUE in CREATE SEQUENCE"));
-                stmt.max_value = std::stoi(max_token.literal) * sign;
+                const Token &max_token = expect(TokenType::NUMBER, "Expected number after MAXVALUE in CREATE SEQUENCE");
+                stmt.max_value = parse_integer(max_token) * sign;
                 break;
             } case TokenType::CYCLE: {
                 advance();
@@ -1119,43 +1294,39 @@ CreateSequenceStmt Parser::parse_create_sequence_stmt() {
                 break;
             } case TokenType::START: {
                 advance();
-                expect(TokenType::WITH, errMsg(current(), "Expected WITH after START in CREATE SEQUENCE"));
+                expect(TokenType::WITH, "Expected WITH after START in CREATE SEQUENCE");
 
                 const int64_t sign = determine_sign();
 
-                const Token start_token = expect(TokenType::NUMBER, errMsg(current(), "Expected number after START WITH in CREATE SEQUENCE"));
-                stmt.start_value = std::stoi(start_token.literal) * sign;
+                const Token &start_token = expect(TokenType::NUMBER, "Expected number after START WITH in CREATE SEQUENCE");
+                stmt.start_value = parse_integer(start_token) * sign;
                 break;
             } case TokenType::CACHE: {
                 advance();
-                const Token cache_token = expect(TokenType::NUMBER, errMsg(current(), "Expected number after CACHE in CREATE SEQUENCE"));
-                stmt.cache_size = std::stoi(cache_token.literal);
+                const Token &cache_token = expect(TokenType::NUMBER, "Expected number after CACHE in CREATE SEQUENCE");
+                stmt.cache_size = parse_integer(cache_token);
                 break;
             } case TokenType::NO: {
                 advance();
                 if (match(TokenType::CYCLE)) stmt.cycle = false;
                 else if (match(TokenType::MINVALUE)) stmt.min_value = std::nullopt;
                 else if (match(TokenType::MAXVALUE)) stmt.max_value = std::nullopt;
-                else throw std::runtime_error("Expected CYCLE, MINVALUE, or MAXVALUE after NO in CREATE SEQUENCE at line " +
-                    std::to_string(current().line) + ", column " +
-                    std::to_string(current().column));
+                else fail(current(), "Expected CYCLE, MINVALUE, or MAXVALUE after NO in CREATE SEQUENCE");
                 break;
             } case TokenType::OWNED: {
                 advance();
-                expect(TokenType::BY, errMsg(current(), "Expected BY after OWNED in CREATE SEQUENCE"));
+                expect(TokenType::BY, "Expected BY after OWNED in CREATE SEQUENCE");
                 if (match(TokenType::NONE)) {
                     stmt.owner = std::nullopt;
                 } else {
-                    const Token table_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected table name after OWNED BY in CREATE SEQUENCE"));
-                    expect(TokenType::DOT, errMsg(current(), "Expected '.' between table and column name in OWNED BY in CREATE SEQUENCE"));
-                    const Token column_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected column name after '.' in OWNED BY in CREATE SEQUENCE"));
+                    const Token &table_token = expect(TokenType::IDENTIFIER, "Expected table name after OWNED BY in CREATE SEQUENCE");
+                    expect(TokenType::DOT, "Expected '.' between table and column name in OWNED BY in CREATE SEQUENCE");
+                    const Token &column_token = expect(TokenType::IDENTIFIER, "Expected column name after '.' in OWNED BY in CREATE SEQUENCE");
                     stmt.owner = std::make_pair(table_token.literal, column_token.literal);
                 }
                 break;
             } default: {
-                throw std::runtime_error("Unknown option in CREATE SEQUENCE at line " +
-                std::to_string(current().line) + ", column " +
-                std::to_string(current().column));
+                fail(current(), "Unknown option in CREATE SEQUENCE");
                 break;
             }
         }
@@ -1166,87 +1337,170 @@ CreateSequenceStmt Parser::parse_create_sequence_stmt() {
 CreateSchemaStmt Parser::parse_create_schema_stmt() {
     CreateSchemaStmt stmt;
 
-    expect(TokenType::SCHEMA, errMsg(current(), "Expected SCHEMA keyword after CREATE"));
+    expect(TokenType::SCHEMA, "Expected SCHEMA keyword after CREATE");
 
     if (match(TokenType::IF)) {
-        expect(TokenType::NOT, errMsg(current(), "Expected NOT after IF in CREATE SCHEMA"));
-        expect(TokenType::EXISTS, errMsg(current(), "Expected EXISTS after NOT in CREATE SCHEMA"));
+        expect(TokenType::NOT, "Expected NOT after IF in CREATE SCHEMA");
+        expect(TokenType::EXISTS, "Expected EXISTS after NOT in CREATE SCHEMA");
         stmt.if_not_exists = true;
     }
 
     if (match(TokenType::AUTHORIZATION)) {
-        const Token owner_token = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected owner name after AUTHORIZATION in CREATE SCHEMA"));
+        const Token &owner_token = expect(TokenType::IDENTIFIER, "Expected owner name after AUTHORIZATION in CREATE SCHEMA");
         stmt.authorization = owner_token.literal;
     }
 
-    stmt.schema_name = expect(TokenType::IDENTIFIER, errMsg(current(), "Expected schema name after CREATE SCHEMA")).literal;
-    // TODO: Parse schema elements (tables, views, etc.) if needed
+    stmt.schema_name = expect(TokenType::IDENTIFIER, "Expected schema name after CREATE SCHEMA").literal;
+
+    // Objects created along with the schema: CREATE SCHEMA s CREATE TABLE t (...) CREATE INDEX i ON t (...);
+    while (current().type == TokenType::CREATE) {
+        const Token create_token = current();
+        advance();
+        std::visit([&]<typename T>(T &&element) {
+            if constexpr (std::is_constructible_v<SchemaElement, T>) {
+                (stmt.schema_elements ? *stmt.schema_elements : stmt.schema_elements.emplace()).emplace_back(std::move(element));
+            } else {
+                fail(create_token, "Only tables, indexes, views, sequences and triggers can be created inside CREATE SCHEMA");
+            }
+        }, parse_create_stmt());
+    }
     return stmt;
 }
 
+// Precedence climbing over an explicit operator stack rather than the call stack, so neither long operator chains
+// nor deep parentheses or unary minus chains make the parser recurse. Equal precedence associates to the left, and
+// unary minus binds tighter than any binary operator: -a * b is (-a) * b.
 Expression Parser::parse_expression(const int precedence) {
-    // 1. Parse the left-hand side (primary expression)
-    Expression left = parse_primary();
+    const size_t base = pending_.size(); // Entries below belong to an enclosing call (a CAST operand)
+    size_t open_parens = 0;
+    Expression operand;
+
+    // Fold pending binary operators of at least `min` precedence, down to the innermost open parenthesis
+    const auto reduce = [&](const int min) {
+        while (pending_.size() > base && pending_.back().kind == PendingOperator::BINARY &&
+               pending_.back().precedence >= min) {
+            auto binOp = std::make_unique<BinaryOp>();
+            binOp->op = pending_.back().op;
+            binOp->left = std::move(pending_.back().left);
+            binOp->right = std::move(operand);
+            operand = std::move(binOp);
+            pending_.pop_back();
+        }
+    };
 
-    // 2. Precedence Climbing
+    bool want_operand = true;
     while (true) {
-        const Token token = current();
-        const int tok_precedence = get_precedence(token.type);
-        std::cout<< "Current token: " << token.literal << " with precedence " << tok_precedence << "\n";
-        std::cout << "Current token type: " << static_cast<int>(token.type) << "\n";
-
-        // If next token is not an operator or has lower precedence, stop
-        if (tok_precedence <= precedence) {
-            break;
+        if (want_operand) {
+            if (match(TokenType::LPAREN)) {
+                pending_.push_back({PendingOperator::PAREN});
+                ++open_parens;
+            } else if (match(TokenType::MINUS)) {
+                pending_.push_back({PendingOperator::NEGATE});
+            } else {
+                operand = parse_primary();
+                want_operand = false;
+            }
+            continue;
         }
 
-        // Consume the operator
-        advance();
-        const BinaryOp::Op op = token_to_binop(token.type);
+        while (pending_.size() > base && pending_.back().kind == PendingOperator::NEGATE) {
+            auto negate = std::make_unique<UnaryOp>();
+            negate->op = UnaryOp::MINUS;
+            negate->operand = std::make_unique<Expression>(std::move(operand));
+            operand = std::move(negate);
+            pending_.pop_back();
+        }
 
-        // Parse the right-hand side expression
-        Expression right = parse_expression(tok_precedence);
+        const Token &token = current();
+        const int tok_precedence = get_precedence(token.type);
+        FLUXO_PARSER_TRACE("parse_expression", token, tok_precedence);
 
-        // Create a new BinaryOp node
-        auto binOp = std::make_unique<BinaryOp>();
-        binOp->op = op;
-        binOp->left = std::move(left);
-        binOp->right = std::move(right);
+        // If next token is not an operator or has lower precedence, the innermost group ends here
+        if (tok_precedence <= (open_parens > 0 ? 0 : precedence)) {
+            if (open_parens == 0) {
+                break;
+            }
+            // A missing ')' is recorded and the group is closed anyway, so a poisoned parse still unwinds
+            expect(TokenType::RPAREN, "Expected ')'");
+            reduce(std::numeric_limits<int>::min());
+            pending_.pop_back(); // The PAREN entry
+            --open_parens;
+            continue;
+        }
 
-        // The result becomes the new 'left' for the next iteration
-        left = std::move(binOp);
+        const std::optional<BinaryOp::Op> op = token_to_binop(token.type);
+        if (!op) {
+            fail(token, "Unsupported operator " + std::string(token.literal));
+            continue; // Every token now reads as EOF, so the next pass closes the open groups
+        }
+        reduce(tok_precedence);
+        pending_.push_back({PendingOperator::BINARY, *op, tok_precedence, std::move(operand)});
+        advance();
+        want_operand = true;
     }
-    return left;
+    reduce(std::numeric_limits<int>::min());
+    return operand;
 }
 
 Expression Parser::parse_primary() {
-    switch (const auto [type, literal, line, column] = current(); type) {
+    switch (const auto &[type, literal, offset] = current(); type) {
         case TokenType::IDENTIFIER: {
             advance();
             // Identifiers are ColumnRefs
-            return ColumnRef{literal, std::nullopt};
+            return ColumnRef{Symbol(literal), std::nullopt};
         }
         case TokenType::NUMBER: {
             advance();
             // Simple heuristic: if it contains a dot, it's a double
             if (literal.find('.') != std::string::npos) {
-                return LiteralValue{DataType::DOUBLE, std::stod(literal)};
+                double value = 0;
+                const char *end = literal.data() + literal.size();
+                if (const auto [ptr, ec] = std::from_chars(literal.data(), end, value); ec != std::errc{} || ptr != end) {
+                    fail(token_at(position - 1), "Invalid number " + std::string(literal));
+                }
+                return LiteralValue{DataType::DOUBLE, value};
             }
-            return LiteralValue{DataType::INTEGER, std::stoi(literal)};
+            return LiteralValue{DataType::INTEGER, parse_integer(token_at(position - 1))};
         }
         case TokenType::STRING: {
             advance();
-            return LiteralValue{DataType::TEXT, literal};
+            return LiteralValue{DataType::TEXT, std::string(literal)};
         }
-        case TokenType::LPAREN: {
+        case TokenType::NULL_TYPE: {
             advance();
-            Expression expr = parse_expression();
-            expect(TokenType::RPAREN, "Expected ')'");
-            return expr;
+            return LiteralValue::Null();
+        }
+        case TokenType::TRUE:
+        case TokenType::FALSE: {
+            advance();
+            return LiteralValue::Boolean(type == TokenType::TRUE);
+        }
+        case TokenType::PARAMETER: {
+            advance();
+            uint32_t index = 0;
+            if (literal == "?") {
+                index = ++positional_parameters_;
+            } else {
+                const char *end = literal.data() + literal.size();
+                if (const auto [ptr, ec] = std::from_chars(literal.data() + 1, end, index); ec != std::errc{} || ptr != end || index == 0) {
+                    fail(token_at(position - 1), "Invalid parameter " + std::string(literal));
+                }
+            }
+            parameter_count_ = std::max(parameter_count_, index);
+            return ParameterRef{index};
+        }
+        case TokenType::CAST: {
+            advance();
+            expect(TokenType::LPAREN, "Expected '(' after CAST");
+            auto cast = std::make_unique<CastExpr>();
+            cast->expr = std::make_unique<Expression>(parse_expression());
+            expect(TokenType::AS, "Expected AS in CAST");
+            cast->target_type = parse_data_type();
+            expect(TokenType::RPAREN, "Expected ')' after CAST type");
+            return cast;
         }
         default:
-            throw std::runtime_error("Unknown expression token " + literal + " at line " +
-                std::to_string(line) + ", column " +
-                std::to_string(column));
+            fail(current(), "Unknown expression token " + std::string(literal));
+            return Expression{};
     }
 }
@@ -24,33 +24,78 @@
 #define FLUXO_DB_PARSER_H
 #pragma once
 #include "../lexer/lexer.h"
-#include "../ast/ast_expr.h"
-#include "../ast/ast_statements.h"
+#include "../ast/ast.h"
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
 #include <vector>
 
+// A syntax error and the position of the token it was found at
+struct ParseError {
+    std::string message;
+    int line = 0;
+    int column = 0;
+
+    // "<message> at line <line>, column <column>", the text parse() throws
+    [[nodiscard]] std::string to_string() const;
+};
+
 class Parser {
 private:
+    // Tokens are pulled from the lexer on demand into a small ring. It holds the largest peek() the grammar needs
+    // plus the token just consumed, so memory does not grow with the input.
+    static constexpr size_t lookahead_capacity = 8;
+
     Lexer &lexer_;
-    Token current_token_;
 
-    std::vector<Token> tokens;
-    size_t position = 0;
+    std::array<Token, lookahead_capacity> ring_{};
+    size_t position = 0; // Absolute index of the current token
+    size_t lexed_ = 0;   // Number of tokens pulled from the lexer so far
+    bool lexer_done_ = false;
+
+    // First syntax error; once set, every token reads as poisoned_ (EOF) so the grammar unwinds without throwing
+    std::optional<ParseError> error_;
+    Token poisoned_{};
+
+    // Operators and open parentheses of the expressions being parsed, innermost last. Kept across calls so that
+    // parsing an expression does not allocate a fresh stack each time.
+    struct PendingOperator {
+        enum Kind : uint8_t { BINARY, NEGATE, PAREN } kind = BINARY;
+        BinaryOp::Op op = BinaryOp::PLUS;
+        int precedence = 0;
+        Expression left{}; // Left operand of a BINARY entry
+    };
+    std::vector<PendingOperator> pending_;
+
+    uint32_t parameter_count_ = 0;       // Highest parameter slot used by the statement being parsed
+    uint32_t positional_parameters_ = 0; // Number of ? placeholders seen in it
+
+    const Token &token_at(size_t index);
+
+    // Tokens are handed out by reference into the ring. A reference stays valid until lookahead_capacity - 2 more
+    // tokens have been consumed; copy the Token (it is small and trivially copyable) to keep it longer.
+    [[nodiscard]] const Token &current();
+    [[nodiscard]] const Token &peek(size_t offset = 1);
+    [[nodiscard]] bool is_end();
 
-    [[nodiscard]] Token current() const;
-    [[nodiscard]] Token peek(size_t offset = 1) const;
-    [[nodiscard]] bool is_end() const;
+    const Token &advance();
+    const Token &expect(TokenType type, const char *error_msg);
 
-    Token advance();
-    Token expect(TokenType type, const std::string& error_msg);
+    void fail(const Token &token, std::string_view message);
 
     bool match(TokenType type);
 
     int64_t determine_sign();
+    int64_t parse_integer(const Token &token);
+    DataType parse_data_type();
 
     // Parsing methods
     Statement parse_statement();
     SelectStmt parse_select_stmt();
     InsertStmt parse_insert_stmt();
+    bool append_bulk_cell(BulkValues &bulk, size_t cell);
     AlterTableStmt parse_alter_table_stmt();
     AlterAction parse_alter_table_action();
     AddAction parse_add_action();
@@ -76,10 +121,21 @@ private:
     CreateViewStmt parse_create_view_stmt();
 
     Expression parse_expression(int precedence = 0);
+    // Literals, column references, placeholders and CAST; parentheses and unary minus are handled by parse_expression
     Expression parse_primary();
 public:
     explicit Parser(Lexer &lexer);
+    // Parse every statement; a syntax error is thrown as std::runtime_error
     std::vector<Statement> parse();
+    // Same as parse(), but a syntax error is returned instead of thrown. No parse path throws.
+    std::expected<std::vector<Statement>, ParseError> try_parse();
+    // Parse and return the next statement (consuming its trailing semicolon), or std::nullopt at end of input
+    std::optional<Statement> next_statement();
+    // Same as next_statement(), but every expression node of the result lives in a fresh arena owned by the result.
+    // Keep the result alive for as long as its statement is used.
+    std::optional<ArenaStatement> next_arena_statement();
+    // Parameter slots used by the statement parsed last, i.e. the highest $n or the number of ? placeholders
+    [[nodiscard]] uint32_t parameter_count() const { return parameter_count_; }
 };
 
 #endif //FLUXO_DB_PARSER_H
@@ -0,0 +1,48 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "prepared_statement.h"
+#include "parser.h"
+#include "../ast/fingerprint.h"
+#include "../optimizer/constant_folding.h"
+
+#include <stdexcept>
+
+PreparedStatement::PreparedStatement(std::string sql, Statement statement, const uint32_t parameter_count)
+    : sql_(std::move(sql)), statement_(std::move(statement)), parameter_count_(parameter_count),
+      fingerprint_(::fingerprint(statement_)) {
+}
+
+std::shared_ptr<const PreparedStatement> PreparedStatement::prepare(const std::string_view sql) {
+    Lexer lexer(sql, borrow_input);
+    Parser parser(lexer);
+    std::optional<Statement> statement = parser.next_statement();
+    if (!statement) {
+        throw std::runtime_error("Cannot prepare an empty statement");
+    }
+    const uint32_t parameter_count = parser.parameter_count();
+    if (parser.next_statement()) {
+        throw std::runtime_error("Cannot prepare more than one statement at once");
+    }
+    fold_constants(*statement);
+    return std::make_shared<const PreparedStatement>(std::string(sql), std::move(*statement), parameter_count);
+}
@@ -0,0 +1,56 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_PREPARED_STATEMENT_H
+#define FLUXO_DB_PREPARED_STATEMENT_H
+#pragma once
+#include "../ast/ast.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// A statement parsed once and executed many times. Values for its ParameterRef placeholders are supplied per
+// execution, so the AST is never re-parsed or mutated and one instance can be shared across threads.
+// Execution plans will be attached here as well once the planner exists.
+class PreparedStatement {
+private:
+    std::string sql_;
+    Statement statement_;
+    uint32_t parameter_count_ = 0;
+    uint64_t fingerprint_ = 0;
+
+public:
+    PreparedStatement(std::string sql, Statement statement, uint32_t parameter_count);
+
+    // Parse `sql`, which must hold exactly one statement (a trailing semicolon is allowed), and fold its constant
+    // subexpressions (see constant_folding.h). Throws std::runtime_error on a syntax error.
+    static std::shared_ptr<const PreparedStatement> prepare(std::string_view sql);
+
+    [[nodiscard]] const std::string &sql() const { return sql_; }
+    [[nodiscard]] const Statement &statement() const { return statement_; }
+    [[nodiscard]] uint32_t parameter_count() const { return parameter_count_; }
+    // Literal-insensitive shape of the statement (see fingerprint.h), for query logs and statistics
+    [[nodiscard]] uint64_t fingerprint() const { return fingerprint_; }
+};
+
+#endif //FLUXO_DB_PREPARED_STATEMENT_H
@@ -0,0 +1,138 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "statement_cache.h"
+
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+// Largest power of two no greater than the number of shards of min_shard_capacity that `capacity` fills
+size_t shard_count_for(const size_t capacity) {
+    size_t shards = 1;
+    while (shards * 2 <= StatementCache::max_shards && shards * 2 * StatementCache::min_shard_capacity <= capacity) {
+        shards *= 2;
+    }
+    return shards;
+}
+
+} // namespace
+
+StatementCache::StatementCache(const size_t capacity) : capacity_(capacity) {
+    if (capacity_ == 0) {
+        throw std::invalid_argument("StatementCache capacity must be positive");
+    }
+    shards_ = std::vector<Shard>(shard_count_for(capacity_));
+    // Spread the capacity so the shards add up to it exactly
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        shards_[i].capacity = capacity_ / shards_.size() + (i < capacity_ % shards_.size() ? 1 : 0);
+    }
+}
+
+StatementCache::Shard &StatementCache::shard_for(const Key &key) {
+    // The high bits pick the shard; the low ones are left to the shard's own hash table
+    return shards_[(static_cast<uint64_t>(key.hash) >> 32) & (shards_.size() - 1)];
+}
+
+std::shared_ptr<const PreparedStatement> StatementCache::find(const std::string_view sql) {
+    const Key key{sql, std::hash<std::string_view>{}(sql)};
+    Shard &shard = shard_for(key);
+    const std::lock_guard lock(shard.mutex);
+    const auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        return nullptr;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return it->second->statement;
+}
+
+std::shared_ptr<const PreparedStatement> StatementCache::get_or_prepare(const std::string_view sql) {
+    const Key key{sql, std::hash<std::string_view>{}(sql)};
+    Shard &shard = shard_for(key);
+    {
+        const std::lock_guard lock(shard.mutex);
+        if (const auto it = shard.index.find(key); it != shard.index.end()) {
+            ++shard.hits;
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return it->second->statement;
+        }
+        ++shard.misses;
+    }
+
+    std::shared_ptr<const PreparedStatement> prepared = PreparedStatement::prepare(sql);
+
+    const std::lock_guard lock(shard.mutex);
+    // Another thread may have prepared the same text meanwhile; keep the first so callers share one instance
+    if (const auto it = shard.index.find(key); it != shard.index.end()) {
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->statement;
+    }
+    shard.entries.push_front(Entry{std::string(sql), prepared});
+    shard.index.emplace(Key{shard.entries.front().sql, key.hash}, shard.entries.begin());
+    if (shard.entries.size() > shard.capacity) {
+        const std::string &evicted = shard.entries.back().sql;
+        shard.index.erase(Key{evicted, std::hash<std::string_view>{}(evicted)});
+        shard.entries.pop_back();
+    }
+    return prepared;
+}
+
+void StatementCache::clear() {
+    for (Shard &shard : shards_) {
+        const std::lock_guard lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+    }
+}
+
+size_t StatementCache::size() const {
+    size_t size = 0;
+    for (const Shard &shard : shards_) {
+        const std::lock_guard lock(shard.mutex);
+        size += shard.entries.size();
+    }
+    return size;
+}
+
+uint64_t StatementCache::hits() const {
+    uint64_t hits = 0;
+    for (const Shard &shard : shards_) {
+        const std::lock_guard lock(shard.mutex);
+        hits += shard.hits;
+    }
+    return hits;
+}
+
+uint64_t StatementCache::misses() const {
+    uint64_t misses = 0;
+    for (const Shard &shard : shards_) {
+        const std::lock_guard lock(shard.mutex);
+        misses += shard.misses;
+    }
+    return misses;
+}
+
+StatementCache &StatementCache::global() {
+    static StatementCache cache;
+    return cache;
+}
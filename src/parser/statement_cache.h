@@ -0,0 +1,106 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_STATEMENT_CACHE_H
+#define FLUXO_DB_STATEMENT_CACHE_H
+#pragma once
+#include "prepared_statement.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Bounded cache of prepared statements keyed by their exact SQL text. A hit skips lexing and parsing entirely.
+// All members are thread-safe. Statements are handed out as shared pointers, so evicting an entry never invalidates
+// a statement that is still in use.
+//
+// The cache is split into shards by a hash of the text, each with its own lock and LRU list, so lookups of different
+// statements from different threads rarely contend. Eviction is LRU within a shard and so only approximately LRU for
+// the cache as a whole; small caches use a single shard and evict exactly.
+class StatementCache {
+private:
+    struct Entry {
+        std::string sql;
+        std::shared_ptr<const PreparedStatement> statement;
+    };
+
+    // The text's hash is computed once per lookup, to pick the shard and then to probe its table
+    struct Key {
+        std::string_view sql;
+        size_t hash;
+
+        bool operator==(const Key &other) const { return sql == other.sql; }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const { return key.hash; }
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        size_t capacity = 0;
+        std::list<Entry> entries; // Most recently used first
+        // Keys view the sql of their entry; list nodes never move, so the views stay valid until the entry is erased
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    size_t capacity_;
+    std::vector<Shard> shards_;
+
+    [[nodiscard]] Shard &shard_for(const Key &key);
+
+public:
+    static constexpr size_t default_capacity = 1024;
+    static constexpr size_t max_shards = 16;
+    // Shards never hold fewer entries than this, so that per-shard LRU stays close to LRU over the whole cache
+    static constexpr size_t min_shard_capacity = 64;
+
+    explicit StatementCache(size_t capacity = default_capacity);
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    // The cached statement for `sql`, preparing and inserting it on a miss. Parsing happens outside the lock, so a
+    // slow parse does not block lookups. Syntax errors are thrown and nothing is cached for them.
+    std::shared_ptr<const PreparedStatement> get_or_prepare(std::string_view sql);
+
+    // The cached statement for `sql`, or nullptr
+    std::shared_ptr<const PreparedStatement> find(std::string_view sql);
+
+    void clear();
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+    [[nodiscard]] size_t shard_count() const { return shards_.size(); }
+    [[nodiscard]] uint64_t hits() const;
+    [[nodiscard]] uint64_t misses() const;
+
+    // Process-wide instance
+    static StatementCache &global();
+};
+
+#endif //FLUXO_DB_STATEMENT_CACHE_H
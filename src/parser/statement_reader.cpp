@@ -0,0 +1,96 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "statement_reader.h"
+#include "statement_splitter.h"
+
+#include <algorithm>
+
+StatementReader::StatementReader(std::istream &input, const size_t chunk_size)
+    : input_(input), chunk_size_(std::max<size_t>(chunk_size, 1)) {
+}
+
+std::optional<Statement> StatementReader::next() {
+    while (true) {
+        if (parser_) {
+            if (std::optional<Statement> statement = parser_->next_statement()) {
+                return statement;
+            }
+            close_segment();
+        }
+        if (!open_next_segment()) {
+            return std::nullopt;
+        }
+    }
+}
+
+// Append the next chunk of the stream. Only called while no parser is reading from buffer_.
+bool StatementReader::read_chunk() {
+    if (input_done_) {
+        return false;
+    }
+    // Drop the text that has already been parsed before growing the buffer
+    buffer_.erase(0, start_);
+    scan_position_ -= start_;
+    start_ = 0;
+
+    const size_t old_size = buffer_.size();
+    buffer_.resize(old_size + chunk_size_);
+    input_.read(buffer_.data() + old_size, static_cast<std::streamsize>(chunk_size_));
+    const auto read = static_cast<size_t>(input_.gcount());
+    buffer_.resize(old_size + read);
+
+    if (read < chunk_size_) {
+        input_done_ = true;
+    }
+    return read > 0;
+}
+
+bool StatementReader::open_next_segment() {
+    size_t end;
+    while ((end = find_statement_end(buffer_, scan_position_, in_string_)) == std::string_view::npos) {
+        if (scan_position_ < buffer_.size()) {
+            // Stopped on a NUL, which ends the script: the rest of the stream is never read
+            buffer_.resize(scan_position_);
+            input_done_ = true;
+        }
+        if (!read_chunk()) {
+            end = buffer_.size(); // Last statement without a trailing semicolon
+            break;
+        }
+    }
+    if (end == start_) {
+        return false;
+    }
+    end_ = end;
+    lexer_.emplace(std::string_view(buffer_).substr(start_, end_ - start_), borrow_input, line_, column_);
+    parser_.emplace(*lexer_);
+    return true;
+}
+
+void StatementReader::close_segment() {
+    parser_.reset();
+    lexer_.reset();
+
+    advance_script_position(std::string_view(buffer_).substr(start_, end_ - start_), line_, column_);
+    start_ = end_;
+}
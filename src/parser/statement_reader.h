@@ -0,0 +1,65 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_STATEMENT_READER_H
+#define FLUXO_DB_STATEMENT_READER_H
+#pragma once
+#include "parser.h"
+#include <istream>
+#include <optional>
+#include <string>
+
+// Pull-based parsing of a script that is too large to hold in memory (e.g. a dump file).
+// The stream is read in fixed-size chunks and split at top-level semicolons; each piece is lexed and parsed
+// straight out of the chunk buffer, so memory stays bounded by the chunk size plus the longest statement and
+// the first statement is available as soon as its text has been read.
+class StatementReader {
+private:
+    std::istream &input_;
+    size_t chunk_size_;
+
+    std::string buffer_;      // Text read from the stream that has not been parsed yet starts at start_
+    size_t start_ = 0;        // Start of the current statement text in buffer_
+    size_t end_ = 0;          // End of the current statement text in buffer_
+    size_t scan_position_ = 0; // How far buffer_ has been searched for a statement boundary
+    bool in_string_ = false;  // Whether scan_position_ is inside a quoted string
+    bool input_done_ = false;
+
+    // Script position of buffer_[start_], so errors point into the whole script rather than into the chunk
+    int line_ = 1;
+    int column_ = 1;
+
+    std::optional<Lexer> lexer_;
+    std::optional<Parser> parser_;
+
+    bool read_chunk();
+    bool open_next_segment();
+    void close_segment();
+public:
+    explicit StatementReader(std::istream &input, size_t chunk_size = 64 * 1024);
+
+    // Next statement of the script, or std::nullopt once the stream is exhausted. Parse errors are thrown as
+    // std::runtime_error with the line and column in the whole script.
+    std::optional<Statement> next();
+};
+
+#endif //FLUXO_DB_STATEMENT_READER_H
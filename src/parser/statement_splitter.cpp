@@ -0,0 +1,66 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include "statement_splitter.h"
+#include "../lexer/scan.h"
+
+#include <algorithm>
+
+size_t find_statement_end(const std::string_view text, size_t &position, bool &in_string) {
+    const ScanKernels &scan = activeScanKernels();
+    // The lexer treats NUL as end of input, inside a string or not, so the scan ends at the first one as well
+    constexpr std::string_view stops(";'\0", 3);
+
+    size_t i = position;
+    while (i < text.length()) {
+        if (in_string) {
+            i += scan.stringBody(text.data() + i, text.length() - i); // Up to the closing quote or a NUL
+            if (i == text.length() || text[i] == '\0') {
+                break;
+            }
+            in_string = false;
+            i++; // Closing quote
+            continue;
+        }
+        i = std::min(text.find_first_of(stops, i), text.length());
+        if (i == text.length() || text[i] == '\0') {
+            break;
+        }
+        if (text[i] == ';') {
+            position = i + 1;
+            return i + 1;
+        }
+        in_string = true;
+        i++; // Opening quote
+    }
+    position = i;
+    return std::string_view::npos;
+}
+
+void advance_script_position(const std::string_view text, int &line, int &column) {
+    if (const size_t last_newline = text.rfind('\n'); last_newline != std::string_view::npos) {
+        line += static_cast<int>(std::ranges::count(text, '\n'));
+        column = static_cast<int>(text.length() - last_newline);
+    } else {
+        column += static_cast<int>(text.length());
+    }
+}
@@ -0,0 +1,41 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_STATEMENT_SPLITTER_H
+#define FLUXO_DB_STATEMENT_SPLITTER_H
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+// Splitting scripts at top-level semicolons without parsing them. Quotes follow the lexer: a string runs from one '
+// to the next, and a semicolon inside it does not end a statement. Shared by StatementReader and parse_parallel.
+
+// Offset just past the next top-level semicolon at or after `position`, or npos if `text` ends first.
+// `position` is left where scanning stopped and `in_string` holds the quote state there, so a caller whose buffer
+// grows can resume the scan instead of starting over. A NUL byte ends the script, as it ends the lexer's input: the
+// scan stops on it and `position` is left pointing at it (below text.length()), however much text follows.
+size_t find_statement_end(std::string_view text, size_t &position, bool &in_string);
+
+// Move a script position (1-based line, column of the next character) past `text`
+void advance_script_position(std::string_view text, int &line, int &column);
+
+#endif //FLUXO_DB_STATEMENT_SPLITTER_H
@@ -0,0 +1,87 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_TRACE_H
+#define FLUXO_DB_TRACE_H
+#pragma once
+#include "../lexer/lexer.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Parser diagnostics. Trace points are written with FLUXO_PARSER_TRACE and compile to nothing unless the build defines
+// FLUXO_TRACE (the FLUXO_TRACE CMake option). When enabled, events go to a fixed-size ring owned by the calling thread:
+// recording is a couple of stores, never blocks and never performs I/O; the oldest events are overwritten.
+
+struct TraceEvent {
+    const char *site = nullptr; // Static string naming the trace point
+    TokenType token = TokenType::UNKNOWN;
+    uint32_t offset = 0; // Token offset in its lexer's input; Lexer::location turns it into a line and column
+    int64_t value = 0; // Site-specific detail, e.g. the operator precedence
+};
+
+template <size_t Capacity>
+class TraceRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "TraceRing capacity must be a power of two");
+
+private:
+    std::array<TraceEvent, Capacity> events_{};
+    uint64_t recorded_ = 0;
+
+public:
+    void record(const char *site, const Token &token, const int64_t value) {
+        events_[recorded_ & (Capacity - 1)] = TraceEvent{site, token.type, token.offset, value};
+        ++recorded_;
+    }
+
+    // Total number of events recorded, including overwritten ones
+    [[nodiscard]] uint64_t recorded() const { return recorded_; }
+
+    // Retained events, oldest first
+    [[nodiscard]] std::vector<TraceEvent> snapshot() const {
+        const uint64_t count = recorded_ < Capacity ? recorded_ : Capacity;
+        std::vector<TraceEvent> out;
+        out.reserve(count);
+        for (uint64_t i = recorded_ - count; i < recorded_; ++i) {
+            out.push_back(events_[i & (Capacity - 1)]);
+        }
+        return out;
+    }
+
+    void clear() { recorded_ = 0; }
+};
+
+using ParserTraceRing = TraceRing<1024>;
+
+// The calling thread's parser trace
+inline ParserTraceRing &parser_trace() {
+    thread_local ParserTraceRing ring;
+    return ring;
+}
+
+#if defined(FLUXO_TRACE) && FLUXO_TRACE
+#define FLUXO_PARSER_TRACE(site, token, value) parser_trace().record((site), (token), static_cast<int64_t>(value))
+#else
+#define FLUXO_PARSER_TRACE(site, token, value) ((void)0)
+#endif
+
+#endif //FLUXO_DB_TRACE_H
@@ -0,0 +1,55 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_ALIGNED_VECTOR_H
+#define FLUXO_DB_ALIGNED_VECTOR_H
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Alignment of every column buffer: a cache line, which also covers the widest (AVX-512) vector load
+inline constexpr size_t column_alignment = 64;
+
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    explicit AlignedAllocator(const AlignedAllocator<U> &) {}
+
+    T *allocate(const size_t n) {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{column_alignment}));
+    }
+    void deallocate(T *p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t{column_alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U> &) const { return true; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+#endif //FLUXO_DB_ALIGNED_VECTOR_H
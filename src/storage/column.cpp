@@ -0,0 +1,375 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "column.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <unordered_map>
+
+StringStore::StringStore(const StringStore &other) {
+    *this = other;
+}
+
+StringStore &StringStore::operator=(const StringStore &other) {
+    if (this == &other) {
+        return *this;
+    }
+    StringArena copied;
+    AlignedVector<StringRef> handles(other.refs);
+    std::unordered_map<const char *, StringRef> moved;
+    for (StringRef &handle : handles) {
+        if (!handle.is_inline()) {
+            const auto [it, added] = moved.try_emplace(handle.view().data());
+            if (added) {
+                it->second = StringRef(handle.view(), copied);
+            }
+            handle = it->second;
+        }
+    }
+    refs = std::move(handles);
+    arena = std::move(copied);
+    return *this;
+}
+
+PhysicalType physical_type(const DataType type) {
+    switch (type) {
+        case DataType::INTEGER:
+        case DataType::DATE:
+            return PhysicalType::INT32;
+        case DataType::BIGINT:
+        case DataType::TIMESTAMP:
+            return PhysicalType::INT64;
+        case DataType::DOUBLE:
+            return PhysicalType::DOUBLE;
+        case DataType::BOOLEAN:
+            return PhysicalType::BIT;
+        case DataType::TEXT:
+        case DataType::VARCHAR:
+            return PhysicalType::STRING;
+        case DataType::NULL_TYPE:
+            break;
+    }
+    throw std::invalid_argument("Column has no storable type");
+}
+
+ColumnSegment::ColumnSegment(const PhysicalType type, const StringEncoding encoding)
+    : type_(type), encoding_(encoding) {
+    if (type_ == PhysicalType::STRING && encoding_ == StringEncoding::DICTIONARY) {
+        code_slots_.resize(16);
+    }
+}
+
+void ColumnSegment::reserve(const size_t rows) {
+    if (packed()) {
+        unpack();
+    }
+    switch (type_) {
+        case PhysicalType::INT32: int32s_.reserve(rows); break;
+        case PhysicalType::INT64: int64s_.reserve(rows); break;
+        case PhysicalType::DOUBLE: doubles_.reserve(rows); break;
+        case PhysicalType::BIT: bits_.reserve((rows + 63) / 64); break;
+        case PhysicalType::STRING:
+            if (encoding_ == StringEncoding::DICTIONARY) {
+                codes_.reserve(rows);
+            } else {
+                strings_.refs.reserve(rows);
+            }
+            break;
+    }
+}
+
+void ColumnSegment::set_null(const size_t row) {
+    nulls_.resize(std::max(nulls_.size(), row / 64 + 1));
+    nulls_[row / 64] |= uint64_t{1} << (row % 64);
+    ++null_count_;
+}
+
+void ColumnSegment::append_null() {
+    set_null(size_);
+    switch (type_) {
+        case PhysicalType::INT32: append_int32(0); break;
+        case PhysicalType::INT64: append_int64(0); break;
+        case PhysicalType::DOUBLE: append_double(0); break;
+        case PhysicalType::BIT: append_bool(false); break;
+        case PhysicalType::STRING: append_string({}); break;
+    }
+}
+
+void ColumnSegment::append_int32(const int32_t value) {
+    if (packed()) {
+        unpack();
+    }
+    int32s_.push_back(value);
+    ++size_;
+}
+
+void ColumnSegment::append_int64(const int64_t value) {
+    if (packed()) {
+        unpack();
+    }
+    int64s_.push_back(value);
+    ++size_;
+}
+
+void ColumnSegment::append_double(const double value) {
+    doubles_.push_back(value);
+    ++size_;
+}
+
+void ColumnSegment::append_bool(const bool value) {
+    if (size_ % 64 == 0) {
+        bits_.push_back(0);
+    }
+    bits_.back() |= uint64_t{value} << (size_ % 64);
+    ++size_;
+}
+
+void ColumnSegment::append_string(const std::string_view value) {
+    if (encoding_ == StringEncoding::DICTIONARY) {
+        const StringRef probe(value);
+        size_t slot = slot_of(probe);
+        if (code_slots_[slot] == 0 && dictionary_size() == max_dictionary_entries) {
+            decode_dictionary();
+        } else {
+            if (code_slots_[slot] == 0) {
+                strings_.append(value);
+                code_slots_[slot] = static_cast<uint32_t>(dictionary_size());
+                if (dictionary_size() * 2 > code_slots_.size()) {
+                    rebuild_code_slots();
+                    slot = slot_of(probe);
+                }
+            }
+            codes_.push_back(static_cast<uint16_t>(code_slots_[slot] - 1));
+            ++size_;
+            return;
+        }
+    }
+    strings_.append(value);
+    ++size_;
+}
+
+size_t ColumnSegment::slot_of(const StringRef &value) const {
+    const size_t mask = code_slots_.size() - 1;
+    for (size_t slot = value.hash() & mask;; slot = (slot + 1) & mask) {
+        if (code_slots_[slot] == 0 || strings_.refs[code_slots_[slot] - 1] == value) {
+            return slot;
+        }
+    }
+}
+
+void ColumnSegment::rebuild_code_slots() {
+    code_slots_.assign(std::bit_ceil(std::max<size_t>(16, dictionary_size() * 4)), 0);
+    const size_t mask = code_slots_.size() - 1;
+    for (size_t code = 0; code < dictionary_size(); ++code) {
+        size_t slot = strings_.refs[code].hash() & mask;
+        while (code_slots_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        code_slots_[slot] = static_cast<uint32_t>(code + 1);
+    }
+}
+
+void ColumnSegment::decode_dictionary() {
+    // Rows take copies of their entry's handle, so long payloads stay shared in the arena
+    AlignedVector<StringRef> rows;
+    rows.reserve(size_);
+    for (const uint16_t code : codes_) {
+        rows.push_back(strings_.refs[code]);
+    }
+    strings_.refs = std::move(rows);
+    codes_ = {};
+    code_slots_ = {};
+    encoding_ = StringEncoding::PLAIN;
+}
+
+std::optional<uint16_t> ColumnSegment::find_code(const std::string_view value) const {
+    if (const uint32_t entry = code_slots_[slot_of(StringRef(value))]; entry != 0) {
+        return static_cast<uint16_t>(entry - 1);
+    }
+    return std::nullopt;
+}
+
+void ColumnSegment::seal() {
+    if (type_ == PhysicalType::INT32) {
+        pack_integers(int32s_);
+    } else if (type_ == PhysicalType::INT64) {
+        pack_integers(int64s_);
+    }
+    if (type_ != PhysicalType::STRING || encoding_ != StringEncoding::DICTIONARY) {
+        return;
+    }
+    // Decoding keeps the arena, so the plain layout costs one handle a row on top of it
+    const size_t plain = size_ * sizeof(StringRef) + strings_.arena.bytes();
+    if (data_bytes() - nulls_.size() * sizeof(uint64_t) >= plain) {
+        decode_dictionary();
+    }
+}
+
+size_t ColumnSegment::data_bytes() const {
+    return int32s_.size() * sizeof(int32_t) + int64s_.size() * sizeof(int64_t) + doubles_.size() * sizeof(double) +
+           bits_.size() * sizeof(uint64_t) + codes_.size() * sizeof(uint16_t) +
+           strings_.refs.size() * sizeof(StringRef) + strings_.arena.bytes() + code_slots_.size() * sizeof(uint32_t) +
+           nulls_.size() * sizeof(uint64_t) + packed_.byte_size();
+}
+
+template <typename T>
+void ColumnSegment::pack_integers(AlignedVector<T> &values) {
+    if (packed() || size_ == 0) {
+        return;
+    }
+    std::span<const T> source = values;
+    AlignedVector<T> filled;
+    if (null_count_ > 0) {
+        // A NULL slot holds zero, which would widen its block's range: pack the value before it instead (decoding
+        // zeroes NULL rows again)
+        filled = values;
+        T previous = 0;
+        for (size_t row = 0; row < size_; ++row) {
+            if (!is_null(row)) {
+                previous = filled[row];
+                break;
+            }
+        }
+        for (size_t row = 0; row < size_; ++row) {
+            if (is_null(row)) {
+                filled[row] = previous;
+            } else {
+                previous = filled[row];
+            }
+        }
+        source = filled;
+    }
+    PackedInts packed = PackedInts::pack(source);
+    if (packed.byte_size() < values.size() * sizeof(T)) {
+        packed_ = std::move(packed);
+        values = {};
+    }
+}
+
+template <typename T>
+void ColumnSegment::unpack_integers(AlignedVector<T> &values) {
+    AlignedVector<T> decoded(size_);
+    decode_integers(values, 0, std::span<T>(decoded));
+    values = std::move(decoded);
+    packed_ = {};
+}
+
+void ColumnSegment::unpack() {
+    if (type_ == PhysicalType::INT32) {
+        unpack_integers(int32s_);
+    } else {
+        unpack_integers(int64s_);
+    }
+}
+
+template <typename T>
+void ColumnSegment::decode_integers(const AlignedVector<T> &values, const size_t first, const std::span<T> out) const {
+    const size_t end = first + out.size();
+    if (end > size_) {
+        throw std::out_of_range("Column segment decode past the last row");
+    }
+    if (!packed()) {
+        std::copy_n(values.begin() + static_cast<std::ptrdiff_t>(first), out.size(), out.begin());
+        return;
+    }
+    std::array<T, packed_block_rows> buffer;
+    for (size_t row = first; row < end;) {
+        const size_t block = row / packed_block_rows;
+        const size_t begin = block * packed_block_rows;
+        const size_t rows = packed_.blocks()[block].rows;
+        const size_t count = std::min(begin + rows, end) - row;
+        T *target = out.data() + (row - first);
+        if (row == begin && count == rows) {
+            packed_.decode_block(block, target);
+        } else {
+            packed_.decode_block(block, buffer.data());
+            std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(row - begin), count, target);
+        }
+        row += count;
+    }
+    // Packed NULL slots hold their neighbour's value
+    for (size_t word = first / 64; word < nulls_.size() && word * 64 < end; ++word) {
+        for (uint64_t bits = nulls_[word]; bits != 0; bits &= bits - 1) {
+            const size_t row = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+            if (row >= first && row < end) {
+                out[row - first] = 0;
+            }
+        }
+    }
+}
+
+void ColumnSegment::decode_int32s(const size_t first, const std::span<int32_t> out) const {
+    decode_integers(int32s_, first, out);
+}
+
+void ColumnSegment::decode_int64s(const size_t first, const std::span<int64_t> out) const {
+    decode_integers(int64s_, first, out);
+}
+
+int64_t ColumnSegment::integer(const size_t row) const {
+    if (packed()) {
+        return is_null(row) ? 0 : packed_.value(row);
+    }
+    return type_ == PhysicalType::INT32 ? int64_t{int32s_[row]} : int64s_[row];
+}
+
+void ColumnSegment::truncate(const size_t rows) {
+    if (rows >= size_) {
+        return;
+    }
+    if (packed()) {
+        unpack();
+    }
+    for (size_t row = rows; row < size_; ++row) {
+        null_count_ -= is_null(row) ? 1 : 0;
+    }
+    const size_t words = (rows + 63) / 64;
+    const uint64_t tail = rows % 64 == 0 ? ~uint64_t{0} : (uint64_t{1} << (rows % 64)) - 1;
+    if (nulls_.size() > words) {
+        nulls_.resize(words);
+    }
+    if (!nulls_.empty() && nulls_.size() == words) {
+        nulls_.back() &= tail;
+    }
+    switch (type_) {
+        case PhysicalType::INT32: int32s_.resize(rows); break;
+        case PhysicalType::INT64: int64s_.resize(rows); break;
+        case PhysicalType::DOUBLE: doubles_.resize(rows); break;
+        case PhysicalType::BIT:
+            bits_.resize(words);
+            if (!bits_.empty()) {
+                bits_.back() &= tail;
+            }
+            break;
+        case PhysicalType::STRING:
+            if (encoding_ == StringEncoding::DICTIONARY) {
+                codes_.resize(rows); // Entries no row uses any more stay in the dictionary
+            } else {
+                strings_.refs.resize(rows); // The arena keeps the payloads until the segment goes
+            }
+            break;
+    }
+    size_ = rows;
+}
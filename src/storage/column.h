@@ -0,0 +1,183 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_COLUMN_H
+#define FLUXO_DB_COLUMN_H
+#pragma once
+#include "aligned_vector.h"
+#include "int_packing.h"
+#include "string_ref.h"
+#include "../ast/ast_expr.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// How a column's values are laid out in memory, derived from its declared DataType
+enum class PhysicalType : uint8_t {
+    INT32,  // INTEGER, DATE (days since 1970-01-01)
+    INT64,  // BIGINT, TIMESTAMP (microseconds since 1970-01-01)
+    DOUBLE, // DOUBLE
+    BIT,    // BOOLEAN, one bit per row
+    STRING  // TEXT, VARCHAR: see StringEncoding
+};
+
+// Layout of a STRING segment
+enum class StringEncoding : uint8_t {
+    PLAIN,     // Row i is strings[i]
+    DICTIONARY // Row i is dictionary entry codes[i], entry c is strings[c]
+};
+
+// Most entries a dictionary can hold: codes are 16 bits
+inline constexpr size_t max_dictionary_entries = size_t{1} << 16;
+
+// Physical layout for a declared column type; throws std::invalid_argument for NULL_TYPE
+PhysicalType physical_type(DataType type);
+
+// The StringRefs of a segment and the arena holding their long payloads. A copy gets an arena of its own, with each
+// payload copied once however many handles share it.
+struct StringStore {
+    AlignedVector<StringRef> refs;
+    StringArena arena;
+
+    StringStore() = default;
+    StringStore(StringStore &&) noexcept = default;
+    StringStore &operator=(StringStore &&) noexcept = default;
+    StringStore(const StringStore &other);
+    StringStore &operator=(const StringStore &other);
+
+    void append(const std::string_view value) { refs.emplace_back(value, arena); }
+};
+
+// The values of one column within one row group. Values sit in a single dense, 64-byte aligned array of the column's
+// physical type, with a slot for every row: the slot of a NULL row is zero (or an empty string) and its bit is set in
+// the null bitmap, so a scan can run over the array without branching on NULLs. The bitmap is only allocated once
+// the first NULL arrives.
+//
+// Strings are 16-byte StringRefs, with payloads over 12 bytes in the segment's arena. STRING segments are dictionary
+// encoded while they are written: each distinct string is stored once and rows hold 16-bit codes, so low-cardinality
+// columns (status, country, tenant) take two bytes a row and can be filtered and grouped on the codes (see
+// string_ops.h). seal() settles the encoding once the segment is complete, switching to the plain layout when the
+// dictionary saves nothing; a dictionary that outgrows 16-bit codes switches earlier.
+//
+// seal() bit-packs INT32 and INT64 segments (see PackedInts) when that is smaller. A packed segment has no int32s() /
+// int64s() array; it is read a block at a time through decode_int32s() / decode_int64s(), or one row through
+// integer(). Writing to a packed segment unpacks it first.
+class ColumnSegment {
+private:
+    PhysicalType type_;
+    StringEncoding encoding_ = StringEncoding::DICTIONARY;
+    size_t size_ = 0;
+    size_t null_count_ = 0;
+    AlignedVector<int32_t> int32s_;
+    AlignedVector<int64_t> int64s_;
+    AlignedVector<double> doubles_;
+    AlignedVector<uint64_t> bits_;           // BIT values, bit i of word i / 64
+    AlignedVector<uint16_t> codes_;          // DICTIONARY: one code per row
+    StringStore strings_;                    // PLAIN: one per row; DICTIONARY: one per entry
+    std::vector<uint32_t> code_slots_;       // DICTIONARY: open-addressing index of the entries, code + 1 (0 = empty)
+    AlignedVector<uint64_t> nulls_;          // Bit i set when row i is NULL
+    PackedInts packed_;                      // INT32 / INT64 once sealed, replacing int32s_ / int64s_
+
+    void set_null(size_t row);
+    [[nodiscard]] size_t slot_of(const StringRef &value) const;
+    void rebuild_code_slots();
+    void decode_dictionary();
+    template <typename T>
+    void pack_integers(AlignedVector<T> &values);
+    template <typename T>
+    void unpack_integers(AlignedVector<T> &values);
+    void unpack();
+    template <typename T>
+    void decode_integers(const AlignedVector<T> &values, size_t first, std::span<T> out) const;
+
+public:
+    // `encoding` only matters for STRING; a PLAIN segment never builds a dictionary
+    explicit ColumnSegment(PhysicalType type, StringEncoding encoding = StringEncoding::DICTIONARY);
+
+    [[nodiscard]] PhysicalType type() const { return type_; }
+    [[nodiscard]] StringEncoding encoding() const { return encoding_; }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] size_t null_count() const { return null_count_; }
+
+    // Reserve room for `rows` values in total
+    void reserve(size_t rows);
+
+    // Append one value; the append must match the segment's physical type
+    void append_null();
+    void append_int32(int32_t value);
+    void append_int64(int64_t value);
+    void append_double(double value);
+    void append_bool(bool value);
+    void append_string(std::string_view value);
+
+    // Drop every row from `rows` on
+    void truncate(size_t rows);
+
+    // Called once no more rows are coming: a STRING segment keeps its dictionary only if that is smaller than the
+    // plain layout, and an integer segment is packed if that is smaller. Appending after seal() is still allowed.
+    void seal();
+
+    // Bytes held by the column data (not counting spare capacity)
+    [[nodiscard]] size_t data_bytes() const;
+
+    [[nodiscard]] bool is_null(const size_t row) const {
+        return row / 64 < nulls_.size() && (nulls_[row / 64] >> (row % 64) & 1) != 0;
+    }
+
+    // Raw column data for scans. Each span covers size() rows (size() bits for bools); null_words() ends at the word
+    // of the last NULL, so it is empty when the segment holds none. For a dictionary, strings() holds the entries.
+    // int32s() and int64s() are empty once packed.
+    [[nodiscard]] std::span<const int32_t> int32s() const { return int32s_; }
+    [[nodiscard]] std::span<const int64_t> int64s() const { return int64s_; }
+    [[nodiscard]] std::span<const double> doubles() const { return doubles_; }
+    [[nodiscard]] std::span<const uint64_t> bool_words() const { return bits_; }
+    [[nodiscard]] std::span<const uint16_t> codes() const { return codes_; }
+    [[nodiscard]] std::span<const StringRef> strings() const { return strings_.refs; }
+    [[nodiscard]] std::span<const uint64_t> null_words() const { return nulls_; }
+
+    [[nodiscard]] bool packed() const { return !packed_.empty(); }
+    [[nodiscard]] const PackedInts &packed_ints() const { return packed_; }
+
+    // Copy rows [first, first + out.size()) of an INT32 (INT64) segment into `out`, packed or not; NULL rows are zero
+    void decode_int32s(size_t first, std::span<int32_t> out) const;
+    void decode_int64s(size_t first, std::span<int64_t> out) const;
+    // One row of an INT32 or INT64 segment
+    [[nodiscard]] int64_t integer(size_t row) const;
+
+    [[nodiscard]] bool boolean(const size_t row) const { return (bits_[row / 64] >> (row % 64) & 1) != 0; }
+
+    // DICTIONARY only: number of entries, entry `code`, and the code of `value` if it is an entry
+    [[nodiscard]] size_t dictionary_size() const { return strings_.refs.size(); }
+    [[nodiscard]] std::string_view dictionary_entry(const size_t code) const { return strings_.refs[code].view(); }
+    [[nodiscard]] std::optional<uint16_t> find_code(std::string_view value) const;
+
+    // Value of a STRING row. The view may point into the segment's handles, so it is only good until the next write.
+    [[nodiscard]] const StringRef &string_ref(const size_t row) const {
+        return strings_.refs[encoding_ == StringEncoding::DICTIONARY ? codes_[row] : row];
+    }
+    [[nodiscard]] std::string_view string(const size_t row) const { return string_ref(row).view(); }
+};
+
+#endif //FLUXO_DB_COLUMN_H
@@ -0,0 +1,76 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "int_ops.h"
+
+#include <bit>
+
+namespace {
+
+template <typename T>
+void select_values(const std::span<const T> values, const int64_t low, const int64_t high, uint64_t *selected) {
+    const auto floor = static_cast<uint64_t>(low);
+    const uint64_t span = static_cast<uint64_t>(high) - floor;
+    const auto matches = [&](const size_t row) {
+        return static_cast<uint64_t>(int64_t{values[row]}) - floor <= span;
+    };
+    for (size_t begin = 0; begin < values.size(); begin += 64) {
+        uint64_t bits = 0;
+        if (begin + 64 <= values.size()) {
+            // Fixed trip count, so the compiler can vectorize the compares of a full word
+            for (size_t bit = 0; bit < 64; ++bit) {
+                bits |= uint64_t{matches(begin + bit)} << bit;
+            }
+        } else {
+            for (size_t row = begin; row < values.size(); ++row) {
+                bits |= uint64_t{matches(row)} << (row - begin);
+            }
+        }
+        selected[begin / 64] = bits;
+    }
+}
+
+} // namespace
+
+size_t select_range(const ColumnSegment &segment, const int64_t low, const int64_t high,
+                    std::vector<uint64_t> &selected) {
+    selected.assign((segment.size() + 63) / 64, 0);
+    if (low > high || segment.size() == 0) {
+        return 0;
+    }
+    if (segment.packed()) {
+        segment.packed_ints().select_range(low, high, selected.data());
+    } else if (segment.type() == PhysicalType::INT32) {
+        select_values(segment.int32s(), low, high, selected.data());
+    } else {
+        select_values(segment.int64s(), low, high, selected.data());
+    }
+    const std::span<const uint64_t> nulls = segment.null_words();
+    size_t count = 0;
+    for (size_t word = 0; word < selected.size(); ++word) {
+        if (word < nulls.size()) {
+            selected[word] &= ~nulls[word];
+        }
+        count += static_cast<size_t>(std::popcount(selected[word]));
+    }
+    return count;
+}
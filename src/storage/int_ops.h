@@ -0,0 +1,39 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_INT_OPS_H
+#define FLUXO_DB_INT_OPS_H
+#pragma once
+#include "column.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Predicates over INT32 and INT64 segments. A packed segment is filtered on its packed form (see
+// PackedInts::select_range), so =, <, <=, >, >= and BETWEEN never materialize the values of a FOR block. NULL rows
+// never match.
+
+// Set bit i of `selected` (resized to one bit per row) for every row whose value lies in [low, high]; returns the
+// number of matches. `x = c` is [c, c], `x < c` is [INT64_MIN, c - 1], and so on.
+size_t select_range(const ColumnSegment &segment, int64_t low, int64_t high, std::vector<uint64_t> &selected);
+
+#endif //FLUXO_DB_INT_OPS_H
@@ -0,0 +1,303 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "int_packing.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FLUXO_PACKING_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// DELTA costs a prefix sum on every decode and gives up direct row access and predicates on the offsets, so it is
+// only chosen when it saves more than this many bits per value over FOR
+constexpr unsigned delta_penalty_bits = 4;
+
+constexpr uint64_t width_mask(const unsigned width) {
+    return width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+}
+
+// Append `rows` offsets of `width` bits to `words` in the interleaved lane layout; the last group is padded with zeros
+void pack_lanes(std::array<uint64_t, packed_block_rows> &offsets, const size_t rows, const unsigned width,
+                AlignedVector<uint64_t> &words) {
+    const size_t groups = (rows + packed_lanes - 1) / packed_lanes;
+    std::fill(offsets.begin() + static_cast<std::ptrdiff_t>(rows),
+              offsets.begin() + static_cast<std::ptrdiff_t>(groups * packed_lanes), 0);
+    const size_t lane_words = (groups * width + 63) / 64;
+    const size_t base = words.size();
+    words.resize(base + lane_words * packed_lanes, 0);
+    for (size_t i = 0; i < groups * packed_lanes; ++i) {
+        const size_t bit = i / packed_lanes * width;
+        uint64_t *low = words.data() + base + bit / 64 * packed_lanes + i % packed_lanes;
+        const unsigned shift = bit % 64;
+        low[0] |= offsets[i] << shift;
+        if (shift + width > 64) {
+            low[packed_lanes] |= offsets[i] >> (64 - shift);
+        }
+    }
+}
+
+void scalarUnpack(const uint64_t *words, const unsigned width, const size_t groups, uint64_t *out) {
+    const uint64_t mask = width_mask(width);
+    for (size_t group = 0; group < groups; ++group) {
+        const size_t bit = group * width;
+        const uint64_t *low = words + bit / 64 * packed_lanes;
+        const unsigned shift = bit % 64;
+        uint64_t *values = out + group * packed_lanes;
+        if (shift + width > 64) {
+            for (size_t lane = 0; lane < packed_lanes; ++lane) {
+                values[lane] = (low[lane] >> shift | low[lane + packed_lanes] << (64 - shift)) & mask;
+            }
+        } else {
+            for (size_t lane = 0; lane < packed_lanes; ++lane) {
+                values[lane] = low[lane] >> shift & mask;
+            }
+        }
+    }
+}
+
+constexpr UnpackKernels scalarKernels{"scalar", scalarUnpack};
+
+#ifdef FLUXO_PACKING_X86
+
+// One 256-bit register holds the same word of all four lanes, so a group of four values is one or two loads, the
+// shifts, a mask and a store
+__attribute__((target("avx2")))
+void avx2Unpack(const uint64_t *words, const unsigned width, const size_t groups, uint64_t *out) {
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(width_mask(width)));
+    for (size_t group = 0; group < groups; ++group) {
+        const size_t bit = group * width;
+        const auto *low = reinterpret_cast<const __m256i *>(words + bit / 64 * packed_lanes);
+        const int shift = static_cast<int>(bit % 64);
+        __m256i values = _mm256_srl_epi64(_mm256_loadu_si256(low), _mm_cvtsi32_si128(shift));
+        if (shift + width > 64) {
+            const __m256i high = _mm256_sll_epi64(_mm256_loadu_si256(low + 1), _mm_cvtsi32_si128(64 - shift));
+            values = _mm256_or_si256(values, high);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + group * packed_lanes), _mm256_and_si256(values, mask));
+    }
+}
+
+constexpr UnpackKernels avx2Kernels{"avx2", avx2Unpack};
+
+#endif
+
+// Set the first `rows` bits of `words`
+void select_all(uint64_t *words, const size_t rows) {
+    std::fill(words, words + rows / 64, ~uint64_t{0});
+    if (rows % 64 != 0) {
+        words[rows / 64] = width_mask(rows % 64);
+    }
+}
+
+} // namespace
+
+const UnpackKernels &scalarUnpackKernels() {
+    return scalarKernels;
+}
+
+const UnpackKernels *avx2UnpackKernels() {
+#ifdef FLUXO_PACKING_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return &avx2Kernels;
+    }
+#endif
+    return nullptr;
+}
+
+const UnpackKernels &activeUnpackKernels() {
+    static const UnpackKernels &active = []() -> const UnpackKernels & {
+        if (const UnpackKernels *kernels = avx2UnpackKernels()) return *kernels;
+        return scalarUnpackKernels();
+    }();
+    return active;
+}
+
+template <typename T>
+PackedInts PackedInts::pack(const std::span<const T> values) {
+    PackedInts packed;
+    packed.size_ = values.size();
+    std::array<uint64_t, packed_block_rows> offsets{};
+    for (size_t begin = 0; begin < values.size(); begin += packed_block_rows) {
+        const size_t rows = std::min(packed_block_rows, values.size() - begin);
+        const T *block_values = values.data() + begin;
+        const auto [low, high] = std::minmax_element(block_values, block_values + rows);
+        PackedBlock block;
+        block.rows = static_cast<uint32_t>(rows);
+        block.first_word = static_cast<uint32_t>(packed.words_.size());
+        block.min = *low;
+        block.max = *high;
+
+        // Everything below is modular arithmetic on uint64_t, so the offsets come out right for any int64_t range
+        const auto min = static_cast<uint64_t>(block.min);
+        const auto for_width = static_cast<unsigned>(std::bit_width(static_cast<uint64_t>(block.max) - min));
+        const auto delta_of = [&](const size_t i) {
+            return static_cast<uint64_t>(int64_t{block_values[i]}) -
+                   static_cast<uint64_t>(int64_t{block_values[i - packed_lanes]});
+        };
+        int64_t min_delta = std::numeric_limits<int64_t>::max();
+        int64_t max_delta = std::numeric_limits<int64_t>::min();
+        for (size_t i = packed_lanes; i < rows; ++i) {
+            const auto delta = static_cast<int64_t>(delta_of(i));
+            min_delta = std::min(min_delta, delta);
+            max_delta = std::max(max_delta, delta);
+        }
+        const auto delta_width = static_cast<unsigned>(
+                std::bit_width(static_cast<uint64_t>(max_delta) - static_cast<uint64_t>(min_delta)));
+
+        if (rows > packed_lanes && delta_width + delta_penalty_bits < for_width) {
+            // The first group lives in the header; its offsets are packed as zeros
+            block.encoding = IntEncoding::DELTA;
+            block.width = static_cast<uint8_t>(delta_width);
+            block.step = static_cast<uint64_t>(min_delta);
+            for (size_t i = 0; i < packed_lanes; ++i) {
+                block.starts[i] = block_values[i];
+                offsets[i] = 0;
+            }
+            for (size_t i = packed_lanes; i < rows; ++i) {
+                offsets[i] = delta_of(i) - block.step;
+            }
+        } else {
+            block.width = static_cast<uint8_t>(for_width);
+            for (size_t i = 0; i < rows; ++i) {
+                offsets[i] = static_cast<uint64_t>(int64_t{block_values[i]}) - min;
+            }
+        }
+        if (block.width > 0) {
+            pack_lanes(offsets, rows, block.width, packed.words_);
+        }
+        packed.blocks_.push_back(block);
+    }
+    return packed;
+}
+
+void PackedInts::unpack_offsets(const PackedBlock &block, uint64_t *out) const {
+    const size_t groups = (block.rows + packed_lanes - 1) / packed_lanes;
+    if (block.width == 0) {
+        std::fill(out, out + groups * packed_lanes, 0);
+    } else {
+        activeUnpackKernels().unpack(words_.data() + block.first_word, block.width, groups, out);
+    }
+}
+
+template <typename T>
+void PackedInts::decode_block(const size_t block, T *out) const {
+    const PackedBlock &header = blocks_[block];
+    alignas(column_alignment) std::array<uint64_t, packed_block_rows> offsets;
+    unpack_offsets(header, offsets.data());
+    const auto min = static_cast<uint64_t>(header.min);
+    if (header.encoding == IntEncoding::FOR) {
+        for (size_t i = 0; i < header.rows; ++i) {
+            out[i] = static_cast<T>(min + offsets[i]);
+        }
+        return;
+    }
+    // A running sum per lane; the lanes are independent, so each step is one vector add. DELTA blocks hold more than
+    // one group.
+    std::array<uint64_t, packed_lanes> previous;
+    for (size_t lane = 0; lane < packed_lanes; ++lane) {
+        previous[lane] = static_cast<uint64_t>(header.starts[lane]);
+        out[lane] = static_cast<T>(previous[lane]);
+    }
+    size_t i = packed_lanes;
+    for (; i + packed_lanes <= header.rows; i += packed_lanes) {
+        for (size_t lane = 0; lane < packed_lanes; ++lane) {
+            previous[lane] += header.step + offsets[i + lane];
+            out[i + lane] = static_cast<T>(previous[lane]);
+        }
+    }
+    for (size_t lane = 0; i < header.rows; ++i, ++lane) {
+        out[i] = static_cast<T>(previous[lane] + header.step + offsets[i]);
+    }
+}
+
+int64_t PackedInts::value(const size_t row) const {
+    const PackedBlock &block = blocks_[row / packed_block_rows];
+    const size_t index = row % packed_block_rows;
+    if (block.encoding == IntEncoding::DELTA) {
+        std::array<int64_t, packed_block_rows> values;
+        decode_block(row / packed_block_rows, values.data());
+        return values[index];
+    }
+    if (block.width == 0) {
+        return block.min;
+    }
+    const size_t bit = index / packed_lanes * block.width;
+    const uint64_t *low = words_.data() + block.first_word + bit / 64 * packed_lanes + index % packed_lanes;
+    const unsigned shift = bit % 64;
+    uint64_t offset = low[0] >> shift;
+    if (shift + block.width > 64) {
+        offset |= low[packed_lanes] << (64 - shift);
+    }
+    return static_cast<int64_t>(static_cast<uint64_t>(block.min) + (offset & width_mask(block.width)));
+}
+
+void PackedInts::select_range(const int64_t low, const int64_t high, uint64_t *selected) const {
+    std::fill(selected, selected + (size_ + 63) / 64, 0);
+    alignas(column_alignment) std::array<uint64_t, packed_block_rows> keys;
+    for (size_t index = 0; index < blocks_.size(); ++index) {
+        const PackedBlock &block = blocks_[index];
+        uint64_t *words = selected + index * (packed_block_rows / 64);
+        const int64_t first = std::max(low, block.min);
+        const int64_t last = std::min(high, block.max);
+        if (first > last) {
+            continue;
+        }
+        if (first == block.min && last == block.max) {
+            select_all(words, block.rows);
+            continue;
+        }
+        // A key matches when key - floor <= span (unsigned), with the keys and floor on the same scale
+        uint64_t floor = static_cast<uint64_t>(first);
+        if (block.encoding == IntEncoding::FOR) {
+            unpack_offsets(block, keys.data());
+            floor -= static_cast<uint64_t>(block.min);
+        } else {
+            decode_block(index, reinterpret_cast<int64_t *>(keys.data()));
+        }
+        const uint64_t span = static_cast<uint64_t>(last) - static_cast<uint64_t>(first);
+        for (size_t begin = 0; begin < block.rows; begin += 64) {
+            uint64_t bits = 0;
+            if (begin + 64 <= block.rows) {
+                for (size_t bit = 0; bit < 64; ++bit) {
+                    bits |= uint64_t{keys[begin + bit] - floor <= span} << bit;
+                }
+            } else {
+                for (size_t row = begin; row < block.rows; ++row) {
+                    bits |= uint64_t{keys[row] - floor <= span} << (row - begin);
+                }
+            }
+            words[begin / 64] = bits;
+        }
+    }
+}
+
+template PackedInts PackedInts::pack<int32_t>(std::span<const int32_t>);
+template PackedInts PackedInts::pack<int64_t>(std::span<const int64_t>);
+template void PackedInts::decode_block<int32_t>(size_t, int32_t *) const;
+template void PackedInts::decode_block<int64_t>(size_t, int64_t *) const;
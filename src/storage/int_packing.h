@@ -0,0 +1,109 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_INT_PACKING_H
+#define FLUXO_DB_INT_PACKING_H
+#pragma once
+#include "aligned_vector.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Lightweight compression for sealed integer segments. Values are cut into blocks of packed_block_rows, and each block
+// stores them as offsets of a fixed bit width: from the block minimum (frame of reference) or from the previous value
+// (delta), whichever needs fewer bits.
+//
+// The bits of a block are interleaved over packed_lanes lanes: value i goes to lane i % 4 and is packed at bit
+// (i / 4) * width of that lane, and word k of all four lanes is stored together. One 256-bit load therefore holds the
+// same word of every lane, and four values unpack with the same shifts.
+inline constexpr size_t packed_block_rows = 1024;
+inline constexpr size_t packed_lanes = 4;
+
+struct UnpackKernels {
+    const char *name;
+    // Unpack `groups` * packed_lanes offsets of `width` bits (1 to 64) from interleaved `words` into `out`, in order
+    void (*unpack)(const uint64_t *words, unsigned width, size_t groups, uint64_t *out);
+};
+
+// Portable kernels; the reference the vectorized variant must agree with
+const UnpackKernels &scalarUnpackKernels();
+// Four lanes per 256-bit step; nullptr when the CPU or the build target lacks AVX2
+const UnpackKernels *avx2UnpackKernels();
+
+// Best kernels for the running CPU, chosen once on first use
+const UnpackKernels &activeUnpackKernels();
+
+enum class IntEncoding : uint8_t {
+    FOR,  // Value = min + offset
+    DELTA // Value = previous value in the lane + step + offset; the first value of each lane is kept in the header
+};
+
+struct PackedBlock {
+    IntEncoding encoding = IntEncoding::FOR;
+    uint8_t width = 0;       // Bits per offset; 0 when every offset is zero and no words are stored
+    uint32_t rows = 0;
+    uint32_t first_word = 0;
+    int64_t min = 0;
+    int64_t max = 0;
+    uint64_t step = 0;       // DELTA only
+    std::array<int64_t, packed_lanes> starts{}; // DELTA only
+};
+
+// A packed column of INT32 or INT64 values. Packing is done once, when a segment is sealed; reads decode a block at a
+// time, and range predicates on FOR blocks are evaluated on the offsets without decoding the values.
+class PackedInts {
+private:
+    size_t size_ = 0;
+    std::vector<PackedBlock> blocks_;
+    AlignedVector<uint64_t> words_;
+
+    void unpack_offsets(const PackedBlock &block, uint64_t *out) const;
+
+public:
+    // Pack `values`; T is int32_t or int64_t
+    template <typename T>
+    static PackedInts pack(std::span<const T> values);
+
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] const std::vector<PackedBlock> &blocks() const { return blocks_; }
+    // Bytes held by the packed words and the block headers
+    [[nodiscard]] size_t byte_size() const {
+        return words_.size() * sizeof(uint64_t) + blocks_.size() * sizeof(PackedBlock);
+    }
+
+    // Decode the values of block `block` into `out`, which must have room for its rows
+    template <typename T>
+    void decode_block(size_t block, T *out) const;
+
+    // Value of one row: a few shifts for a FOR block, a decode of the block up to the row for DELTA
+    [[nodiscard]] int64_t value(size_t row) const;
+
+    // Overwrite `selected`, one bit per row ((size() + 63) / 64 words), with the rows whose value lies in
+    // [low, high]. Blocks whose min / max fall entirely inside or outside the range are answered without reading
+    // their words; FOR blocks compare the offsets against the range shifted by the block minimum.
+    void select_range(int64_t low, int64_t high, uint64_t *selected) const;
+};
+
+#endif //FLUXO_DB_INT_PACKING_H
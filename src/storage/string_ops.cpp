@@ -0,0 +1,217 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "string_ops.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+// Build the selection one 64-row word at a time from `match(row)`, clearing NULL rows; returns the popcount
+template <typename Match>
+size_t select_rows(const ColumnSegment &segment, std::vector<uint64_t> &selected, const Match &match) {
+    const size_t rows = segment.size();
+    const std::span<const uint64_t> nulls = segment.null_words();
+    selected.assign((rows + 63) / 64, 0);
+    size_t count = 0;
+    for (size_t word = 0; word < selected.size(); ++word) {
+        const size_t begin = word * 64;
+        uint64_t bits = 0;
+        if (begin + 64 <= rows) {
+            // Fixed trip count, so the compiler can vectorize the compares of a full word
+            for (size_t bit = 0; bit < 64; ++bit) {
+                bits |= uint64_t{match(begin + bit)} << bit;
+            }
+        } else {
+            for (size_t row = begin; row < rows; ++row) {
+                bits |= uint64_t{match(row)} << (row - begin);
+            }
+        }
+        if (word < nulls.size()) {
+            bits &= ~nulls[word];
+        }
+        selected[word] = bits;
+        count += static_cast<size_t>(std::popcount(bits));
+    }
+    return count;
+}
+
+} // namespace
+
+size_t select_equal(const ColumnSegment &segment, const std::string_view value, std::vector<uint64_t> &selected) {
+    if (segment.encoding() == StringEncoding::DICTIONARY) {
+        const std::optional<uint16_t> code = segment.find_code(value);
+        if (!code) {
+            selected.assign((segment.size() + 63) / 64, 0);
+            return 0;
+        }
+        const uint16_t *codes = segment.codes().data();
+        return select_rows(segment, selected, [codes, wanted = *code](const size_t row) {
+            return codes[row] == wanted;
+        });
+    }
+    const StringRef probe(value);
+    const StringRef *strings = segment.strings().data();
+    return select_rows(segment, selected, [strings, &probe](const size_t row) { return strings[row] == probe; });
+}
+
+size_t select_in(const ColumnSegment &segment, const std::span<const std::string_view> values,
+                 std::vector<uint64_t> &selected) {
+    if (segment.encoding() == StringEncoding::DICTIONARY) {
+        // One membership flag per dictionary entry, so each row is a single table lookup
+        std::vector<uint8_t> member(segment.dictionary_size(), 0);
+        for (const std::string_view value : values) {
+            if (const std::optional<uint16_t> code = segment.find_code(value)) {
+                member[*code] = 1;
+            }
+        }
+        const uint16_t *codes = segment.codes().data();
+        return select_rows(segment, selected, [codes, &member](const size_t row) { return member[codes[row]] != 0; });
+    }
+    const std::vector<StringRef> probes(values.begin(), values.end());
+    const StringRef *strings = segment.strings().data();
+    return select_rows(segment, selected, [strings, &probes](const size_t row) {
+        for (const StringRef &probe : probes) {
+            if (strings[row] == probe) return true;
+        }
+        return false;
+    });
+}
+
+void sort_rows(const ColumnSegment &segment, std::vector<uint32_t> &rows) {
+    const size_t first = rows.size();
+    if (segment.encoding() == StringEncoding::DICTIONARY) {
+        // Rank the entries, then place the rows with a counting sort over the ranks; NULLs go after every rank
+        const std::span<const StringRef> entries = segment.strings();
+        std::vector<uint32_t> order(entries.size());
+        std::iota(order.begin(), order.end(), uint32_t{0});
+        std::ranges::sort(order, [entries](const uint32_t a, const uint32_t b) { return entries[a] < entries[b]; });
+        std::vector<uint32_t> rank(entries.size());
+        for (size_t position = 0; position < order.size(); ++position) {
+            rank[order[position]] = static_cast<uint32_t>(position);
+        }
+        const auto bucket_of = [&](const size_t row) {
+            return segment.is_null(row) ? entries.size() : rank[segment.codes()[row]];
+        };
+        std::vector<size_t> starts(entries.size() + 2, 0);
+        for (size_t row = 0; row < segment.size(); ++row) {
+            ++starts[bucket_of(row) + 1];
+        }
+        std::partial_sum(starts.begin(), starts.end(), starts.begin());
+        rows.resize(first + segment.size());
+        for (size_t row = 0; row < segment.size(); ++row) {
+            rows[first + starts[bucket_of(row)]++] = static_cast<uint32_t>(row);
+        }
+        return;
+    }
+    rows.resize(first + segment.size());
+    const auto sorted = std::span(rows).subspan(first);
+    std::iota(sorted.begin(), sorted.end(), uint32_t{0});
+    const StringRef *strings = segment.strings().data();
+    std::ranges::stable_sort(sorted, [&segment, strings](const uint32_t a, const uint32_t b) {
+        const bool a_null = segment.is_null(a);
+        const bool b_null = segment.is_null(b);
+        return a_null != b_null ? b_null : !a_null && strings[a] < strings[b];
+    });
+}
+
+uint32_t StringGroups::id_of(const StringRef &value) {
+    if (const auto it = ids_.find(value); it != ids_.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<uint32_t>(keys_.size());
+    const StringRef key(value.view(), arena_);
+    ids_.emplace(key, id);
+    keys_.emplace_back(key);
+    return id;
+}
+
+uint32_t StringGroups::null_id() {
+    if (!null_id_) {
+        null_id_ = static_cast<uint32_t>(keys_.size());
+        keys_.emplace_back(std::nullopt);
+    }
+    return *null_id_;
+}
+
+std::vector<uint32_t> StringGroups::map_dictionary(const ColumnSegment &segment, const std::vector<bool> &used) {
+    std::vector<uint32_t> ids(segment.dictionary_size(), std::numeric_limits<uint32_t>::max());
+    for (size_t code = 0; code < ids.size(); ++code) {
+        if (used[code]) {
+            ids[code] = id_of(segment.strings()[code]);
+        }
+    }
+    return ids;
+}
+
+void StringGroups::assign(const ColumnSegment &segment, std::vector<uint32_t> &ids) {
+    const size_t first = ids.size();
+    ids.resize(first + segment.size());
+    uint32_t *out = ids.data() + first;
+    if (segment.encoding() == StringEncoding::DICTIONARY) {
+        const std::span<const uint16_t> codes = segment.codes();
+        std::vector<bool> used(segment.dictionary_size(), false);
+        for (size_t row = 0; row < codes.size(); ++row) {
+            used[codes[row]] = used[codes[row]] || !segment.is_null(row);
+        }
+        const std::vector<uint32_t> group_of_code = map_dictionary(segment, used);
+        for (size_t row = 0; row < codes.size(); ++row) {
+            out[row] = group_of_code[codes[row]];
+        }
+    } else {
+        // A NULL row's slot holds an empty placeholder, not a value: the loop below gives it the NULL group
+        for (size_t row = 0; row < segment.size(); ++row) {
+            if (!segment.is_null(row)) {
+                out[row] = id_of(segment.string_ref(row));
+            }
+        }
+    }
+    if (segment.null_count() > 0) {
+        const uint32_t null_group = null_id();
+        for (size_t row = 0; row < segment.size(); ++row) {
+            out[row] = segment.is_null(row) ? null_group : out[row];
+        }
+    }
+}
+
+void StringGroups::add_distinct(const ColumnSegment &segment) {
+    if (segment.encoding() == StringEncoding::DICTIONARY) {
+        const std::span<const uint16_t> codes = segment.codes();
+        std::vector<bool> used(segment.dictionary_size(), false);
+        for (size_t row = 0; row < codes.size(); ++row) {
+            used[codes[row]] = used[codes[row]] || !segment.is_null(row);
+        }
+        map_dictionary(segment, used);
+    } else {
+        for (size_t row = 0; row < segment.size(); ++row) {
+            if (!segment.is_null(row)) {
+                id_of(segment.string_ref(row));
+            }
+        }
+    }
+    if (segment.null_count() > 0) {
+        null_id();
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_STRING_OPS_H
+#define FLUXO_DB_STRING_OPS_H
+#pragma once
+#include "column.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Predicates, grouping and ordering over STRING segments. On a dictionary segment each one resolves the strings it
+// needs against the dictionary once and then works on the 16-bit row codes alone; plain segments compare StringRefs,
+// which settles most rows on the length and 4-byte prefix. NULL rows never match a predicate.
+
+// Set bit i of `selected` (resized to one bit per row) for every row equal to `value`; returns the number of matches
+size_t select_equal(const ColumnSegment &segment, std::string_view value, std::vector<uint64_t> &selected);
+
+// The same for rows equal to any of `values` (an IN list)
+size_t select_in(const ColumnSegment &segment, std::span<const std::string_view> values,
+                 std::vector<uint64_t> &selected);
+
+// Append the rows of `segment` to `rows` in ascending order of value (ORDER BY ... ASC NULLS LAST), ties in row
+// order. A dictionary is sorted once and its rows are then placed by code.
+void sort_rows(const ColumnSegment &segment, std::vector<uint32_t> &rows);
+
+// Dense ids for the distinct values of a string column, shared across all the segments fed to it: GROUP BY assigns
+// each row the id of its value, DISTINCT only collects the values. All NULL rows form one group. Keys are StringRefs
+// with their long payloads in the groups' own arena, so they outlive the segments.
+class StringGroups {
+private:
+    StringArena arena_;
+    std::unordered_map<StringRef, uint32_t> ids_;
+    std::vector<std::optional<StringRef>> keys_;
+    std::optional<uint32_t> null_id_;
+
+    uint32_t id_of(const StringRef &value);
+    uint32_t null_id();
+    // Group id of every dictionary entry of `segment` that `used` marks
+    std::vector<uint32_t> map_dictionary(const ColumnSegment &segment, const std::vector<bool> &used);
+
+public:
+    // Append the group id of each row of `segment`, in row order, to `ids`
+    void assign(const ColumnSegment &segment, std::vector<uint32_t> &ids);
+    // Add the values of `segment` without assigning rows
+    void add_distinct(const ColumnSegment &segment);
+
+    [[nodiscard]] size_t size() const { return keys_.size(); }
+    // Value of group `id`, good until the next assign() or add_distinct(); nullopt for the NULL group
+    [[nodiscard]] std::optional<std::string_view> key(const uint32_t id) const {
+        return keys_[id] ? std::optional(keys_[id]->view()) : std::nullopt;
+    }
+};
+
+#endif //FLUXO_DB_STRING_OPS_H
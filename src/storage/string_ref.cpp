@@ -0,0 +1,64 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "string_ref.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t first_chunk_size = 4096;
+constexpr size_t max_chunk_size = size_t{1} << 20;
+
+} // namespace
+
+const char *StringArena::store(const std::string_view value) {
+    if (value.size() > chunk_size_ - chunk_used_) {
+        // Chunks double up to a cap; a value bigger than that gets a chunk of its own size
+        const size_t next = chunks_.empty() ? first_chunk_size : std::min(chunk_size_ * 2, max_chunk_size);
+        chunk_size_ = std::max(value.size(), next);
+        chunks_.push_back(std::make_unique_for_overwrite<char[]>(chunk_size_));
+        chunk_used_ = 0;
+    }
+    char *payload = chunks_.back().get() + chunk_used_;
+    std::memcpy(payload, value.data(), value.size());
+    chunk_used_ += value.size();
+    bytes_ += value.size();
+    return payload;
+}
+
+void StringRef::init(const std::string_view value, const char *payload) {
+    if (value.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("String exceeds 4 GiB");
+    }
+    length_ = static_cast<uint32_t>(value.size());
+    if (is_inline()) {
+        if (!value.empty()) { // An empty view may carry a null pointer, which memcpy does not accept
+            std::memcpy(data_.data(), value.data(), value.size());
+        }
+    } else {
+        std::memcpy(data_.data(), value.data(), 4);
+        std::memcpy(data_.data() + 4, &payload, sizeof(payload));
+    }
+}
@@ -0,0 +1,146 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_STRING_REF_H
+#define FLUXO_DB_STRING_REF_H
+#pragma once
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Owner of the payloads of long StringRefs: a bump allocator over chunks that never move, so a payload stays where it
+// is for the life of the arena, moves of the arena included. Nothing is freed before the arena dies.
+class StringArena {
+private:
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    size_t chunk_size_ = 0;
+    size_t chunk_used_ = 0;
+    size_t bytes_ = 0;
+
+public:
+    StringArena() = default;
+    StringArena(StringArena &&) noexcept = default;
+    StringArena &operator=(StringArena &&) noexcept = default;
+    StringArena(const StringArena &) = delete;
+    StringArena &operator=(const StringArena &) = delete;
+
+    // Copy `value` into the arena and return where it now lives
+    const char *store(std::string_view value);
+
+    // Payload bytes stored so far
+    [[nodiscard]] size_t bytes() const { return bytes_; }
+};
+
+// A 16-byte string handle: a 4-byte length, then either the whole string (up to 12 bytes, zero padded) or its first 4
+// bytes and a pointer to the full payload. Short strings never leave the handle, and for long ones the length and
+// prefix settle most comparisons, so equality, ordering and hashing touch the payload only when the first four bytes
+// tie. A handle does not own a long payload: it points into a StringArena, or into the caller's memory when borrowed.
+class StringRef {
+public:
+    static constexpr size_t inline_capacity = 12;
+
+private:
+    uint32_t length_ = 0;
+    std::array<char, 12> data_{}; // Inline: the string. Otherwise: the prefix, then the payload pointer.
+
+    void init(std::string_view value, const char *payload);
+
+    [[nodiscard]] const char *pointer() const {
+        const char *payload;
+        std::memcpy(&payload, data_.data() + 4, sizeof(payload));
+        return payload;
+    }
+    // The first four bytes as a big-endian number, so numeric order is byte order
+    [[nodiscard]] uint32_t prefix_key() const {
+        uint32_t prefix;
+        std::memcpy(&prefix, data_.data(), sizeof(prefix));
+        return std::endian::native == std::endian::little ? std::byteswap(prefix) : prefix;
+    }
+
+public:
+    StringRef() = default;
+    // Borrow `value`: a long value is not copied, so it must outlive the handle (probes and other short-lived handles)
+    explicit StringRef(const std::string_view value) { init(value, value.data()); }
+    // Copy `value`, storing a long payload in `arena`. Throws std::length_error past 4 GiB.
+    StringRef(const std::string_view value, StringArena &arena) {
+        init(value, nullptr);
+        if (!is_inline()) {
+            const char *payload = arena.store(value);
+            std::memcpy(data_.data() + 4, &payload, sizeof(payload));
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return length_; }
+    [[nodiscard]] bool is_inline() const { return length_ <= inline_capacity; }
+    // For an inline string the view points into the handle itself
+    [[nodiscard]] std::string_view view() const { return {is_inline() ? data_.data() : pointer(), length_}; }
+
+    bool operator==(const StringRef &other) const {
+        if (length_ != other.length_ || prefix_key() != other.prefix_key()) {
+            return false;
+        }
+        if (is_inline()) {
+            return std::memcmp(data_.data() + 4, other.data_.data() + 4, 8) == 0;
+        }
+        return std::memcmp(pointer() + 4, other.pointer() + 4, length_ - 4) == 0;
+    }
+
+    // Byte order, as std::string_view compares
+    std::strong_ordering operator<=>(const StringRef &other) const {
+        if (const uint32_t prefix = prefix_key(), other_prefix = other.prefix_key(); prefix != other_prefix) {
+            return prefix <=> other_prefix;
+        }
+        return view().compare(other.view()) <=> 0;
+    }
+
+    // Inline strings hash their 16 bytes without looking at a payload; a long string never equals an inline one, so
+    // long strings are free to hash the full text instead
+    [[nodiscard]] size_t hash() const {
+        if (!is_inline()) {
+            return std::hash<std::string_view>{}(view());
+        }
+        uint64_t low;
+        uint64_t high;
+        std::memcpy(&low, data_.data(), sizeof(low));
+        std::memcpy(&high, data_.data() + 4, sizeof(high));
+        uint64_t hash = (low ^ uint64_t{length_} << 59) * 0x9e3779b97f4a7c15 ^ high;
+        hash ^= hash >> 32;
+        hash *= 0xbf58476d1ce4e5b9;
+        return static_cast<size_t>(hash ^ hash >> 29);
+    }
+};
+
+static_assert(sizeof(StringRef) == 16);
+
+template <>
+struct std::hash<StringRef> {
+    size_t operator()(const StringRef &text) const noexcept { return text.hash(); }
+};
+
+#endif //FLUXO_DB_STRING_REF_H
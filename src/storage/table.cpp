@@ -0,0 +1,343 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "table.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+[[noreturn]] void reject(const ColumnDef &column, const std::string &problem) {
+    throw std::invalid_argument("Column " + column.name.str() + ": " + problem);
+}
+
+bool takes_integers(const DataType type) {
+    return type != DataType::BOOLEAN && type != DataType::TEXT && type != DataType::VARCHAR;
+}
+
+bool takes_strings(const DataType type) {
+    return type == DataType::TEXT || type == DataType::VARCHAR;
+}
+
+int32_t narrow(const ColumnDef &column, const int64_t value) {
+    if (value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+        throw std::out_of_range("Column " + column.name.str() + ": value " + std::to_string(value) +
+                                " does not fit a 32-bit integer");
+    }
+    return static_cast<int32_t>(value);
+}
+
+void store_null(ColumnSegment &segment, const ColumnDef &column) {
+    if (column.not_null) {
+        reject(column, "NULL in a NOT NULL column");
+    }
+    segment.append_null();
+}
+
+void store_integer(ColumnSegment &segment, const ColumnDef &column, const int64_t value) {
+    switch (segment.type()) {
+        case PhysicalType::INT32: segment.append_int32(narrow(column, value)); break;
+        case PhysicalType::INT64: segment.append_int64(value); break;
+        case PhysicalType::DOUBLE: segment.append_double(static_cast<double>(value)); break;
+        default: reject(column, "integer in a non-numeric column");
+    }
+}
+
+void store_literal(ColumnSegment &segment, const ColumnDef &column, const LiteralValue &literal) {
+    if (const auto *integer = std::get_if<int64_t>(&literal.value)) {
+        store_integer(segment, column, *integer);
+    } else if (const auto *real = std::get_if<double>(&literal.value)) {
+        if (column.type != DataType::DOUBLE) {
+            reject(column, "decimal in a non-DOUBLE column");
+        }
+        segment.append_double(*real);
+    } else if (const auto *boolean = std::get_if<bool>(&literal.value)) {
+        if (column.type != DataType::BOOLEAN) {
+            reject(column, "boolean in a non-BOOLEAN column");
+        }
+        segment.append_bool(*boolean);
+    } else if (const auto *text = std::get_if<std::string>(&literal.value)) {
+        if (!takes_strings(column.type)) {
+            reject(column, "string in a non-text column");
+        }
+        segment.append_string(*text);
+    } else {
+        store_null(segment, column);
+    }
+}
+
+// Append rows [begin, begin + count) of a bulk VALUES column. The type check is made once for the whole run, so the
+// loops below only copy (and, for INTEGER, range check).
+void store_buffer(ColumnSegment &segment, const ColumnDef &column, const ColumnBuffer &buffer, const size_t begin,
+                  const size_t count) {
+    const size_t end = begin + count;
+    if (column.not_null && !buffer.nulls.empty()) {
+        for (size_t row = begin; row < end; ++row) {
+            if (buffer.is_null(row)) {
+                reject(column, "NULL in a NOT NULL column");
+            }
+        }
+    }
+    switch (buffer.type) {
+        case DataType::NULL_TYPE:
+            for (size_t row = begin; row < end; ++row) {
+                store_null(segment, column);
+            }
+            return;
+        case DataType::DOUBLE:
+            if (column.type != DataType::DOUBLE) {
+                reject(column, "decimal in a non-DOUBLE column");
+            }
+            break;
+        case DataType::TEXT:
+            if (!takes_strings(column.type)) {
+                reject(column, "string in a non-text column");
+            }
+            break;
+        case DataType::BOOLEAN:
+            if (column.type != DataType::BOOLEAN) {
+                reject(column, "boolean in a non-BOOLEAN column");
+            }
+            break;
+        default:
+            if (!takes_integers(column.type)) {
+                reject(column, "integer in a non-numeric column");
+            }
+            break;
+    }
+
+    segment.reserve(segment.size() + count);
+    const auto copy = [&](const auto &append) {
+        for (size_t row = begin; row < end; ++row) {
+            if (buffer.is_null(row)) {
+                segment.append_null();
+            } else {
+                append(row);
+            }
+        }
+    };
+    switch (buffer.type) {
+        case DataType::DOUBLE:
+            copy([&](const size_t row) { segment.append_double(buffer.doubles[row]); });
+            break;
+        case DataType::TEXT:
+            copy([&](const size_t row) {
+                const uint32_t offset = buffer.string_offsets[row];
+                segment.append_string(std::string_view(buffer.string_data).substr(offset, buffer.string_offsets[row + 1] - offset));
+            });
+            break;
+        case DataType::BOOLEAN:
+            copy([&](const size_t row) { segment.append_bool(buffer.integers[row] != 0); });
+            break;
+        default:
+            copy([&](const size_t row) { store_integer(segment, column, buffer.integers[row]); });
+            break;
+    }
+}
+
+} // namespace
+
+Table::Table(const CreateTableStmt &stmt, const size_t row_group_rows)
+    : name_(stmt.table_name), columns_(stmt.columns), row_group_rows_(row_group_rows) {
+    if (row_group_rows_ == 0 || row_group_rows_ % 64 != 0) {
+        throw std::invalid_argument("Row group size must be a positive multiple of 64");
+    }
+    if (columns_.empty()) {
+        throw std::invalid_argument("Table " + name_.str() + " has no columns");
+    }
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        ColumnDef &column = columns_[i];
+        physical_type(column.type); // Throws for a column without a storable type
+        if (!column_ids_.emplace(column.name, i).second) {
+            reject(column, "declared twice");
+        }
+        column.not_null = column.not_null || column.primary_key;
+    }
+    for (const TableConstraint &constraint : stmt.constraints) {
+        if (constraint.type != TableConstraint::Type::PRIMARY_KEY) {
+            continue;
+        }
+        for (const Symbol &name : constraint.columns) {
+            const std::optional<size_t> index = column_index(name);
+            if (!index) {
+                throw std::invalid_argument("Primary key of table " + name_.str() + " names unknown column " +
+                                            name.str());
+            }
+            columns_[*index].not_null = true;
+        }
+    }
+}
+
+std::optional<size_t> Table::column_index(const Symbol &name) const {
+    if (const auto it = column_ids_.find(name); it != column_ids_.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+RowGroup &Table::writable_group() {
+    if (row_groups_.empty() || row_groups_.back().row_count == row_group_rows_) {
+        RowGroup &group = row_groups_.emplace_back();
+        group.first_row = row_count_;
+        group.columns.reserve(columns_.size());
+        for (const ColumnDef &column : columns_) {
+            group.columns.emplace_back(physical_type(column.type));
+        }
+    }
+    return row_groups_.back();
+}
+
+void Table::seal_if_full(RowGroup &group) const {
+    if (group.row_count == row_group_rows_) {
+        for (ColumnSegment &segment : group.columns) {
+            segment.seal();
+        }
+    }
+}
+
+void Table::append_values(const std::vector<Expr> &values, const std::span<const size_t> targets) {
+    if (values.size() != targets.size()) {
+        throw std::invalid_argument("INSERT row has " + std::to_string(values.size()) + " values for " +
+                                    std::to_string(targets.size()) + " columns");
+    }
+    RowGroup &group = writable_group();
+    std::vector<const LiteralValue *> row(columns_.size(), nullptr);
+    for (size_t i = 0; i < values.size(); ++i) {
+        const auto *literal = std::get_if<LiteralValue>(&values[i]);
+        if (literal == nullptr) {
+            reject(columns_[targets[i]], "value is not a constant");
+        }
+        row[targets[i]] = literal;
+    }
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (row[i] != nullptr) {
+            store_literal(group.columns[i], columns_[i], *row[i]);
+        } else {
+            store_null(group.columns[i], columns_[i]);
+        }
+    }
+    ++group.row_count;
+    ++row_count_;
+    seal_if_full(group);
+}
+
+void Table::append_bulk(const BulkValues &bulk, const std::span<const size_t> targets) {
+    if (bulk.columns.size() != targets.size()) {
+        throw std::invalid_argument("INSERT row has " + std::to_string(bulk.columns.size()) + " values for " +
+                                    std::to_string(targets.size()) + " columns");
+    }
+    std::vector<const ColumnBuffer *> sources(columns_.size(), nullptr);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        sources[targets[i]] = &bulk.columns[i];
+    }
+
+    // Fill one row group at a time, column by column
+    for (size_t begin = 0; begin < bulk.row_count;) {
+        RowGroup &group = writable_group();
+        const size_t count = std::min(row_group_rows_ - group.row_count, bulk.row_count - begin);
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            if (sources[i] != nullptr) {
+                store_buffer(group.columns[i], columns_[i], *sources[i], begin, count);
+            } else {
+                for (size_t row = 0; row < count; ++row) {
+                    store_null(group.columns[i], columns_[i]);
+                }
+            }
+        }
+        group.row_count += count;
+        row_count_ += count;
+        begin += count;
+        seal_if_full(group);
+    }
+}
+
+size_t Table::insert(const InsertStmt &stmt) {
+    std::vector<size_t> targets(columns_.size());
+    if (stmt.columns.empty()) {
+        std::iota(targets.begin(), targets.end(), size_t{0});
+    } else {
+        targets.clear();
+        for (const Symbol &name : stmt.columns) {
+            const std::optional<size_t> index = column_index(name);
+            if (!index) {
+                throw std::invalid_argument("Table " + name_.str() + " has no column " + name.str());
+            }
+            if (std::find(targets.begin(), targets.end(), *index) != targets.end()) {
+                reject(columns_[*index], "listed twice in INSERT");
+            }
+            targets.push_back(*index);
+        }
+    }
+
+    const size_t before = row_count_;
+    try {
+        if (stmt.bulk) {
+            append_bulk(*stmt.bulk, targets);
+        } else {
+            for (const std::vector<Expr> &values : stmt.values) {
+                append_values(values, targets);
+            }
+        }
+    } catch (...) {
+        truncate(before);
+        throw;
+    }
+    return row_count_ - before;
+}
+
+LiteralValue Table::value(const size_t row, const size_t column) const {
+    if (row >= row_count_ || column >= columns_.size()) {
+        throw std::out_of_range("Table cell out of range");
+    }
+    const ColumnSegment &segment = row_groups_[row / row_group_rows_].columns[column];
+    const size_t slot = row % row_group_rows_;
+    const DataType type = columns_[column].type;
+    if (segment.is_null(slot)) {
+        return LiteralValue::Null();
+    }
+    switch (segment.type()) {
+        case PhysicalType::INT32:
+        case PhysicalType::INT64: return LiteralValue{type, segment.integer(slot)};
+        case PhysicalType::DOUBLE: return LiteralValue::Double(segment.doubles()[slot]);
+        case PhysicalType::BIT: return LiteralValue::Boolean(segment.boolean(slot));
+        case PhysicalType::STRING: return LiteralValue{type, std::string(segment.string(slot))};
+    }
+    return LiteralValue::Null();
+}
+
+void Table::truncate(const size_t rows) {
+    while (!row_groups_.empty() && row_groups_.back().first_row >= rows) {
+        row_groups_.pop_back();
+    }
+    if (!row_groups_.empty()) {
+        // Segments can run ahead of the group's row count when a row failed half way, so each one is trimmed
+        RowGroup &group = row_groups_.back();
+        group.row_count = std::min(group.row_count, rows - group.first_row);
+        for (ColumnSegment &segment : group.columns) {
+            segment.truncate(group.row_count);
+        }
+    }
+    row_count_ = std::min(row_count_, rows);
+}
@@ -0,0 +1,95 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_TABLE_H
+#define FLUXO_DB_TABLE_H
+#pragma once
+#include "column.h"
+#include "../ast/ast_statements.h"
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Rows per row group unless a table asks for another size
+inline constexpr size_t default_row_group_rows = size_t{1} << 16;
+
+// A horizontal slice of a table: one segment per column, each holding the same `row_count` rows. Every row group
+// but the last is full.
+struct RowGroup {
+    size_t first_row = 0;
+    size_t row_count = 0;
+    std::vector<ColumnSegment> columns;
+};
+
+// In-memory columnar table built from a CREATE TABLE statement. Rows are split into row groups of a fixed size and
+// stored column by column, one typed segment per column and group (see ColumnSegment), so a scan reads each column
+// it needs as a contiguous array instead of unpacking boxed values. A row group is sealed once it fills, which is
+// when its string columns settle on dictionary or plain encoding.
+//
+// Values are stored under the column's declared type: integer literals go into INTEGER (range checked), BIGINT and
+// DOUBLE columns, and into DATE and TIMESTAMP columns as their day / microsecond count until the parser has date
+// literals; decimal literals go into DOUBLE, strings into TEXT and VARCHAR, and TRUE / FALSE into BOOLEAN.
+// NOT NULL is enforced, with primary key columns counting as NOT NULL; uniqueness is not (there are no indexes yet).
+class Table {
+private:
+    Symbol name_;
+    std::vector<ColumnDef> columns_;
+    std::unordered_map<Symbol, size_t> column_ids_;
+    size_t row_group_rows_;
+    size_t row_count_ = 0;
+    std::vector<RowGroup> row_groups_;
+
+    RowGroup &writable_group();
+    void seal_if_full(RowGroup &group) const;
+    void append_values(const std::vector<Expr> &values, std::span<const size_t> targets);
+    void append_bulk(const BulkValues &bulk, std::span<const size_t> targets);
+
+public:
+    // Throws std::invalid_argument when the statement declares no columns, a column twice, a column without a
+    // storable type or a primary key over an unknown column, or when `row_group_rows` is not a positive multiple of 64
+    explicit Table(const CreateTableStmt &stmt, size_t row_group_rows = default_row_group_rows);
+
+    [[nodiscard]] const Symbol &name() const { return name_; }
+    [[nodiscard]] const std::vector<ColumnDef> &columns() const { return columns_; }
+    [[nodiscard]] std::optional<size_t> column_index(const Symbol &name) const;
+
+    [[nodiscard]] size_t row_count() const { return row_count_; }
+    [[nodiscard]] size_t row_group_rows() const { return row_group_rows_; }
+    [[nodiscard]] const std::vector<RowGroup> &row_groups() const { return row_groups_; }
+
+    // Append the VALUES rows of an INSERT aimed at this table and return how many were added. Every value must be a
+    // literal (fold_constants turns constant expressions into one); columns missing from the statement's column
+    // list are NULL. The insert is all or nothing: on a type mismatch, a NULL in a NOT NULL column, an unknown
+    // column or a row of the wrong width it throws std::invalid_argument, and std::out_of_range for an INTEGER that
+    // does not fit 32 bits, leaving the table as it was.
+    size_t insert(const InsertStmt &stmt);
+
+    // Value at (`row`, `column`), typed as the column is declared; a NULL literal for NULL
+    [[nodiscard]] LiteralValue value(size_t row, size_t column) const;
+
+    // Drop every row from `rows` on
+    void truncate(size_t rows);
+};
+
+#endif //FLUXO_DB_TABLE_H
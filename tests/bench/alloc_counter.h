@@ -0,0 +1,31 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#ifndef FLUXO_DB_ALLOC_COUNTER_H
+#define FLUXO_DB_ALLOC_COUNTER_H
+#include <cstddef>
+
+// Number of global operator new calls made by this process so far. The benchmark binary replaces the global
+// allocation functions to count them; take the difference around the code being measured.
+size_t allocationCount();
+
+#endif //FLUXO_DB_ALLOC_COUNTER_H
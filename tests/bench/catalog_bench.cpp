@@ -0,0 +1,89 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/catalog/catalog.h"
+#include "../../src/parser/parser.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t catalogTables = 1000;
+
+Catalog &filledCatalog() {
+    static Catalog catalog;
+    static const bool filled = [] {
+        std::string sql;
+        for (size_t i = 0; i < catalogTables; ++i) {
+            sql += "CREATE TABLE t" + std::to_string(i) + " (id BIGINT PRIMARY KEY, name TEXT, total DOUBLE);";
+        }
+        Lexer lexer(sql);
+        Parser parser(lexer);
+        for (const Statement &statement : parser.parse()) {
+            catalog.apply(statement);
+        }
+        return true;
+    }();
+    benchmark::DoNotOptimize(filled);
+    return catalog;
+}
+
+std::vector<Symbol> tableNames() {
+    std::vector<Symbol> names;
+    for (size_t i = 0; i < catalogTables; ++i) {
+        names.emplace_back("t" + std::to_string(i));
+    }
+    return names;
+}
+
+// Name resolution on the query path: pin a version, look up a table and one of its columns
+void BM_ResolveTable(benchmark::State &state) {
+    Catalog &catalog = filledCatalog();
+    const std::vector<Symbol> names = tableNames();
+    const Symbol column("total");
+    const SearchPath path;
+    size_t next = static_cast<size_t>(state.thread_index()) * 7919;
+    for (auto _ : state) {
+        const CatalogView view = catalog.view();
+        const TableEntry *table = view->table(path, names[next++ % names.size()]);
+        benchmark::DoNotOptimize(table->column(column));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ResolveTable)->ThreadRange(1, 8)->UseRealTime();
+
+// Publishing a version: one ALTER TABLE against a catalog of catalogTables tables
+void BM_PublishDdl(benchmark::State &state) {
+    Catalog &catalog = filledCatalog();
+    Lexer lexer(std::string("ALTER TABLE t0 ALTER COLUMN name SET NOT NULL;"
+                            "ALTER TABLE t0 ALTER COLUMN name DROP NOT NULL;"));
+    Parser parser(lexer);
+    const std::vector<Statement> statements = parser.parse();
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(catalog.apply(statements[next++ % statements.size()]));
+    }
+}
+BENCHMARK(BM_PublishDdl);
+
+} // namespace
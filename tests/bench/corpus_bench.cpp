@@ -0,0 +1,83 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <benchmark/benchmark.h>
+#include "alloc_counter.h"
+#include "sql_corpus.h"
+#include "../../src/lexer/lexer.h"
+#include "../../src/parser/parser.h"
+
+namespace {
+
+// Throughput (MB/s, statements/s) and allocations per statement for one pass over a corpus
+void reportCorpus(benchmark::State &state, const SqlCorpus &corpus, const size_t allocations) {
+    const auto statements = static_cast<int64_t>(corpus.statements);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(corpus.sql.size()));
+    state.counters["stmts/s"] = benchmark::Counter(static_cast<double>(statements), benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["allocs/stmt"] = benchmark::Counter(static_cast<double>(allocations) /
+                                                       static_cast<double>(statements * state.iterations()));
+}
+
+void BM_LexCorpus(benchmark::State &state, const CorpusKind kind) {
+    const SqlCorpus &corpus = sqlCorpus(kind);
+    size_t allocations = 0;
+    for (auto _ : state) {
+        const size_t before = allocationCount();
+        Lexer lexer(std::string_view(corpus.sql), borrow_input);
+        for (Token tok = lexer.NextToken(); tok.type != TokenType::EOF_TOKEN; tok = lexer.NextToken()) {
+            benchmark::DoNotOptimize(tok);
+        }
+        allocations += allocationCount() - before;
+    }
+    reportCorpus(state, corpus, allocations);
+}
+
+void BM_ParseCorpus(benchmark::State &state, const CorpusKind kind) {
+    const SqlCorpus &corpus = sqlCorpus(kind);
+    size_t allocations = 0;
+    for (auto _ : state) {
+        const size_t before = allocationCount();
+        Lexer lexer(std::string_view(corpus.sql), borrow_input);
+        Parser parser(lexer);
+        auto statements = parser.parse();
+        benchmark::DoNotOptimize(statements);
+        allocations += allocationCount() - before;
+        state.PauseTiming(); // Freeing the trees is not part of parsing
+        statements.clear();
+        state.ResumeTiming();
+    }
+    reportCorpus(state, corpus, allocations);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_LexCorpus, narrow_select, CorpusKind::NARROW_SELECT);
+BENCHMARK_CAPTURE(BM_LexCorpus, wide_select, CorpusKind::WIDE_SELECT);
+BENCHMARK_CAPTURE(BM_LexCorpus, bulk_insert, CorpusKind::BULK_INSERT);
+BENCHMARK_CAPTURE(BM_LexCorpus, nested_expression, CorpusKind::NESTED_EXPRESSION);
+BENCHMARK_CAPTURE(BM_LexCorpus, ddl, CorpusKind::DDL);
+
+BENCHMARK_CAPTURE(BM_ParseCorpus, narrow_select, CorpusKind::NARROW_SELECT)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseCorpus, wide_select, CorpusKind::WIDE_SELECT)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseCorpus, bulk_insert, CorpusKind::BULK_INSERT)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseCorpus, nested_expression, CorpusKind::NESTED_EXPRESSION)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseCorpus, ddl, CorpusKind::DDL)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,106 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/ir/expr_ir.h"
+#include "../../src/parser/parser.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+// Projections of a few hundred nodes each, parsed once and shared by every benchmark
+std::vector<Expr> parsedExpressions(const size_t count, const size_t terms) {
+    std::string sql = "SELECT ";
+    for (size_t e = 0; e < count; ++e) {
+        if (e > 0) sql += ", ";
+        for (size_t t = 0; t < terms; ++t) {
+            if (t > 0) sql += t % 3 == 0 ? " + " : " * ";
+            sql += t % 2 == 0 ? "c" + std::to_string(t % 7) : std::to_string(t);
+        }
+    }
+    sql += " FROM t;";
+    Lexer lexer(sql);
+    Parser parser(lexer);
+    auto statements = parser.parse();
+    return std::move(std::get<SelectStmt>(statements[0]).projections);
+}
+
+const std::vector<Expr> &expressions() {
+    static const std::vector<Expr> parsed = parsedExpressions(64, 200);
+    return parsed;
+}
+
+int64_t sumIntegersInTree(const Expr &expr) {
+    if (const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(&expr)) {
+        return sumIntegersInTree((*binary)->left) + sumIntegersInTree((*binary)->right);
+    }
+    if (const auto *literal = std::get_if<LiteralValue>(&expr)) {
+        if (const auto *value = std::get_if<int64_t>(&literal->value)) {
+            return *value;
+        }
+    }
+    return 0;
+}
+
+void BM_WalkExprTree(benchmark::State &state) {
+    const std::vector<Expr> &trees = expressions();
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const Expr &expr : trees) {
+            sum += sumIntegersInTree(expr);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_WalkExprTree);
+
+void BM_ScanExprIr(benchmark::State &state) {
+    ExprIr ir;
+    for (const Expr &expr : expressions()) {
+        ir.lower(expr);
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const IrNode &node : ir.nodes) {
+            if (node.kind == IrKind::INTEGER) {
+                sum += ir.integers[node.a];
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_ScanExprIr);
+
+void BM_LowerExpr(benchmark::State &state) {
+    const std::vector<Expr> &trees = expressions();
+    for (auto _ : state) {
+        ExprIr ir;
+        for (const Expr &expr : trees) {
+            ir.lower(expr);
+        }
+        benchmark::DoNotOptimize(ir.nodes.data());
+    }
+}
+BENCHMARK(BM_LowerExpr);
+
+} // namespace
@@ -0,0 +1,154 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/lexer/lexer.h"
+#include "../../src/lexer/scan.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Keyword spellings of the per-Lexer std::unordered_map that lookupKeyword replaced; kept as the baseline
+const std::vector<std::string_view> baselineKeywords = {
+    "SELECT", "INSERT", "INTO", "VALUES", "FROM", "WHERE", "CREATE", "TABLE", "DROP", "DELETE", "UPDATE", "SET",
+    "PRIMARY", "KEY", "NOT", "UNIQUE", "IF", "EXISTS", "CASCADE", "RESTRICT", "ONLY", "RENAME", "CONSTRAINT",
+    "ALTER", "ATTACH", "DETACH", "OWNED", "FOR", "DEFAULT", "COLUMN", "TO", "SCHEMA", "OWNER", "ADD", "TYPE",
+    "USING", "COLLATE", "DATABASE", "VIEW", "INDEX", "TRIGGER", "COLLATION", "USER", "SEQUENCE", "CONCURRENTLY",
+    "FOREIGN", "CHECK", "REFERENCES", "LOCALE", "DETERMINISTIC", "PROVIDER", "RULES", "TRUE", "FALSE", "TABLESPACE",
+    "ALLOW_CONNECTIONS", "CONNECTION_LIMIT", "ENCODING", "ON", "ASC", "ASCENDING", "DESC", "DESCENDING", "NULLS",
+    "FIRST", "LAST", "BEFORE", "AFTER", "INSTEAD", "OF", "TRUNCATE", "OR", "EXECUTE", "FUNCTION", "EACH", "ROW",
+    "STATEMENT", "WHEN", "AUTHORIZATION", "TEMPORARY", "TEMP", "INCREMENT", "BY", "MINVALUE", "MAXVALUE", "CYCLE",
+    "START", "WITH", "NO", "CACHE", "NONE", "ROLE", "PASSWORD", "LOGIN", "NOLOGIN", "SUPERUSER", "CONNECTION",
+    "LIMIT", "VALID", "UNTIL", "NOSUPERUSER", "CREATEROLE", "NOCREATEROLE", "INHERIT", "NOINHERIT", "CREATEDB",
+    "NOCREATEDB", "NULL"
+};
+
+std::unordered_map<std::string, TokenType> buildKeywordMap() {
+    std::unordered_map<std::string, TokenType> keywords;
+    for (const auto name : baselineKeywords) {
+        keywords.emplace(name, lookupKeyword(name));
+    }
+    return keywords;
+}
+
+// The old Lexer::lookupIdent: upper-case copy, then hash lookup
+TokenType lookupIdentMap(std::unordered_map<std::string, TokenType> &keywords, const std::string_view ident) {
+    std::string upperIdent(ident);
+    for (auto &c : upperIdent) c = static_cast<char>(toupper(c));
+    if (const auto it = keywords.find(upperIdent); it != keywords.end()) {
+        return it->second;
+    }
+    return TokenType::IDENTIFIER;
+}
+
+// Identifier-shaped words in roughly the mix a DDL/DML workload produces
+const std::vector<std::string_view> words = {
+    "SELECT", "id", "name", "FROM", "users", "WHERE", "created_at", "AND", "insert", "into", "orders",
+    "VALUES", "customer_id", "create", "table", "IF", "not", "exists", "PRIMARY", "key", "varchar",
+    "Integer", "unique", "references", "accounts", "on", "delete", "cascade", "sequence", "increment",
+    "by", "start", "with", "tenant_id", "status", "description", "NULL", "default", "order_items",
+};
+
+void BM_KeywordMapConstruction(benchmark::State &state) {
+    for (auto _ : state) {
+        auto keywords = buildKeywordMap();
+        benchmark::DoNotOptimize(keywords);
+    }
+}
+BENCHMARK(BM_KeywordMapConstruction);
+
+void BM_LookupIdentMap(benchmark::State &state) {
+    auto keywords = buildKeywordMap();
+    for (auto _ : state) {
+        for (const auto word : words) {
+            benchmark::DoNotOptimize(lookupIdentMap(keywords, word));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(words.size()));
+}
+BENCHMARK(BM_LookupIdentMap);
+
+void BM_LookupKeyword(benchmark::State &state) {
+    for (auto _ : state) {
+        for (const auto word : words) {
+            benchmark::DoNotOptimize(lookupKeyword(word));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(words.size()));
+}
+BENCHMARK(BM_LookupKeyword);
+
+// End to end: one short statement through a fresh Lexer, the way each query is handled
+void BM_LexShortStatement(benchmark::State &state) {
+    const std::string_view query = "SELECT id, name FROM users WHERE id = 42;";
+    for (auto _ : state) {
+        Lexer lexer(query, borrow_input);
+        for (Token tok = lexer.NextToken(); tok.type != TokenType::EOF_TOKEN; tok = lexer.NextToken()) {
+            benchmark::DoNotOptimize(tok);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(query.size()));
+}
+BENCHMARK(BM_LexShortStatement);
+
+// A bulk-load script: many INSERTs with long quoted strings, the shape the vectorized scanners target
+std::string bulkInsertScript(const size_t rows) {
+    std::string script;
+    for (size_t i = 0; i < rows; ++i) {
+        script += "INSERT INTO documents (id, title, body) VALUES (" + std::to_string(i) + ", 'title_" + std::to_string(i) +
+                  "', '" + std::string(200 + i % 300, 'x') + "');\n";
+    }
+    return script;
+}
+
+void BM_LexBulkInsert(benchmark::State &state) {
+    const std::string script = bulkInsertScript(2000);
+    for (auto _ : state) {
+        Lexer lexer(std::string_view(script), borrow_input);
+        for (Token tok = lexer.NextToken(); tok.type != TokenType::EOF_TOKEN; tok = lexer.NextToken()) {
+            benchmark::DoNotOptimize(tok);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(script.size()));
+}
+BENCHMARK(BM_LexBulkInsert);
+
+// One kernel family over a 64 KiB string body; compares the vectorized scanners against the scalar fallback
+void BM_ScanStringBody(benchmark::State &state, const ScanKernels *kernels) {
+    if (kernels == nullptr) {
+        state.SkipWithError("Kernels not supported on this CPU");
+        return;
+    }
+    const std::string body = std::string(64 * 1024, 'x') + "'";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels->stringBody(body.data(), body.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(body.size()));
+}
+BENCHMARK_CAPTURE(BM_ScanStringBody, scalar, &scalarScanKernels());
+BENCHMARK_CAPTURE(BM_ScanStringBody, sse42, sse42ScanKernels());
+BENCHMARK_CAPTURE(BM_ScanStringBody, avx2, avx2ScanKernels());
+
+} // namespace
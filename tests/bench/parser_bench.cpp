@@ -0,0 +1,452 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include <benchmark/benchmark.h>
+#include "alloc_counter.h"
+#include "../../src/ast/fingerprint.h"
+#include "../../src/ast/serialize.h"
+#include "../../src/lexer/lexer.h"
+#include "../../src/optimizer/constant_folding.h"
+#include "../../src/parser/parser.h"
+#include "../../src/parser/parallel_parser.h"
+#include "../../src/parser/statement_cache.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Mixed DDL/DML script: table and index definitions followed by inserts, selects and schema changes against them
+std::string mixedScript(const size_t tables) {
+    std::string script;
+    for (size_t t = 0; t < tables; ++t) {
+        const std::string table = "orders_" + std::to_string(t);
+        script += "CREATE TABLE IF NOT EXISTS " + table +
+                  " (id BIGINT PRIMARY KEY, customer_id INTEGER NOT NULL, status TEXT, total DOUBLE, paid BOOLEAN,"
+                  " UNIQUE (customer_id, status));\n";
+        script += "CREATE UNIQUE INDEX idx_" + table + "_customer ON " + table + " (customer_id DESC NULLS LAST);\n";
+        script += "CREATE SEQUENCE " + table + "_seq INCREMENT BY 1 START WITH 100 CACHE 20 OWNED BY " + table + ".id;\n";
+        for (size_t i = 0; i < 8; ++i) {
+            script += "INSERT INTO " + table + " (id, customer_id, status, total) VALUES (" + std::to_string(i) + ", " +
+                      std::to_string(i * 7) + ", 'pending', 19.99), (" + std::to_string(i + 100) + ", 3, 'paid', 5.5);\n";
+        }
+        script += "SELECT id, total * 2 + 1 FROM " + table + " WHERE customer_id = 42;\n";
+        script += "ALTER TABLE " + table + " ADD COLUMN IF NOT EXISTS note TEXT, RENAME COLUMN total TO amount;\n";
+        script += "DROP TABLE IF EXISTS " + table + " CASCADE;\n";
+    }
+    return script;
+}
+
+size_t countStatements(const std::string &script) {
+    Lexer lexer(script);
+    Parser parser(lexer);
+    return parser.parse().size();
+}
+
+void BM_ParseMixedScript(benchmark::State &state) {
+    const std::string script = mixedScript(static_cast<size_t>(state.range(0)));
+    const size_t statements = countStatements(script);
+
+    size_t allocations = 0;
+    for (auto _ : state) {
+        const size_t before = allocationCount();
+        Lexer lexer(std::string_view(script), borrow_input);
+        Parser parser(lexer);
+        while (auto statement = parser.next_statement()) {
+            benchmark::DoNotOptimize(statement);
+        }
+        allocations += allocationCount() - before;
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(script.size()));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(statements));
+    state.counters["allocs/stmt"] = benchmark::Counter(static_cast<double>(allocations) /
+                                                       static_cast<double>(statements * state.iterations()));
+}
+BENCHMARK(BM_ParseMixedScript)->Arg(100);
+
+// DDL-only scripts: almost every grammar step is an expect(), so they show what each successful step costs
+std::string createTableScript(const size_t tables) {
+    std::string script;
+    for (size_t t = 0; t < tables; ++t) {
+        script += "CREATE TABLE IF NOT EXISTS t" + std::to_string(t) +
+                  " (id BIGINT PRIMARY KEY, a INTEGER NOT NULL, b TEXT UNIQUE, c DOUBLE, d BOOLEAN NOT NULL,"
+                  " CONSTRAINT pk_t PRIMARY KEY (id, a), FOREIGN KEY (a) REFERENCES parent (id), UNIQUE (b, c));\n";
+    }
+    return script;
+}
+
+std::string createSequenceScript(const size_t sequences) {
+    std::string script;
+    for (size_t s = 0; s < sequences; ++s) {
+        script += "CREATE SEQUENCE IF NOT EXISTS seq" + std::to_string(s) +
+                  " INCREMENT BY 5 MINVALUE 1 MAXVALUE 1000000 START WITH 10 CACHE 50 NO CYCLE OWNED BY t.id;\n";
+    }
+    return script;
+}
+
+void parseScript(benchmark::State &state, const std::string &script) {
+    const size_t statements = countStatements(script);
+    for (auto _ : state) {
+        Lexer lexer(std::string_view(script), borrow_input);
+        Parser parser(lexer);
+        while (auto statement = parser.next_statement()) {
+            benchmark::DoNotOptimize(statement);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(script.size()));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(statements));
+}
+
+void BM_ParseCreateTable(benchmark::State &state) {
+    parseScript(state, createTableScript(static_cast<size_t>(state.range(0))));
+}
+BENCHMARK(BM_ParseCreateTable)->Arg(1000);
+
+void BM_ParseCreateSequence(benchmark::State &state) {
+    parseScript(state, createSequenceScript(static_cast<size_t>(state.range(0))));
+}
+BENCHMARK(BM_ParseCreateSequence)->Arg(1000);
+
+// Selects with long arithmetic projections and predicates, so expression nodes dominate the allocations
+std::string expressionScript(const size_t statements) {
+    std::string script;
+    for (size_t i = 0; i < statements; ++i) {
+        script += "SELECT a + b * 2 - c % 4 + d * e - 1, f * (g + h) - i, (a + 1) * (b - 2) FROM t WHERE a * 3 + b = " +
+                  std::to_string(i) + " + c * d;\n";
+    }
+    return script;
+}
+
+size_t countNodes(const Expr &expr) {
+    if (const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(&expr)) {
+        return 1 + countNodes((*binary)->left) + countNodes((*binary)->right);
+    }
+    return 1;
+}
+
+size_t countNodes(const Statement &statement) {
+    const auto &select = std::get<SelectStmt>(statement);
+    size_t nodes = select.where ? countNodes(*select.where) : 0;
+    for (const Expr &projection : select.projections) {
+        nodes += countNodes(projection);
+    }
+    return nodes;
+}
+
+// Parse, walk once (as a later pass would) and free every statement; range(0) selects heap (0) or arena (1) nodes
+void BM_ParseWalkFreeExpressions(benchmark::State &state) {
+    const std::string script = expressionScript(1000);
+    const bool use_arena = state.range(0) != 0;
+    size_t nodes = 0;
+    const size_t allocations_before = allocationCount();
+    for (auto _ : state) {
+        Lexer lexer(std::string_view(script), borrow_input);
+        Parser parser(lexer);
+        if (use_arena) {
+            while (auto statement = parser.next_arena_statement()) {
+                nodes += countNodes(statement->statement());
+            }
+        } else {
+            while (auto statement = parser.next_statement()) {
+                nodes += countNodes(*statement);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(nodes);
+    state.SetLabel(use_arena ? "arena" : "heap");
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(script.size()));
+    state.counters["allocs/stmt"] = benchmark::Counter(
+        static_cast<double>(allocationCount() - allocations_before) / (static_cast<double>(state.iterations()) * 1000));
+}
+BENCHMARK(BM_ParseWalkFreeExpressions)->Arg(0)->Arg(1);
+
+// A batch of independently submitted statements, range(0) percent of them malformed in varying places
+std::vector<std::string> validationBatch(const size_t percent_bad) {
+    static constexpr const char *good[] = {
+        "INSERT INTO orders (id, customer_id, status) VALUES (1, 42, 'paid'), (2, 7, 'pending');",
+        "SELECT id, total * 2 + 1 FROM orders WHERE customer_id = 42;",
+        "CREATE TABLE t (id BIGINT PRIMARY KEY, name TEXT NOT NULL, total DOUBLE);",
+    };
+    static constexpr const char *bad[] = {
+        "INSERT INTO orders (id, customer_id, status) VALUES (1, 42, 'paid'), (2, 7 'pending');",
+        "SELECT id, total * 2 + FROM orders WHERE customer_id = 42;",
+        "CREATE TABLE t (id BIGINT PRIMARY KEY, name STRANGE NOT NULL, total DOUBLE);",
+    };
+    std::vector<std::string> batch;
+    for (size_t i = 0; i < 1000; ++i) {
+        batch.emplace_back(i % 100 < percent_bad ? bad[i % 3] : good[i % 3]);
+    }
+    return batch;
+}
+
+void BM_ValidateBatchThrowing(benchmark::State &state) {
+    const std::vector<std::string> batch = validationBatch(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        size_t rejected = 0;
+        for (const std::string &sql : batch) {
+            Lexer lexer(std::string_view(sql), borrow_input);
+            Parser parser(lexer);
+            try {
+                benchmark::DoNotOptimize(parser.parse());
+            } catch (const std::runtime_error &) {
+                ++rejected;
+            }
+        }
+        benchmark::DoNotOptimize(rejected);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_ValidateBatchThrowing)->Arg(0)->Arg(10)->Arg(50)->Arg(90);
+
+void BM_ValidateBatchExpected(benchmark::State &state) {
+    const std::vector<std::string> batch = validationBatch(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        size_t rejected = 0;
+        for (const std::string &sql : batch) {
+            Lexer lexer(std::string_view(sql), borrow_input);
+            Parser parser(lexer);
+            auto statements = parser.try_parse();
+            rejected += statements ? 0 : 1;
+            benchmark::DoNotOptimize(statements);
+        }
+        benchmark::DoNotOptimize(rejected);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_ValidateBatchExpected)->Arg(0)->Arg(10)->Arg(50)->Arg(90);
+
+// The same 200 parameterized query shapes submitted over and over
+std::vector<std::string> queryShapes() {
+    std::vector<std::string> shapes;
+    for (size_t i = 0; i < 200; ++i) {
+        shapes.push_back("SELECT id, total * 2 + 1 FROM orders_" + std::to_string(i) +
+                         " WHERE customer_id = $1 + $2 * " + std::to_string(i) + ";");
+    }
+    return shapes;
+}
+
+void BM_ParseRepeatedQueries(benchmark::State &state) {
+    const std::vector<std::string> shapes = queryShapes();
+    for (auto _ : state) {
+        for (const std::string &sql : shapes) {
+            Lexer lexer(std::string_view(sql), borrow_input);
+            Parser parser(lexer);
+            benchmark::DoNotOptimize(parser.next_statement());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(shapes.size()));
+}
+BENCHMARK(BM_ParseRepeatedQueries);
+
+void BM_CachedRepeatedQueries(benchmark::State &state) {
+    const std::vector<std::string> shapes = queryShapes();
+    StatementCache cache;
+    for (auto _ : state) {
+        for (const std::string &sql : shapes) {
+            benchmark::DoNotOptimize(cache.get_or_prepare(sql));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(shapes.size()));
+}
+BENCHMARK(BM_CachedRepeatedQueries);
+
+// The same lookups from several threads sharing one cache
+void BM_CachedQueriesAcrossThreads(benchmark::State &state) {
+    static StatementCache cache;
+    const std::vector<std::string> shapes = queryShapes();
+    size_t next = static_cast<size_t>(state.thread_index()) * 7919;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cache.get_or_prepare(shapes[next++ % shapes.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CachedQueriesAcrossThreads)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_FingerprintStatements(benchmark::State &state) {
+    const std::string script = mixedScript(20);
+    Lexer lexer(script);
+    Parser parser(lexer);
+    const std::vector<Statement> statements = parser.parse();
+    const size_t allocations_before = allocationCount();
+    for (auto _ : state) {
+        uint64_t combined = 0;
+        for (const Statement &statement : statements) {
+            combined ^= fingerprint(statement);
+        }
+        benchmark::DoNotOptimize(combined);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(statements.size()));
+    state.counters["allocs"] = static_cast<double>(allocationCount() - allocations_before);
+}
+BENCHMARK(BM_FingerprintStatements);
+
+// Encode and decode the statements of BM_ParseMixedScript/100, to compare a plan-cache reload with re-parsing the SQL
+std::vector<std::string> encodedMixedScript(const std::string &script) {
+    Lexer lexer(script);
+    Parser parser(lexer);
+    std::vector<std::string> encoded;
+    for (const Statement &statement : parser.parse()) {
+        encoded.push_back(serialize_statement(statement));
+    }
+    return encoded;
+}
+
+void BM_SerializeStatements(benchmark::State &state) {
+    const std::string script = mixedScript(100);
+    Lexer lexer(script);
+    Parser parser(lexer);
+    const std::vector<Statement> statements = parser.parse();
+    std::string out;
+    for (auto _ : state) {
+        for (const Statement &statement : statements) {
+            out.clear();
+            serialize_statement(statement, out);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(statements.size()));
+}
+BENCHMARK(BM_SerializeStatements);
+
+void BM_DeserializeStatements(benchmark::State &state) {
+    const std::string script = mixedScript(100);
+    const std::vector<std::string> encoded = encodedMixedScript(script);
+    size_t bytes = 0;
+    for (const std::string &buffer : encoded) bytes += buffer.size();
+
+    const size_t allocations_before = allocationCount();
+    for (auto _ : state) {
+        for (const std::string &buffer : encoded) {
+            benchmark::DoNotOptimize(deserialize_statement(buffer));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(encoded.size()));
+    state.counters["allocs/stmt"] = benchmark::Counter(static_cast<double>(allocationCount() - allocations_before) /
+                                                       static_cast<double>(state.iterations() * encoded.size()));
+    state.counters["encoded/sql"] = static_cast<double>(bytes) / static_cast<double>(script.size());
+}
+BENCHMARK(BM_DeserializeStatements);
+
+// ORM-style selects full of constant subtrees; range(0) = 1 folds each statement after parsing it. The difference
+// between the two runs is the one-off cost of the pass, which saves evaluating the folded nodes for every row.
+void BM_FoldConstants(benchmark::State &state) {
+    std::string script;
+    for (size_t i = 0; i < 1000; ++i) {
+        const std::string n = std::to_string(i);
+        script += "SELECT price * 1 + 0, CAST('" + n + "' AS INTEGER) * (60 * 60 * 24), CAST(" + n +
+                  ".5 AS BIGINT) / 1 FROM orders WHERE id = " + n + " + 2 * 3 - 0;\n";
+    }
+    size_t rewrites = 0;
+    for (auto _ : state) {
+        Lexer lexer(std::string_view(script), borrow_input);
+        Parser parser(lexer);
+        while (auto statement = parser.next_statement()) {
+            if (state.range(0) == 1) rewrites += fold_constants(*statement);
+            benchmark::DoNotOptimize(statement);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+    state.counters["folds/stmt"] = static_cast<double>(rewrites) / (static_cast<double>(state.iterations()) * 1000);
+}
+BENCHMARK(BM_FoldConstants)->Arg(0)->Arg(1);
+
+// Restore-style script parsed on range(0) threads; 1 thread is the sequential baseline
+void BM_ParseParallel(benchmark::State &state) {
+    const std::string script = mixedScript(2000);
+    const auto threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(threads == 1 ? countStatements(script) : parse_parallel(script, threads).size());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(script.size()));
+}
+BENCHMARK(BM_ParseParallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// One INSERT with range(0) literal rows. range(1) = 1 puts an expression in the first row, so every row goes
+// through parse_expression instead of the column buffers
+void BM_ParseBulkInsert(benchmark::State &state) {
+    const auto rows = static_cast<size_t>(state.range(0));
+    std::string sql = "INSERT INTO events (id, kind, score, ok) VALUES ";
+    for (size_t i = 0; i < rows; ++i) {
+        const std::string id = state.range(1) == 1 && i == 0 ? "0 + 0" : std::to_string(i * 7919);
+        sql += (i == 0 ? "(" : ", (") + id + ", 'event_" + std::to_string(i % 16) + "', " + std::to_string(i % 100) +
+               ".25, " + (i % 2 == 0 ? "TRUE" : "NULL") + ")";
+    }
+    sql += ";";
+
+    const size_t allocations_before = allocationCount();
+    for (auto _ : state) {
+        Lexer lexer(std::string_view(sql), borrow_input);
+        Parser parser(lexer);
+        benchmark::DoNotOptimize(parser.next_statement());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(sql.size()));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(rows));
+    state.counters["allocs/row"] = benchmark::Counter(
+        static_cast<double>(allocationCount() - allocations_before) / (static_cast<double>(state.iterations() * rows)));
+}
+BENCHMARK(BM_ParseBulkInsert)->Args({100000, 0})->Args({100000, 1})->Unit(benchmark::kMillisecond);
+
+// "SELECT a + a + ... ;" with range(0) operators, i.e. a left-deep tree range(0) levels deep
+std::string deepChain(const size_t depth) {
+    std::string sql = "SELECT a";
+    sql.reserve(sql.size() + depth * 4 + 1);
+    for (size_t i = 0; i < depth; ++i) sql += " + a";
+    sql += ";";
+    return sql;
+}
+
+// Parse time against expression depth; both parsing and the teardown below take constant stack depth
+void BM_BuildDeepExpression(benchmark::State &state) {
+    const auto depth = static_cast<size_t>(state.range(0));
+    const std::string sql = deepChain(depth);
+    for (auto _ : state) {
+        Lexer lexer(std::string_view(sql), borrow_input);
+        Parser parser(lexer);
+        auto statement = parser.next_statement();
+        benchmark::DoNotOptimize(statement);
+        state.PauseTiming();
+        statement.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(depth));
+}
+BENCHMARK(BM_BuildDeepExpression)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMicrosecond);
+
+// Destruction time of the same trees
+void BM_TeardownDeepExpression(benchmark::State &state) {
+    const auto depth = static_cast<size_t>(state.range(0));
+    const std::string sql = deepChain(depth);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Lexer lexer(std::string_view(sql), borrow_input);
+        Parser parser(lexer);
+        auto statement = parser.next_statement();
+        state.ResumeTiming();
+        statement.reset();
+        benchmark::DoNotOptimize(statement);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(depth));
+}
+BENCHMARK(BM_TeardownDeepExpression)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
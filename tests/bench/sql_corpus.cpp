@@ -0,0 +1,179 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include "sql_corpus.h"
+#include "../../src/parser/parser.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <variant>
+
+namespace {
+
+constexpr std::string_view statuses[] = {"pending", "paid", "shipped", "cancelled"};
+
+std::string narrowSelects(const size_t statements) {
+    std::string sql;
+    for (size_t i = 0; i < statements; ++i) {
+        const std::string n = std::to_string(i);
+        sql += "SELECT id, status FROM orders WHERE id = " + n + ";\n";
+    }
+    return sql;
+}
+
+std::string wideSelects(const size_t statements, const size_t columns) {
+    std::string sql;
+    for (size_t i = 0; i < statements; ++i) {
+        sql += "SELECT ";
+        for (size_t c = 0; c < columns; ++c) {
+            if (c > 0) sql += ", ";
+            const std::string column = "metric_" + std::to_string(c);
+            switch (c % 4) {
+                case 0: sql += column; break;
+                case 1: sql += column + " * 100"; break;
+                case 2: sql += column + " + offset_" + std::to_string(c) + " - 1"; break;
+                default: sql += "(" + column + " - baseline) / " + std::to_string(i % 10 + 1); break;
+            }
+        }
+        sql += " FROM daily_stats, regions WHERE day = " + std::to_string(i) + ";\n";
+    }
+    return sql;
+}
+
+std::string bulkInserts(const size_t statements, const size_t rows) {
+    std::string sql;
+    for (size_t s = 0; s < statements; ++s) {
+        sql += "INSERT INTO events (id, user_id, kind, amount, processed) VALUES\n";
+        for (size_t r = 0; r < rows; ++r) {
+            const size_t id = s * rows + r;
+            sql += r == 0 ? "(" : ",\n(";
+            sql += std::to_string(id) + ", " + std::to_string(id * 7919 % 100000) + ", '" +
+                   std::string(statuses[id % 4]) + "', " + std::to_string(id % 1000) + "." + std::to_string(id % 100) +
+                   ", " + (id % 3 == 0 ? "TRUE" : "FALSE") + ")";
+        }
+        sql += ";\n";
+    }
+    return sql;
+}
+
+// ((((x + 1) * 2) - 3) ... ) alternating operators, `depth` parentheses deep
+std::string nested(const std::string &leaf, const size_t depth) {
+    constexpr std::string_view ops[] = {" + ", " * ", " - ", " % "};
+    std::string expr(depth, '(');
+    expr += leaf;
+    for (size_t d = 0; d < depth; ++d) {
+        expr += std::string(ops[d % 4]) + std::to_string(d % 9 + 1) + ")";
+    }
+    return expr;
+}
+
+std::string nestedExpressions(const size_t statements, const size_t depth) {
+    std::string sql;
+    for (size_t i = 0; i < statements; ++i) {
+        sql += "SELECT " + nested("a", depth) + ", " + nested("b", depth / 2) + " FROM t WHERE " + nested("c", depth) +
+               " = " + std::to_string(i) + ";\n";
+    }
+    return sql;
+}
+
+std::string ddl(const size_t groups) {
+    std::string sql;
+    for (size_t g = 0; g < groups; ++g) {
+        const std::string n = std::to_string(g);
+        const std::string table = "accounts_" + n;
+        sql += "CREATE SCHEMA IF NOT EXISTS AUTHORIZATION owner_" + n + " app_" + n + ";\n";
+        sql += "CREATE TABLE IF NOT EXISTS " + table +
+               " (id BIGINT PRIMARY KEY, owner_id INTEGER NOT NULL, email VARCHAR UNIQUE, balance DOUBLE,"
+               " active BOOLEAN NOT NULL, CONSTRAINT pk_" + n + " PRIMARY KEY (id, owner_id),"
+               " FOREIGN KEY (owner_id) REFERENCES owners (id), UNIQUE (email, active), CHECK (balance = 0));\n";
+        sql += "CREATE UNIQUE INDEX idx_" + table + " ON " + table +
+               " USING btree (owner_id DESC NULLS LAST, email) WHERE active = TRUE;\n";
+        sql += "CREATE SEQUENCE " + table + "_seq INCREMENT BY 1 MINVALUE 1 MAXVALUE 1000000 START WITH 100 CACHE 20"
+               " NO CYCLE OWNED BY " + table + ".id;\n";
+        sql += "CREATE TRIGGER audit_" + n + " AFTER INSERT OR UPDATE OF balance, active FOR EACH ROW WHEN (balance = 0)"
+               " ON " + table + " EXECUTE FUNCTION audit_row('" + table + "', " + n + ");\n";
+        sql += "CREATE COLLATION coll_" + n + " (LOCALE = 'de_DE', PROVIDER = 'icu', RULES = '&a < b');\n";
+        sql += "CREATE DATABASE db_" + n + " (OWNER = owner_" + n +
+               ", ENCODING = 'UTF8', CONNECTION_LIMIT = 50);\n";
+        sql += "CREATE ROLE role_" + n + " WITH LOGIN NOSUPERUSER INHERIT;\n";
+        sql += "ALTER TABLE " + table + " ADD COLUMN IF NOT EXISTS note TEXT, ALTER COLUMN balance TYPE DOUBLE,"
+               " RENAME COLUMN note TO remark;\n";
+        sql += "DROP TABLE IF EXISTS " + table + " CASCADE;\n";
+    }
+    return sql;
+}
+
+SqlCorpus build(const CorpusKind kind) {
+    SqlCorpus corpus;
+    switch (kind) {
+        case CorpusKind::NARROW_SELECT:
+            corpus = {"narrow_select", narrowSelects(20000)};
+            break;
+        case CorpusKind::WIDE_SELECT:
+            corpus = {"wide_select", wideSelects(200, 200)};
+            break;
+        case CorpusKind::BULK_INSERT:
+            corpus = {"bulk_insert", bulkInserts(4, 10000)};
+            break;
+        case CorpusKind::NESTED_EXPRESSION:
+            corpus = {"nested_expression", nestedExpressions(1000, 64)};
+            break;
+        case CorpusKind::DDL:
+            corpus = {"ddl", ddl(500)};
+            break;
+    }
+
+    Lexer lexer(std::string_view(corpus.sql), borrow_input);
+    Parser parser(lexer);
+    const auto result = parser.try_parse();
+    if (!result) {
+        throw std::logic_error("Corpus " + std::string(corpus.name) + " does not parse: " + result.error().to_string());
+    }
+    corpus.statements = result->size();
+
+    if (kind == CorpusKind::DDL) {
+        // CREATE VIEW has an AST node but no grammar yet, so it is the one alternative the corpus cannot contain
+        std::array<bool, std::variant_size_v<CreateStmt>> seen{};
+        seen[CreateStmt(CreateViewStmt{}).index()] = true;
+        for (const Statement &statement : *result) {
+            if (const auto *create = std::get_if<CreateStmt>(&statement)) seen[create->index()] = true;
+        }
+        if (std::ranges::find(seen, false) != seen.end()) {
+            throw std::logic_error("DDL corpus does not cover every CREATE statement");
+        }
+    }
+    return corpus;
+}
+
+} // namespace
+
+const SqlCorpus &sqlCorpus(const CorpusKind kind) {
+    // Benchmarks register and run on one thread, so plain lazy slots are enough
+    static std::array<std::unique_ptr<SqlCorpus>, 5> corpora;
+    auto &slot = corpora.at(static_cast<size_t>(kind));
+    if (!slot) {
+        slot = std::make_unique<SqlCorpus>(build(kind));
+    }
+    return *slot;
+}
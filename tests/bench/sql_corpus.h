@@ -0,0 +1,47 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#ifndef FLUXO_DB_SQL_CORPUS_H
+#define FLUXO_DB_SQL_CORPUS_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Generated SQL scripts shaped like real front-end traffic. Generation is deterministic, so runs are comparable.
+enum class CorpusKind {
+    NARROW_SELECT,     // Point lookups: a couple of columns, one table, one predicate
+    WIDE_SELECT,       // Reporting queries projecting 200 columns through small expressions
+    BULK_INSERT,       // INSERTs of 10k literal rows each
+    NESTED_EXPRESSION, // Projections and predicates nested 64 parentheses deep
+    DDL                // Every CREATE statement the parser accepts, plus ALTER and DROP
+};
+
+struct SqlCorpus {
+    std::string_view name;
+    std::string sql;
+    size_t statements = 0;
+};
+
+// Built on first use and then shared. Throws std::logic_error if the generated script does not parse.
+const SqlCorpus &sqlCorpus(CorpusKind kind);
+
+#endif //FLUXO_DB_SQL_CORPUS_H
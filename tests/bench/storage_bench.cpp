@@ -0,0 +1,327 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/parser/parser.h"
+#include "../../src/storage/int_ops.h"
+#include "../../src/storage/string_ops.h"
+#include "../../src/storage/table.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+constexpr size_t insertRows = 100000;
+
+CreateTableStmt ordersTable() {
+    Lexer lexer(std::string("CREATE TABLE orders (id BIGINT, qty INT, price DOUBLE, paid BOOLEAN, note TEXT);"));
+    Parser parser(lexer);
+    auto statements = parser.parse();
+    return std::move(std::get<CreateTableStmt>(std::get<CreateStmt>(statements[0])));
+}
+
+// One INSERT of insertRows literal rows, parsed once into its bulk column buffers
+const InsertStmt &bulkInsert() {
+    static const InsertStmt insert = [] {
+        std::string sql = "INSERT INTO orders VALUES ";
+        for (size_t i = 0; i < insertRows; ++i) {
+            if (i > 0) sql += ", ";
+            sql += "(" + std::to_string(i) + ", " + (i % 16 == 0 ? "NULL" : std::to_string(i % 100)) + ", " +
+                   std::to_string(i % 1000) + ".25, " + (i % 3 == 0 ? "TRUE" : "FALSE") + ", 'note " +
+                   std::to_string(i % 50) + "')";
+        }
+        sql += ";";
+        Lexer lexer(sql);
+        Parser parser(lexer);
+        auto statements = parser.parse();
+        return std::move(std::get<InsertStmt>(statements[0]));
+    }();
+    return insert;
+}
+
+const Table &filledTable() {
+    static const Table table = [] {
+        Table filled(ordersTable());
+        filled.insert(bulkInsert());
+        return filled;
+    }();
+    return table;
+}
+
+void BM_TableInsert(benchmark::State &state) {
+    const CreateTableStmt definition = ordersTable();
+    const InsertStmt &insert = bulkInsert();
+    for (auto _ : state) {
+        Table table(definition);
+        benchmark::DoNotOptimize(table.insert(insert));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(insertRows));
+}
+BENCHMARK(BM_TableInsert);
+
+// SUM(qty) over the columnar layout: one dense int32 array per row group, NULL slots hold zero. Sealed groups are
+// packed, so they are decoded a block at a time into a buffer.
+void BM_ScanColumnSum(benchmark::State &state) {
+    const Table &table = filledTable();
+    const size_t qty = *table.column_index(Symbol("qty"));
+    std::vector<int32_t> buffer(packed_block_rows);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const RowGroup &group : table.row_groups()) {
+            const ColumnSegment &segment = group.columns[qty];
+            for (size_t first = 0; first < segment.size(); first += buffer.size()) {
+                const std::span<int32_t> values(buffer.data(), std::min(buffer.size(), segment.size() - first));
+                segment.decode_int32s(first, values);
+                for (const int32_t value : values) {
+                    sum += value;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(table.row_count()));
+}
+BENCHMARK(BM_ScanColumnSum);
+
+// The same sum over rows of boxed values, the layout the storage replaces
+void BM_ScanBoxedRowSum(benchmark::State &state) {
+    const Table &table = filledTable();
+    std::vector<std::vector<LiteralValue>> rows(table.row_count());
+    for (size_t row = 0; row < rows.size(); ++row) {
+        for (size_t column = 0; column < table.columns().size(); ++column) {
+            rows[row].push_back(table.value(row, column));
+        }
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const std::vector<LiteralValue> &row : rows) {
+            if (const auto *value = std::get_if<int64_t>(&row[1].value)) {
+                sum += *value;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(rows.size()));
+}
+BENCHMARK(BM_ScanBoxedRowSum);
+
+// A full row group of a low-cardinality status column in the given encoding
+const ColumnSegment &statusSegment(const StringEncoding encoding) {
+    static const std::array<ColumnSegment, 2> segments = [] {
+        std::array<ColumnSegment, 2> built{ColumnSegment(PhysicalType::STRING, StringEncoding::PLAIN),
+                                           ColumnSegment(PhysicalType::STRING, StringEncoding::DICTIONARY)};
+        const std::array<std::string, 4> statuses{"pending", "shipped", "delivered", "returned"};
+        for (ColumnSegment &segment : built) {
+            for (size_t row = 0; row < default_row_group_rows; ++row) {
+                segment.append_string(statuses[row * 7 % 11 % statuses.size()]);
+            }
+        }
+        return built;
+    }();
+    return segments[encoding == StringEncoding::DICTIONARY ? 1 : 0];
+}
+
+// WHERE status = 'delivered': string compares per row (arg 0) against one dictionary lookup and code compares (arg 1)
+void BM_FilterStringEqual(benchmark::State &state) {
+    const ColumnSegment &segment = statusSegment(state.range(0) ? StringEncoding::DICTIONARY : StringEncoding::PLAIN);
+    std::vector<uint64_t> selected;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(select_equal(segment, "delivered", selected));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(segment.size()));
+    state.counters["bytes_per_row"] = static_cast<double>(segment.data_bytes()) / static_cast<double>(segment.size());
+}
+BENCHMARK(BM_FilterStringEqual)->Arg(0)->Arg(1);
+
+// GROUP BY status: hashing every string (arg 0) against remapping the codes (arg 1)
+void BM_GroupByString(benchmark::State &state) {
+    const ColumnSegment &segment = statusSegment(state.range(0) ? StringEncoding::DICTIONARY : StringEncoding::PLAIN);
+    std::vector<uint32_t> ids;
+    for (auto _ : state) {
+        StringGroups groups;
+        ids.clear();
+        groups.assign(segment, ids);
+        benchmark::DoNotOptimize(groups.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(segment.size()));
+}
+BENCHMARK(BM_GroupByString)->Arg(0)->Arg(1);
+
+// One full row group of a typical integer column: 0 sequential ids, 1 timestamps about a second apart in
+// microseconds, 2 counters below 100, 3 random 64-bit values. Sealed (packed where that pays) unless `raw`.
+const ColumnSegment &integerSegment(const int64_t dataset, const bool raw) {
+    static const std::vector<ColumnSegment> segments = [] {
+        std::vector<ColumnSegment> built; // Packed and raw for each dataset
+        std::mt19937_64 random(42);
+        int64_t timestamp = 1760000000000000;
+        for (int64_t kind = 0; kind < 4; ++kind) {
+            ColumnSegment &packed = built.emplace_back(PhysicalType::INT64);
+            for (size_t row = 0; row < default_row_group_rows; ++row) {
+                int64_t value = static_cast<int64_t>(random());
+                if (kind == 0) value = static_cast<int64_t>(row) + 5000000;
+                if (kind == 1) value = timestamp += 1000000 + static_cast<int64_t>(random() % 1000);
+                if (kind == 2) value = static_cast<int64_t>(random() % 100);
+                packed.append_int64(value);
+            }
+            ColumnSegment raw = packed;
+            built.back().seal();
+            built.push_back(std::move(raw));
+        }
+        return built;
+    }();
+    return segments[static_cast<size_t>(dataset) * 2 + (raw ? 1 : 0)];
+}
+
+void reportCompression(benchmark::State &state, const ColumnSegment &segment) {
+    const double raw_bytes = static_cast<double>(segment.size() * sizeof(int64_t));
+    state.counters["compression_ratio"] = raw_bytes / static_cast<double>(segment.data_bytes());
+    state.counters["bits_per_value"] = 8.0 * static_cast<double>(segment.data_bytes()) /
+                                       static_cast<double>(segment.size());
+}
+
+// SUM over a row group decoded block by block (arg 1 = 0) or read from the raw array (arg 1 = 1)
+void BM_IntegerScanSum(benchmark::State &state) {
+    const ColumnSegment &segment = integerSegment(state.range(0), state.range(1) != 0);
+    std::vector<int64_t> buffer(packed_block_rows);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (size_t first = 0; first < segment.size(); first += buffer.size()) {
+            segment.decode_int64s(first, buffer);
+            for (const int64_t value : buffer) {
+                sum += value;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(segment.size()));
+    reportCompression(state, segment);
+}
+BENCHMARK(BM_IntegerScanSum)->ArgsProduct({{0, 1, 2, 3}, {0, 1}});
+
+// WHERE x BETWEEN a AND b selecting about a tenth of the rows, on the packed form (arg 1 = 0) or the raw array
+void BM_IntegerFilterRange(benchmark::State &state) {
+    const ColumnSegment &segment = integerSegment(state.range(0), state.range(1) != 0);
+    std::vector<int64_t> sorted(segment.size());
+    segment.decode_int64s(0, sorted);
+    std::ranges::sort(sorted);
+    const int64_t low = sorted[sorted.size() * 4 / 10];
+    const int64_t high = sorted[sorted.size() * 5 / 10];
+    std::vector<uint64_t> selected;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(select_range(segment, low, high, selected));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(segment.size()));
+    reportCompression(state, segment);
+}
+BENCHMARK(BM_IntegerFilterRange)->ArgsProduct({{0, 1, 2, 3}, {0, 1}});
+
+void BM_Unpack(benchmark::State &state, const UnpackKernels *kernels) {
+    if (kernels == nullptr) {
+        state.SkipWithError("Kernels not supported on this CPU");
+        return;
+    }
+    const auto width = static_cast<unsigned>(state.range(0));
+    std::mt19937_64 random(1);
+    std::vector<uint64_t> words(packed_block_rows * width / 64);
+    for (uint64_t &word : words) {
+        word = random();
+    }
+    std::vector<uint64_t> out(packed_block_rows);
+    for (auto _ : state) {
+        kernels->unpack(words.data(), width, packed_block_rows / packed_lanes, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(packed_block_rows));
+}
+BENCHMARK_CAPTURE(BM_Unpack, scalar, &scalarUnpackKernels())->Arg(7)->Arg(20)->Arg(33);
+BENCHMARK_CAPTURE(BM_Unpack, avx2, avx2UnpackKernels())->Arg(7)->Arg(20)->Arg(33);
+
+// Customer names of 4 to 24 random letters, so about half fit a StringRef inline
+const std::vector<std::string> &customerNames() {
+    static const std::vector<std::string> names = [] {
+        std::mt19937_64 random(9);
+        std::vector<std::string> built(default_row_group_rows);
+        for (std::string &name : built) {
+            name.resize(4 + random() % 21);
+            for (char &c : name) {
+                c = static_cast<char>('a' + random() % 26);
+            }
+        }
+        return built;
+    }();
+    return names;
+}
+
+// ORDER BY name over std::string cells (arg 0) against a plain segment of StringRefs (arg 1)
+void BM_SortStrings(benchmark::State &state) {
+    const std::vector<std::string> &names = customerNames();
+    ColumnSegment segment(PhysicalType::STRING, StringEncoding::PLAIN);
+    for (const std::string &name : names) {
+        segment.append_string(name);
+    }
+    std::vector<uint32_t> rows;
+    for (auto _ : state) {
+        rows.clear();
+        if (state.range(0) == 0) {
+            rows.resize(names.size());
+            std::iota(rows.begin(), rows.end(), uint32_t{0});
+            std::ranges::stable_sort(rows, [&names](const uint32_t a, const uint32_t b) {
+                return names[a] < names[b];
+            });
+        } else {
+            sort_rows(segment, rows);
+        }
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(names.size()));
+}
+BENCHMARK(BM_SortStrings)->Arg(0)->Arg(1);
+
+// Hash and probe every name against a table of all of them, keyed by std::string (arg 0) or StringRef (arg 1)
+void BM_HashProbeStrings(benchmark::State &state) {
+    const std::vector<std::string> &names = customerNames();
+    StringArena arena;
+    std::vector<StringRef> refs;
+    for (const std::string &name : names) {
+        refs.emplace_back(name, arena);
+    }
+    const std::unordered_set<std::string> by_string(names.begin(), names.end());
+    const std::unordered_set<StringRef> by_ref(refs.begin(), refs.end());
+    for (auto _ : state) {
+        size_t hits = 0;
+        if (state.range(0) == 0) {
+            for (const std::string &name : names) hits += by_string.count(name);
+        } else {
+            for (const StringRef &ref : refs) hits += by_ref.count(ref);
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(names.size()));
+}
+BENCHMARK(BM_HashProbeStrings)->Arg(0)->Arg(1);
+
+} // namespace
@@ -0,0 +1,230 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/catalog/catalog.h"
+#include "../../src/parser/parser.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Run every statement of `sql` against the catalog; returns the version after the last one
+uint64_t run(Catalog &catalog, const std::string &sql, const SearchPath &path = {}) {
+    Lexer lexer(sql);
+    Parser parser(lexer);
+    uint64_t version = catalog.version();
+    for (const Statement &statement : parser.parse()) {
+        version = catalog.apply(statement, path);
+    }
+    return version;
+}
+
+SearchPath in(const std::string &schema) {
+    return SearchPath{Symbol(default_database), Symbol(schema)};
+}
+
+} // namespace
+
+TEST(CatalogTest, StartsWithDefaultDatabaseAndSchema) {
+    const Catalog catalog;
+    const CatalogView view = catalog.view();
+    EXPECT_EQ(view->version, 1u);
+    ASSERT_NE(view->database(Symbol(default_database)), nullptr);
+    const SchemaEntry *schema = view->schema(SearchPath{});
+    ASSERT_NE(schema, nullptr);
+    EXPECT_TRUE(schema->tables.empty());
+    EXPECT_EQ(view->table(SearchPath{}, Symbol("missing")), nullptr);
+}
+
+TEST(CatalogTest, ViewsKeepTheirVersion) {
+    Catalog catalog;
+    run(catalog, "CREATE TABLE users (id BIGINT PRIMARY KEY, email TEXT NOT NULL);");
+    const CatalogView before = catalog.view();
+    const TableEntry *users = before->table(SearchPath{}, Symbol("users"));
+    ASSERT_NE(users, nullptr);
+
+    EXPECT_EQ(run(catalog, "CREATE UNIQUE INDEX users_email ON users (email); ALTER TABLE users ADD COLUMN age INT;"), 4u);
+
+    // The old view still sees the table as it was, through the same entry
+    EXPECT_EQ(before->version, 2u);
+    EXPECT_EQ(before->table(SearchPath{}, Symbol("users")), users);
+    EXPECT_EQ(users->columns.size(), 2u);
+    EXPECT_TRUE(before->indexes_of(SearchPath{}, Symbol("users")).empty());
+    EXPECT_GE(catalog.retired_versions(), 1u);
+
+    const CatalogView after = catalog.view();
+    EXPECT_EQ(after->table(SearchPath{}, Symbol("users"))->columns.size(), 3u);
+    const IndexEntry *index = after->index(SearchPath{}, Symbol("users_email"));
+    ASSERT_NE(index, nullptr);
+    EXPECT_TRUE(index->unique);
+    EXPECT_EQ(index->table, "users");
+    EXPECT_EQ(index->columns.at(0).column, "email");
+}
+
+TEST(CatalogTest, ReclaimsVersionsNoViewCanReach) {
+    Catalog catalog;
+    run(catalog, "CREATE TABLE a (x INT);");
+    {
+        const CatalogView pinned = catalog.view();
+        run(catalog, "CREATE TABLE b (x INT); CREATE TABLE c (x INT);");
+        EXPECT_EQ(catalog.retired_versions(), 2u);
+    }
+    run(catalog, "DROP TABLE c;");
+    EXPECT_EQ(catalog.retired_versions(), 0u);
+}
+
+TEST(CatalogTest, UnchangedEntriesAreShared) {
+    Catalog catalog;
+    run(catalog, "CREATE SCHEMA other; CREATE TABLE t (x INT);");
+    const CatalogView before = catalog.view();
+    run(catalog, "CREATE TABLE u (x INT);", in("other"));
+    const CatalogView after = catalog.view();
+
+    EXPECT_EQ(before->schema(SearchPath{}), after->schema(SearchPath{}));
+    EXPECT_NE(before->schema(in("other")), after->schema(in("other")));
+}
+
+TEST(CatalogTest, CreateSchemaPublishesAllElementsAtOnce) {
+    Catalog catalog;
+    const uint64_t version = run(catalog,
+        "CREATE SCHEMA AUTHORIZATION me sales CREATE TABLE orders (id BIGINT, total DOUBLE)"
+        " CREATE INDEX orders_id ON orders (id DESC);");
+    EXPECT_EQ(version, 2u);
+
+    const CatalogView view = catalog.view();
+    const SchemaEntry *sales = view->schema(in("sales"));
+    ASSERT_NE(sales, nullptr);
+    EXPECT_EQ(sales->owner, "me");
+    ASSERT_NE(view->table(in("sales"), Symbol("orders")), nullptr);
+    const IndexEntry *index = view->index(in("sales"), Symbol("orders_id"));
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->columns.at(0).ordering, OrderDirection::DESC);
+
+    // One bad element and none of the schema appears
+    EXPECT_THROW(run(catalog, "CREATE SCHEMA broken CREATE TABLE t (a INT) CREATE INDEX i ON t (nope);"),
+                 std::runtime_error);
+    EXPECT_EQ(catalog.version(), 2u);
+    EXPECT_EQ(catalog.view()->schema(in("broken")), nullptr);
+}
+
+TEST(CatalogTest, ExistenceClausesAndConflicts) {
+    Catalog catalog;
+    run(catalog, "CREATE TABLE t (a INT); CREATE INDEX i ON t (a);");
+    const uint64_t version = catalog.version();
+
+    EXPECT_EQ(run(catalog, "CREATE TABLE IF NOT EXISTS t (b INT); DROP TABLE IF EXISTS nope;"
+                           " ALTER TABLE IF EXISTS nope ADD COLUMN c INT;"), version);
+    EXPECT_THROW(run(catalog, "CREATE TABLE t (a INT);"), std::runtime_error);
+    EXPECT_THROW(run(catalog, "CREATE TABLE i (a INT);"), std::runtime_error);
+    EXPECT_THROW(run(catalog, "CREATE TABLE d (a INT, a TEXT);"), std::runtime_error);
+    EXPECT_THROW(run(catalog, "DROP TABLE t, nope;"), std::runtime_error);
+    EXPECT_THROW(run(catalog, "SELECT a FROM t;"), std::invalid_argument);
+    EXPECT_THROW(run(catalog, "CREATE TABLE x (a INT);", in("nope")), std::runtime_error);
+
+    // The failed multi-name DROP left t in place
+    EXPECT_EQ(catalog.version(), version);
+    EXPECT_NE(catalog.view()->table(SearchPath{}, Symbol("t")), nullptr);
+}
+
+TEST(CatalogTest, AlterTableKeepsIndexesInStep) {
+    Catalog catalog;
+    run(catalog, "CREATE SCHEMA archive; CREATE TABLE t (a INT, b TEXT); CREATE INDEX t_b ON t (b);"
+                 "CREATE TABLE child (id INT, CONSTRAINT fk FOREIGN KEY (id) REFERENCES t (a));");
+
+    run(catalog, "ALTER TABLE t RENAME COLUMN b TO c, RENAME TO u, ALTER COLUMN a SET NOT NULL, OWNER TO me;");
+    CatalogView view = catalog.view();
+    EXPECT_EQ(view->table(SearchPath{}, Symbol("t")), nullptr);
+    const TableEntry *u = view->table(SearchPath{}, Symbol("u"));
+    ASSERT_NE(u, nullptr);
+    EXPECT_EQ(u->name, "u");
+    EXPECT_EQ(u->owner, "me");
+    EXPECT_TRUE(u->column(Symbol("a"))->not_null);
+    const IndexEntry *index = view->index(SearchPath{}, Symbol("t_b"));
+    EXPECT_EQ(index->table, "u");
+    EXPECT_EQ(index->columns.at(0).column, "c");
+    EXPECT_EQ(view->table(SearchPath{}, Symbol("child"))->constraints.at(0).foreign_table, Symbol("u"));
+
+    EXPECT_THROW(run(catalog, "ALTER TABLE u DROP COLUMN c;"), std::runtime_error);
+    run(catalog, "ALTER TABLE u DROP COLUMN c CASCADE, SET SCHEMA archive;");
+    view = catalog.view();
+    EXPECT_EQ(view->index(SearchPath{}, Symbol("t_b")), nullptr);
+    ASSERT_NE(view->table(in("archive"), Symbol("u")), nullptr);
+    EXPECT_EQ(view->table(in("archive"), Symbol("u"))->columns.size(), 1u);
+}
+
+TEST(CatalogTest, DropCascades) {
+    Catalog catalog;
+    run(catalog, "CREATE TABLE t (a INT); CREATE INDEX i ON t (a);"
+                 "CREATE TABLE child (id INT, CONSTRAINT fk FOREIGN KEY (id) REFERENCES t (a));");
+
+    EXPECT_THROW(run(catalog, "DROP TABLE t;"), std::runtime_error);
+    run(catalog, "DROP TABLE t CASCADE;");
+    CatalogView view = catalog.view();
+    EXPECT_EQ(view->table(SearchPath{}, Symbol("t")), nullptr);
+    EXPECT_EQ(view->index(SearchPath{}, Symbol("i")), nullptr);
+    EXPECT_TRUE(view->table(SearchPath{}, Symbol("child"))->constraints.empty());
+
+    EXPECT_THROW(run(catalog, "DROP SCHEMA public;"), std::runtime_error);
+    run(catalog, "CREATE DATABASE d (OWNER = me); DROP SCHEMA public CASCADE;");
+    view = catalog.view();
+    EXPECT_EQ(view->schema(SearchPath{}), nullptr);
+    EXPECT_NE(view->schema(SearchPath{Symbol("d"), Symbol(default_schema)}), nullptr);
+}
+
+TEST(CatalogTest, ReadersSeeWholeVersionsWhileDdlRuns) {
+    Catalog catalog;
+    constexpr int tables = 200;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                const CatalogView view = catalog.view();
+                const SchemaEntry *schema = view->schema(SearchPath{});
+                // Each CREATE SCHEMA below adds a table and its index in one version
+                for (const auto &[name, index] : schema->indexes) {
+                    torn += schema->tables.contains(index->table) ? 0 : 1;
+                }
+                torn += schema->tables.size() == schema->indexes.size() ? 0 : 1;
+            }
+        });
+    }
+    for (int i = 0; i < tables; ++i) {
+        const std::string n = std::to_string(i);
+        run(catalog, "CREATE SCHEMA s" + n + " CREATE TABLE t" + n + " (a INT)"
+                     " CREATE INDEX i" + n + " ON t" + n + " (a);");
+        run(catalog, "ALTER TABLE t" + n + " SET SCHEMA public;", in("s" + n));
+    }
+    done = true;
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(catalog.view()->schema(SearchPath{})->tables.size(), static_cast<size_t>(tables));
+    EXPECT_EQ(catalog.version(), 1u + 2 * tables);
+}
@@ -0,0 +1,156 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/optimizer/constant_folding.h"
+#include "../../src/parser/parser.h"
+#include "../../src/parser/prepared_statement.h"
+#include <string>
+
+namespace {
+
+// Parse "SELECT <expr>;" and fold its projection
+Expr foldProjection(const std::string &expr) {
+    Lexer lexer("SELECT " + expr + ";");
+    Parser parser(lexer);
+    auto statements = parser.parse();
+    fold_constants(statements.at(0));
+    return std::move(std::get<SelectStmt>(statements[0]).projections.at(0));
+}
+
+LiteralValue foldLiteral(const std::string &expr) {
+    Expr folded = foldProjection(expr);
+    const auto *literal = std::get_if<LiteralValue>(&folded);
+    EXPECT_NE(literal, nullptr) << expr << " was not folded";
+    return literal ? *literal : LiteralValue{};
+}
+
+Expr binary(const BinaryOp::Op op, Expr left, Expr right) {
+    auto node = std::make_unique<BinaryOp>();
+    node->op = op;
+    node->left = std::move(left);
+    node->right = std::move(right);
+    return node;
+}
+
+} // namespace
+
+TEST(ConstantFoldingTest, FoldsLiteralArithmetic) {
+    EXPECT_EQ(std::get<int64_t>(foldLiteral("1 + 2 * 3").value), 7);
+    EXPECT_EQ(std::get<int64_t>(foldLiteral("(1 + 2) * -3").value), -9);
+    EXPECT_EQ(std::get<int64_t>(foldLiteral("-7 / 2").value), -3);
+    EXPECT_EQ(std::get<int64_t>(foldLiteral("-7 % 3").value), -1);
+    EXPECT_EQ(std::get<double>(foldLiteral("1 + 0.5").value), 1.5);
+    EXPECT_EQ(foldLiteral("1 + 0.5").type, DataType::DOUBLE);
+    EXPECT_TRUE(std::get<bool>(foldLiteral("2 * 3 = 6").value));
+    EXPECT_FALSE(std::get<bool>(foldLiteral("'a' = 'b'").value));
+    EXPECT_EQ(foldLiteral("NULL + 1").type, DataType::NULL_TYPE);
+
+    const LiteralValue wide = foldLiteral("CAST(2 AS BIGINT) * 3");
+    EXPECT_EQ(wide.type, DataType::BIGINT);
+    EXPECT_EQ(std::get<int64_t>(wide.value), 6);
+}
+
+TEST(ConstantFoldingTest, KeepsNodesThatWouldFailAtRunTime) {
+    for (const char *expr : {"9223372036854775807 + 1", "1 / 0", "5 % 0", "1.5 / 0", "CAST('abc' AS INTEGER)",
+                             "CAST(99999999999999999999.0 AS BIGINT)", "CAST(TRUE AS DOUBLE)"}) {
+        const Expr folded = foldProjection(expr);
+        EXPECT_FALSE(std::holds_alternative<LiteralValue>(folded)) << expr;
+    }
+    // Constant operands below the failing node are still folded
+    const Expr partial = foldProjection("(2 + 3) / (1 - 1)");
+    const auto &division = std::get<std::unique_ptr<BinaryOp>>(partial);
+    EXPECT_EQ(std::get<int64_t>(std::get<LiteralValue>(division->left).value), 5);
+    EXPECT_EQ(std::get<int64_t>(std::get<LiteralValue>(division->right).value), 0);
+}
+
+TEST(ConstantFoldingTest, RespectsIntegerWidth) {
+    // INTEGER arithmetic that leaves 32 bits would overflow at run time, so it stays unfolded
+    for (const char *expr : {"2147483647 + 1", "-2147483647 - 2", "65536 * 65536", "CAST(2147483648 AS INTEGER)",
+                             "CAST(-2147483649.0 AS INT)", "CAST('3000000000' AS INTEGER)"}) {
+        const Expr folded = foldProjection(expr);
+        EXPECT_FALSE(std::holds_alternative<LiteralValue>(folded)) << expr;
+    }
+    const LiteralValue minimum = foldLiteral("-2147483647 - 1");
+    EXPECT_EQ(minimum.type, DataType::INTEGER);
+    EXPECT_EQ(std::get<int64_t>(minimum.value), -2147483648);
+
+    // A literal too wide for INTEGER is a BIGINT, and so is arithmetic on it
+    const LiteralValue negated = foldLiteral("-3000000000");
+    EXPECT_EQ(negated.type, DataType::BIGINT);
+    EXPECT_EQ(std::get<int64_t>(negated.value), -3000000000);
+    EXPECT_EQ(foldLiteral("3000000000 + 1").type, DataType::BIGINT);
+    EXPECT_EQ(std::get<int64_t>(foldLiteral("CAST(2147483647 AS BIGINT) + 1").value), 2147483648);
+    EXPECT_EQ(std::get<int64_t>(foldLiteral("CAST(3000000000 AS BIGINT)").value), 3000000000);
+}
+
+TEST(ConstantFoldingTest, FoldsCasts) {
+    const LiteralValue five = foldLiteral("CAST(' 5 ' AS INTEGER)");
+    EXPECT_EQ(five.type, DataType::INTEGER);
+    EXPECT_EQ(std::get<int64_t>(five.value), 5);
+    EXPECT_EQ(std::get<int64_t>(foldLiteral("CAST(2.5 AS INT)").value), 2);
+    EXPECT_EQ(std::get<int64_t>(foldLiteral("CAST(-3.5 AS INT)").value), -4);
+    EXPECT_EQ(std::get<double>(foldLiteral("CAST('0.25' AS DOUBLE)").value), 0.25);
+    EXPECT_EQ(std::get<std::string>(foldLiteral("CAST(42 AS TEXT)").value), "42");
+    EXPECT_EQ(std::get<std::string>(foldLiteral("CAST(0.1 AS TEXT)").value), "0.1");
+    EXPECT_TRUE(std::get<bool>(foldLiteral("CAST('Yes' AS BOOLEAN)").value));
+    EXPECT_EQ(foldLiteral("CAST(NULL AS INTEGER)").type, DataType::NULL_TYPE);
+}
+
+TEST(ConstantFoldingTest, AppliesAlgebraicIdentities) {
+    for (const char *expr : {"x * 1", "1 * x", "x + 0", "0 + x", "x - 0", "x / 1", "(x + (2 - 2)) * (3 - 2)"}) {
+        const Expr folded = foldProjection(expr);
+        const auto *column = std::get_if<ColumnRef>(&folded);
+        ASSERT_NE(column, nullptr) << expr;
+        EXPECT_EQ(column->name, "x");
+    }
+    // A double constant would change the result type of an integer x, and x * 0 is NULL for a NULL x
+    for (const char *expr : {"x + 0.0", "x * 1.0", "x * 0", "0 - x"}) {
+        EXPECT_TRUE(std::holds_alternative<std::unique_ptr<BinaryOp>>(foldProjection(expr))) << expr;
+    }
+
+    // The parser has no AND / OR yet, so build the boolean cases directly
+    Expr keep = binary(BinaryOp::AND, ColumnRef{"p", std::nullopt}, LiteralValue::Boolean(true));
+    EXPECT_EQ(fold_constants(keep), 1u);
+    EXPECT_EQ(std::get<ColumnRef>(keep).name, "p");
+    Expr dominated = binary(BinaryOp::OR, LiteralValue::Boolean(true), ColumnRef{"p", std::nullopt});
+    fold_constants(dominated);
+    EXPECT_TRUE(std::get<bool>(std::get<LiteralValue>(dominated).value));
+    Expr unknown = binary(BinaryOp::AND, LiteralValue::Null(), LiteralValue::Boolean(true));
+    fold_constants(unknown);
+    EXPECT_EQ(std::get<LiteralValue>(unknown).type, DataType::NULL_TYPE);
+    Expr decided = binary(BinaryOp::AND, LiteralValue::Null(), LiteralValue::Boolean(false));
+    fold_constants(decided);
+    EXPECT_FALSE(std::get<bool>(std::get<LiteralValue>(decided).value));
+}
+
+TEST(ConstantFoldingTest, PrepareFoldsEveryExpression) {
+    const auto prepared = PreparedStatement::prepare("SELECT a * 1, 2 + 3 FROM t WHERE b = CAST('5' AS INTEGER) + ?;");
+    const auto &select = std::get<SelectStmt>(prepared->statement());
+    EXPECT_EQ(std::get<ColumnRef>(select.projections[0]).name, "a");
+    EXPECT_EQ(std::get<int64_t>(std::get<LiteralValue>(select.projections[1]).value), 5);
+    const auto &eq = std::get<std::unique_ptr<BinaryOp>>(*select.where);
+    const auto &plus = std::get<std::unique_ptr<BinaryOp>>(eq->right);
+    EXPECT_EQ(std::get<int64_t>(std::get<LiteralValue>(plus->left).value), 5);
+    EXPECT_EQ(std::get<ParameterRef>(plus->right).index, 1u);
+    EXPECT_EQ(prepared->parameter_count(), 1u);
+}
@@ -0,0 +1,150 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/ir/expr_ir.h"
+#include "../../src/parser/parser.h"
+#include <string>
+
+namespace {
+
+Expr parseProjection(const std::string &sql) {
+    Lexer lexer(sql);
+    Parser parser(lexer);
+    auto statements = parser.parse();
+    return std::move(std::get<SelectStmt>(statements[0]).projections[0]);
+}
+
+} // namespace
+
+TEST(ExprIrTest, LowersInPostOrderWithPooledLiterals) {
+    const Expr expr = parseProjection("SELECT a + 2 * 'x' FROM t;");
+    const ExprIr ir = lower_expr(expr);
+
+    ASSERT_EQ(ir.nodes.size(), 5u);
+    for (uint32_t i = 0; i < ir.nodes.size(); ++i) {
+        const IrNode &node = ir.nodes[i];
+        if (node.kind == IrKind::BINARY) {
+            EXPECT_LT(node.a, i);
+            EXPECT_LT(node.b, i);
+        }
+    }
+
+    const IrNode &root = ir.nodes.back();
+    EXPECT_EQ(root.kind, IrKind::BINARY);
+    EXPECT_EQ(static_cast<BinaryOp::Op>(root.op), BinaryOp::Op::PLUS);
+    EXPECT_EQ(ir.nodes[root.a].kind, IrKind::COLUMN);
+    EXPECT_EQ(ir.columns[ir.nodes[root.a].a].name, "a");
+
+    ASSERT_EQ(ir.integers.size(), 1u);
+    EXPECT_EQ(ir.integers[0], 2);
+    ASSERT_EQ(ir.string_count(), 1u);
+    EXPECT_EQ(ir.string(0), "x");
+}
+
+TEST(ExprIrTest, InternsColumnReferences) {
+    ExprIr ir;
+    const Expr first = parseProjection("SELECT a * b + a FROM t;");
+    const Expr second = parseProjection("SELECT b - a FROM t;");
+    ir.lower(first);
+    ir.lower(second);
+
+    ASSERT_EQ(ir.columns.size(), 2u);
+    EXPECT_EQ(ir.columns[0].name, "a");
+    EXPECT_EQ(ir.columns[1].name, "b");
+
+    Expr qualified = ColumnRef{"a", "t"};
+    EXPECT_EQ(ir.nodes[ir.lower(qualified)].a, 2u);
+}
+
+TEST(ExprIrTest, RaiseRebuildsTheTree) {
+    auto call = std::make_unique<FunctionCall>();
+    call->name = "coalesce";
+    call->args.emplace_back(ColumnRef{"a", std::nullopt});
+    call->args.emplace_back(LiteralValue::Null());
+    auto cast = std::make_unique<CastExpr>();
+    cast->target_type = DataType::BIGINT;
+    cast->expr = std::make_unique<Expression>(std::move(call));
+    auto negate = std::make_unique<UnaryOp>();
+    negate->op = UnaryOp::Op::MINUS;
+    negate->operand = std::make_unique<Expression>(LiteralValue::Double(1.5));
+    auto root = std::make_unique<BinaryOp>();
+    root->op = BinaryOp::Op::MUL;
+    root->left = std::move(cast);
+    root->right = std::move(negate);
+    const Expr expr = std::move(root);
+
+    const ExprIr ir = lower_expr(expr);
+    const Expr raised = ir.raise(static_cast<uint32_t>(ir.nodes.size() - 1));
+    const ExprIr again = lower_expr(raised);
+
+    ASSERT_EQ(again.nodes.size(), ir.nodes.size());
+    for (size_t i = 0; i < ir.nodes.size(); ++i) {
+        EXPECT_EQ(again.nodes[i].kind, ir.nodes[i].kind);
+        EXPECT_EQ(again.nodes[i].op, ir.nodes[i].op);
+        EXPECT_EQ(again.nodes[i].type, ir.nodes[i].type);
+    }
+
+    const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(&raised);
+    ASSERT_NE(binary, nullptr);
+    const auto *raisedCast = std::get_if<std::unique_ptr<CastExpr>>(&(*binary)->left);
+    ASSERT_NE(raisedCast, nullptr);
+    EXPECT_EQ((*raisedCast)->target_type, DataType::BIGINT);
+    const auto *raisedCall = std::get_if<std::unique_ptr<FunctionCall>>((*raisedCast)->expr.get());
+    ASSERT_NE(raisedCall, nullptr);
+    EXPECT_EQ((*raisedCall)->name, "coalesce");
+    ASSERT_EQ((*raisedCall)->args.size(), 2u);
+    EXPECT_TRUE(std::holds_alternative<LiteralValue>((*raisedCall)->args[1]));
+    EXPECT_TRUE(ir.is_literal(ir.arguments[1]));
+}
+
+TEST(ExprIrTest, LowersAndRaisesDeepTrees) {
+    // Far deeper than a recursive walk could go
+    constexpr size_t depth = 300000;
+    std::string sql = "SELECT a";
+    for (size_t i = 0; i < depth; ++i) sql += " + 1";
+    const Expr expr = parseProjection(sql + " FROM t;");
+
+    ExprIr ir;
+    const uint32_t root = ir.lower(expr);
+    EXPECT_EQ(ir.nodes.size(), 2 * depth + 1);
+    EXPECT_EQ(ir.columns.size(), 1u);
+    const Expr raised = ir.raise(root);
+
+    // Reused after clear(), the IR lowers the raised tree to the same nodes
+    ir.clear();
+    EXPECT_EQ(ir.lower(raised), root);
+    EXPECT_EQ(ir.integers.size(), depth);
+}
+
+TEST(ExprIrTest, KeepsAbsentOperands) {
+    auto negate = std::make_unique<UnaryOp>();
+    negate->op = UnaryOp::Op::NOT;
+    const Expr expr = std::move(negate);
+
+    const ExprIr ir = lower_expr(expr);
+    ASSERT_EQ(ir.nodes.size(), 2u);
+    EXPECT_EQ(ir.nodes[0].kind, IrKind::NULL_VALUE);
+    EXPECT_FALSE(ir.is_literal(0));
+    const Expr raised = ir.raise(1);
+    EXPECT_EQ(std::get<std::unique_ptr<UnaryOp>>(raised)->operand, nullptr);
+}
@@ -0,0 +1,113 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 15.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/ast/fingerprint.h"
+#include "../../src/parser/parser.h"
+#include "../../src/parser/prepared_statement.h"
+#include <string>
+
+namespace {
+
+Statement parseOne(const std::string &sql) {
+    Lexer lexer(sql);
+    Parser parser(lexer);
+    return std::move(parser.parse().at(0));
+}
+
+uint64_t fingerprintOf(const std::string &sql) {
+    return fingerprint(parseOne(sql));
+}
+
+} // namespace
+
+TEST(FingerprintTest, IgnoresLiteralValues) {
+    const uint64_t five = fingerprintOf("SELECT a FROM t WHERE b = 5;");
+    EXPECT_EQ(fingerprintOf("SELECT a FROM t WHERE b = 7;"), five);
+    EXPECT_EQ(fingerprintOf("SELECT a FROM t WHERE b = 'seven';"), five);
+    EXPECT_EQ(fingerprintOf("SELECT a FROM t WHERE b = $1;"), five);
+    EXPECT_EQ(fingerprintOf("INSERT INTO t (a, b) VALUES (1, 'x');"), fingerprintOf("INSERT INTO t (a, b) VALUES (2, 'y');"));
+    // Literal-only rows are parsed into column buffers but hash like the same rows written with placeholders
+    EXPECT_EQ(fingerprintOf("INSERT INTO t VALUES (1, 'x'), (NULL, 'y');"), fingerprintOf("INSERT INTO t VALUES (?, ?), (?, ?);"));
+}
+
+TEST(FingerprintTest, DistinguishesShapes) {
+    const uint64_t base = fingerprintOf("SELECT a FROM t WHERE b = 5;");
+    EXPECT_NE(fingerprintOf("SELECT a FROM t WHERE c = 5;"), base);
+    EXPECT_NE(fingerprintOf("SELECT a FROM u WHERE b = 5;"), base);
+    EXPECT_NE(fingerprintOf("SELECT a, b FROM t WHERE b = 5;"), base);
+    EXPECT_NE(fingerprintOf("SELECT a FROM t WHERE b = 5 + 1;"), base);
+    EXPECT_NE(fingerprintOf("SELECT a FROM t;"), base);
+    EXPECT_NE(fingerprintOf("SELECT a + b FROM t;"), fingerprintOf("SELECT a * b FROM t;"));
+    EXPECT_NE(fingerprintOf("CREATE SEQUENCE s START WITH 1;"), fingerprintOf("CREATE SEQUENCE s START WITH 2;"));
+    EXPECT_NE(fingerprintOf("DROP TABLE t;"), fingerprintOf("DROP TABLE t CASCADE;"));
+}
+
+TEST(FingerprintTest, NormalizeReplacesLiteralsWithSlots) {
+    Lexer lexer(std::string("SELECT a * 2 FROM t WHERE b = $1 + 'x';"));
+    Parser parser(lexer);
+    Statement statement = std::move(*parser.next_statement());
+    const uint64_t before = fingerprint(statement);
+
+    const std::vector<LiteralValue> removed = normalize_literals(statement, parser.parameter_count() + 1);
+    ASSERT_EQ(removed.size(), 2u);
+    EXPECT_EQ(std::get<int64_t>(removed[0].value), 2);
+    EXPECT_EQ(std::get<std::string>(removed[1].value), "x");
+    EXPECT_EQ(fingerprint(statement), before);
+
+    const auto &select = std::get<SelectStmt>(statement);
+    const auto &mul = std::get<std::unique_ptr<BinaryOp>>(select.projections[0]);
+    EXPECT_EQ(std::get<ParameterRef>(mul->right).index, 2u);
+    const auto &eq = std::get<std::unique_ptr<BinaryOp>>(*select.where);
+    const auto &plus = std::get<std::unique_ptr<BinaryOp>>(eq->right);
+    EXPECT_EQ(std::get<ParameterRef>(plus->left).index, 1u);
+    EXPECT_EQ(std::get<ParameterRef>(plus->right).index, 3u);
+}
+
+TEST(FingerprintTest, NormalizeMovesBulkRowsIntoSlots) {
+    Statement statement = parseOne("INSERT INTO t VALUES (1, 'x'), (NULL, 'y');");
+    ASSERT_TRUE(std::get<InsertStmt>(statement).bulk.has_value());
+    const uint64_t before = fingerprint(statement);
+
+    const std::vector<LiteralValue> removed = normalize_literals(statement);
+    ASSERT_EQ(removed.size(), 4u);
+    EXPECT_EQ(std::get<int64_t>(removed[0].value), 1);
+    EXPECT_EQ(std::get<std::string>(removed[1].value), "x");
+    EXPECT_EQ(removed[2].type, DataType::NULL_TYPE);
+    EXPECT_EQ(std::get<std::string>(removed[3].value), "y");
+    EXPECT_EQ(fingerprint(statement), before);
+
+    const auto &insert = std::get<InsertStmt>(statement);
+    EXPECT_FALSE(insert.bulk.has_value());
+    ASSERT_EQ(insert.values.size(), 2u);
+    for (size_t row = 0; row < 2; ++row) {
+        ASSERT_EQ(insert.values[row].size(), 2u);
+        for (size_t cell = 0; cell < 2; ++cell) {
+            EXPECT_EQ(std::get<ParameterRef>(insert.values[row][cell]).index, row * 2 + cell + 1);
+        }
+    }
+}
+
+TEST(FingerprintTest, PreparedStatementExposesFingerprint) {
+    const auto prepared = PreparedStatement::prepare("SELECT a FROM t WHERE b = 5;");
+    EXPECT_EQ(prepared->fingerprint(), fingerprintOf("SELECT a FROM t WHERE b = 9;"));
+}
@@ -0,0 +1,204 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/storage/int_ops.h"
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<int64_t> decodeAll(const PackedInts &packed) {
+    std::vector<int64_t> values(packed.size());
+    for (size_t block = 0; block < packed.blocks().size(); ++block) {
+        packed.decode_block(block, values.data() + block * packed_block_rows);
+    }
+    return values;
+}
+
+// Values spread over `width` bits above `base`, in random order
+std::vector<int64_t> randomValues(const size_t count, const unsigned width, const int64_t base, const uint32_t seed) {
+    std::mt19937_64 random(seed);
+    std::vector<int64_t> values(count);
+    for (int64_t &value : values) {
+        const uint64_t offset = width == 0 ? 0 : width == 64 ? random() : random() & ((uint64_t{1} << width) - 1);
+        value = static_cast<int64_t>(static_cast<uint64_t>(base) + offset);
+    }
+    return values;
+}
+
+} // namespace
+
+TEST(IntPackingTest, RoundTripsEveryWidth) {
+    for (unsigned width = 0; width <= 64; ++width) {
+        // 2500 rows: two full blocks and a tail that is not a multiple of the lane count
+        const std::vector<int64_t> values = randomValues(2500, width, -12345, width);
+        const PackedInts packed = PackedInts::pack(std::span<const int64_t>(values));
+        ASSERT_EQ(packed.blocks().size(), 3u);
+        EXPECT_EQ(decodeAll(packed), values) << "width " << width;
+        for (const size_t row : {size_t{0}, size_t{3}, size_t{1023}, size_t{1024}, size_t{2499}}) {
+            EXPECT_EQ(packed.value(row), values[row]) << "width " << width << " row " << row;
+        }
+        EXPECT_LE(packed.blocks()[0].width, width);
+    }
+
+    const std::vector<int64_t> extremes{std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 0,
+                                        -1, 1};
+    EXPECT_EQ(decodeAll(PackedInts::pack(std::span<const int64_t>(extremes))), extremes);
+
+    const std::vector<int32_t> narrow{std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), 7};
+    const PackedInts packed = PackedInts::pack(std::span<const int32_t>(narrow));
+    std::vector<int32_t> decoded(narrow.size());
+    packed.decode_block(0, decoded.data());
+    EXPECT_EQ(decoded, narrow);
+    EXPECT_EQ(packed.blocks()[0].width, 32u);
+}
+
+TEST(IntPackingTest, PicksTheNarrowerEncodingPerBlock) {
+    // Ids counting up, then a block of timestamps a second apart with jitter, then small random counters
+    std::vector<int64_t> values;
+    for (int64_t id = 1000000; id < 1000000 + 1024; ++id) {
+        values.push_back(id);
+    }
+    std::mt19937_64 random(7);
+    int64_t timestamp = 1760000000000000;
+    for (size_t row = 0; row < 1024; ++row) {
+        values.push_back(timestamp += 1000000 + static_cast<int64_t>(random() % 1000));
+    }
+    for (size_t row = 0; row < 1024; ++row) {
+        values.push_back(static_cast<int64_t>(random() % 100));
+    }
+    const PackedInts packed = PackedInts::pack(std::span<const int64_t>(values));
+    ASSERT_EQ(packed.blocks().size(), 3u);
+    EXPECT_EQ(packed.blocks()[0].encoding, IntEncoding::DELTA);
+    EXPECT_EQ(packed.blocks()[0].width, 0u);
+    EXPECT_EQ(packed.blocks()[1].encoding, IntEncoding::DELTA);
+    EXPECT_LE(packed.blocks()[1].width, 12u);
+    EXPECT_EQ(packed.blocks()[2].encoding, IntEncoding::FOR);
+    EXPECT_EQ(packed.blocks()[2].width, 7u);
+    EXPECT_EQ(decodeAll(packed), values);
+    EXPECT_EQ(packed.value(1500), values[1500]);
+    EXPECT_LT(packed.byte_size() * 4, values.size() * sizeof(int64_t));
+}
+
+TEST(IntPackingTest, UnpackKernelsMatchScalar) {
+    const UnpackKernels *avx2 = avx2UnpackKernels();
+    if (avx2 == nullptr) {
+        GTEST_SKIP() << "AVX2 not available";
+    }
+    std::mt19937_64 random(3);
+    std::vector<uint64_t> words(64 * packed_lanes);
+    for (uint64_t &word : words) {
+        word = random();
+    }
+    for (unsigned width = 1; width <= 64; ++width) {
+        const size_t groups = 64 * 64 / width / packed_lanes;
+        std::vector<uint64_t> expected(groups * packed_lanes);
+        std::vector<uint64_t> actual(groups * packed_lanes);
+        scalarUnpackKernels().unpack(words.data(), width, groups, expected.data());
+        avx2->unpack(words.data(), width, groups, actual.data());
+        EXPECT_EQ(actual, expected) << "width " << width;
+    }
+}
+
+TEST(IntPackingTest, SealedSegmentsPackAndUnpackOnWrite) {
+    ColumnSegment segment(PhysicalType::INT32);
+    for (int32_t row = 0; row < 3000; ++row) {
+        if (row % 100 == 7) {
+            segment.append_null();
+        } else {
+            segment.append_int32(500 + row % 300);
+        }
+    }
+    const size_t raw_bytes = segment.data_bytes();
+    segment.seal();
+    ASSERT_TRUE(segment.packed());
+    EXPECT_TRUE(segment.int32s().empty());
+    EXPECT_LT(segment.data_bytes() * 3, raw_bytes);
+
+    std::vector<int32_t> window(1500);
+    segment.decode_int32s(1000, window);
+    EXPECT_EQ(window[0], 500 + 1000 % 300);
+    EXPECT_EQ(window[7], 0); // Row 1007 is NULL
+    EXPECT_EQ(window[1499], 500 + 2499 % 300);
+    EXPECT_EQ(segment.integer(2999), 500 + 2999 % 300);
+    EXPECT_EQ(segment.integer(107), 0);
+    EXPECT_THROW(segment.decode_int32s(2000, window), std::out_of_range);
+
+    segment.truncate(2048);
+    EXPECT_FALSE(segment.packed());
+    ASSERT_EQ(segment.int32s().size(), 2048u);
+    EXPECT_EQ(segment.int32s()[1007], 0);
+    EXPECT_EQ(segment.int32s()[2047], 500 + 2047 % 300);
+    segment.seal();
+    segment.append_int32(-1);
+    EXPECT_FALSE(segment.packed());
+    EXPECT_EQ(segment.int32s().back(), -1);
+
+    // Values that need every bit stay unpacked
+    ColumnSegment random_segment(PhysicalType::INT64);
+    for (const int64_t value : randomValues(2048, 64, 0, 11)) {
+        random_segment.append_int64(value);
+    }
+    random_segment.seal();
+    EXPECT_FALSE(random_segment.packed());
+}
+
+TEST(IntPackingTest, RangePredicatesMatchOnPackedAndRawSegments) {
+    std::mt19937_64 random(5);
+    std::vector<int64_t> values;
+    for (size_t row = 0; row < 3000; ++row) {
+        values.push_back(row < 1024 ? static_cast<int64_t>(row) * 10 : static_cast<int64_t>(random() % 1000) - 500);
+    }
+    ColumnSegment raw(PhysicalType::INT64);
+    for (size_t row = 0; row < values.size(); ++row) {
+        if (row % 37 == 0) {
+            raw.append_null();
+        } else {
+            raw.append_int64(values[row]);
+        }
+    }
+    ColumnSegment packed = raw;
+    packed.seal();
+    ASSERT_TRUE(packed.packed());
+
+    const std::vector<std::pair<int64_t, int64_t>> ranges{
+            {-500, 499}, {0, 0}, {-3, 3}, {100, 5000}, {10230, 20000}, {std::numeric_limits<int64_t>::min(), -1},
+            {42, 41}, {600, 900}};
+    for (const auto &[low, high] : ranges) {
+        std::vector<uint64_t> expected((values.size() + 63) / 64, 0);
+        size_t expected_count = 0;
+        for (size_t row = 0; row < values.size(); ++row) {
+            if (row % 37 != 0 && values[row] >= low && values[row] <= high) {
+                expected[row / 64] |= uint64_t{1} << (row % 64);
+                ++expected_count;
+            }
+        }
+        for (const ColumnSegment *segment : {&raw, &packed}) {
+            std::vector<uint64_t> selected;
+            EXPECT_EQ(select_range(*segment, low, high, selected), expected_count) << low << ".." << high;
+            EXPECT_EQ(selected, expected) << low << ".." << high;
+        }
+    }
+}
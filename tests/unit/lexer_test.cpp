@@ -22,6 +22,7 @@
 
 #include <gtest/gtest.h>
 #include "../../src/lexer/lexer.h"
+#include "../../src/lexer/scan.h"
 #include <vector>
 #include <string>
 
@@ -61,7 +62,7 @@ TEST(LexerTest, TextNextTokenBasic) {
 }
 
 TEST(LexerTest, TestPunctuation) {
-    std::string input = ", . ( ) ; * =";
+    std::string input = ", . ( ) ; * = /";
 
     std::vector<ExpectedToken> expectedTokens = {
         {TokenType::COMMA, ","},
@@ -71,6 +72,7 @@ TEST(LexerTest, TestPunctuation) {
         {TokenType::SEMICOLON, ";"},
         {TokenType::ASTERISK, "*"},
         {TokenType::EQUALS, "="},
+        {TokenType::SLASH, "/"},
         {TokenType::EOF_TOKEN, ""}
     };
     Lexer lexer(input);
@@ -129,4 +131,153 @@ TEST (LexerTest, TestCaseInsensitivity) {
             EXPECT_EQ(tok.literal, literal) << "Token literal mismatch.";
         }
     }
-}
\ No newline at end of file
+}
+TEST(LexerTest, TestBorrowedInputIsZeroCopy) {
+    const std::string buffer = "INSERT INTO users VALUES ('alice', 42);";
+    const std::string_view input = buffer;
+
+    Lexer lexer(input, borrow_input);
+
+    for (Token tok = lexer.NextToken(); tok.type != TokenType::EOF_TOKEN; tok = lexer.NextToken()) {
+        // Every literal must be a view into the caller's buffer, not a copy
+        EXPECT_GE(tok.literal.data(), input.data()) << "Token literal does not point into the input.";
+        EXPECT_LE(tok.literal.data() + tok.literal.size(), input.data() + input.size())
+            << "Token literal does not point into the input.";
+    }
+}
+
+TEST(LexerTest, TestBorrowedInputMatchesOwnedInput) {
+    const std::string input = "CREATE TABLE t (id INT, name TEXT); SELECT 'x' FROM t WHERE id = 3.5;";
+
+    Lexer owned(input);
+    Lexer borrowed(std::string_view(input), borrow_input);
+
+    Token expected = owned.NextToken();
+    Token actual = borrowed.NextToken();
+    while (expected.type != TokenType::EOF_TOKEN) {
+        EXPECT_EQ(actual.type, expected.type) << "Token type mismatch.";
+        EXPECT_EQ(actual.literal, expected.literal) << "Token literal mismatch.";
+        EXPECT_EQ(actual.offset, expected.offset) << "Token offset mismatch.";
+        expected = owned.NextToken();
+        actual = borrowed.NextToken();
+    }
+    EXPECT_EQ(actual.type, TokenType::EOF_TOKEN);
+}
+
+TEST(LexerTest, TestKeywordLookup) {
+    EXPECT_EQ(lookupKeyword("SELECT"), TokenType::SELECT);
+    EXPECT_EQ(lookupKeyword("select"), TokenType::SELECT);
+    EXPECT_EQ(lookupKeyword("Descending"), TokenType::DESC);
+    EXPECT_EQ(lookupKeyword("temp"), TokenType::TEMPORARY);
+    EXPECT_EQ(lookupKeyword("NoLogin"), TokenType::NO_LOGIN);
+    EXPECT_EQ(lookupKeyword("allow_connections"), TokenType::ALLOW_CONNECTIONS);
+    EXPECT_EQ(lookupKeyword("null"), TokenType::NULL_TYPE);
+    EXPECT_EQ(lookupKeyword("Cast"), TokenType::CAST);
+    EXPECT_EQ(lookupKeyword("as"), TokenType::AS);
+
+    // Near misses and plain identifiers
+    EXPECT_EQ(lookupKeyword("selects"), TokenType::IDENTIFIER);
+    EXPECT_EQ(lookupKeyword("selec"), TokenType::IDENTIFIER);
+    EXPECT_EQ(lookupKeyword("users"), TokenType::IDENTIFIER);
+    EXPECT_EQ(lookupKeyword("x"), TokenType::IDENTIFIER);
+    EXPECT_EQ(lookupKeyword(""), TokenType::IDENTIFIER);
+}
+
+TEST(LexerTest, TestScanKernelsMatchScalar) {
+    // Bytes around every class boundary the kernels test, plus NUL and non-ASCII
+    const std::string alphabet = std::string("aZz_09.' \t\n\r@[`{/:-\x80\xff", 21) + '\0';
+    const ScanKernels &scalar = scalarScanKernels();
+
+    std::vector<const ScanKernels *> vectorized;
+    if (const ScanKernels *kernels = sse42ScanKernels()) vectorized.push_back(kernels);
+    if (const ScanKernels *kernels = avx2ScanKernels()) vectorized.push_back(kernels);
+
+    uint32_t seed = 12345;
+    const auto next = [&seed] { return seed = seed * 1103515245u + 12345u, seed >> 16; };
+
+    for (int round = 0; round < 200; ++round) {
+        // Long runs of a single class, broken by a random byte at a random distance
+        std::string buffer(next() % 100, 'a');
+        for (auto &c : buffer) {
+            c = next() % 8 == 0 ? alphabet[next() % alphabet.size()] : alphabet[round % alphabet.size()];
+        }
+
+        for (const ScanKernels *kernels : vectorized) {
+            for (size_t start = 0; start <= buffer.size(); ++start) {
+                const char *data = buffer.data() + start;
+                const size_t length = buffer.size() - start;
+                EXPECT_EQ(kernels->identifier(data, length), scalar.identifier(data, length)) << kernels->name;
+                EXPECT_EQ(kernels->number(data, length), scalar.number(data, length)) << kernels->name;
+                EXPECT_EQ(kernels->whitespace(data, length), scalar.whitespace(data, length)) << kernels->name;
+                EXPECT_EQ(kernels->stringBody(data, length), scalar.stringBody(data, length)) << kernels->name;
+            }
+        }
+    }
+}
+
+TEST(LexerTest, TestLongRunsKeepPositions) {
+    const std::string longName(70, 'n');
+    const std::string longText(100, 'x');
+    const std::string input = "INSERT  \n\n   " + longName + " '" + longText + "'\r\n\t 1234567890.123456789012345678901234567890 ;";
+
+    Lexer lexer(input);
+    const auto at = [&lexer](const Token &tok) {
+        const SourceLocation where = lexer.location(tok.offset);
+        return std::pair{where.line, where.column};
+    };
+
+    Token tok = lexer.NextToken();
+    EXPECT_EQ(tok.type, TokenType::INSERT);
+    EXPECT_EQ(at(tok), std::pair(1, 1));
+
+    tok = lexer.NextToken();
+    EXPECT_EQ(tok.type, TokenType::IDENTIFIER);
+    EXPECT_EQ(tok.literal, longName);
+    EXPECT_EQ(at(tok), std::pair(3, 4));
+
+    tok = lexer.NextToken();
+    EXPECT_EQ(tok.type, TokenType::STRING);
+    EXPECT_EQ(tok.literal, longText);
+    EXPECT_EQ(at(tok), std::pair(3, 75)); // The opening quote
+
+    tok = lexer.NextToken();
+    EXPECT_EQ(tok.type, TokenType::NUMBER);
+    EXPECT_EQ(tok.literal, "1234567890.123456789012345678901234567890");
+    EXPECT_EQ(at(tok), std::pair(4, 3));
+
+    EXPECT_EQ(lexer.NextToken().type, TokenType::SEMICOLON);
+    EXPECT_EQ(lexer.NextToken().type, TokenType::EOF_TOKEN);
+}
+
+TEST(LexerTest, TestLocationOfSlice) {
+    // A slice of a script that starts at line 5, column 9, as the statement reader hands them out
+    const std::string script = "SELECT\n  a,\n\n b FROM t;";
+    Lexer lexer(std::string_view(script), borrow_input, 5, 9);
+
+    // Positions can be asked for in any order; the newline table only grows
+    EXPECT_EQ(lexer.location(static_cast<uint32_t>(script.find('b'))).line, 8);
+    EXPECT_EQ(lexer.location(static_cast<uint32_t>(script.find('b'))).column, 2);
+    EXPECT_EQ(lexer.location(0).line, 5);
+    EXPECT_EQ(lexer.location(0).column, 9);
+    EXPECT_EQ(lexer.location(static_cast<uint32_t>(script.find('a'))).line, 6);
+    EXPECT_EQ(lexer.location(static_cast<uint32_t>(script.find('a'))).column, 3);
+    EXPECT_EQ(lexer.location(static_cast<uint32_t>(script.size())).line, 8);
+}
+
+TEST(LexerTest, TestParameterPlaceholders) {
+    Lexer lexer(std::string("a = $12 AND ? $"));
+    const std::vector<ExpectedToken> expected = {
+        {TokenType::IDENTIFIER, "a"},
+        {TokenType::EQUALS, "="},
+        {TokenType::PARAMETER, "$12"},
+        {TokenType::IDENTIFIER, "AND"},
+        {TokenType::PARAMETER, "?"},
+        {TokenType::ILLEGAL, "$"},
+        {TokenType::EOF_TOKEN, ""},
+    };
+    for (const auto &[type, literal] : expected) {
+        const Token token = lexer.NextToken();
+        EXPECT_EQ(token.type, type) << literal;
+        EXPECT_EQ(token.literal, literal);
+    }
+}
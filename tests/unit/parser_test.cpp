@@ -21,11 +21,20 @@ fluxo_db in-memory database
 //
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
 #include <variant>
 #include <vector>
 #include <string>
+#include <thread>
 
 #include "src/parser/parser.h"
+#include "src/ast/fingerprint.h"
+#include "src/parser/parallel_parser.h"
+#include "src/parser/prepared_statement.h"
+#include "src/parser/statement_cache.h"
+#include "src/parser/statement_reader.h"
+#include "src/parser/trace.h"
 #include "../../src/ast/ast.h"
 #include "../../src/lexer/lexer.h"
 
@@ -129,4 +138,609 @@ TEST_F(ParserTest, ParseDropStatementWithOnCascade) {
     ASSERT_NE(dropStmt, nullptr) << "Expected a DropTableStmt";
     EXPECT_EQ(dropStmt->table_name, "users");
     EXPECT_TRUE(dropStmt->cascade);
-}
\ No newline at end of file
+}
+
+TEST_F(ParserTest, NextStatementYieldsOneAtATime) {
+    Lexer lexer(std::string("SELECT a FROM t; SELECT b FROM u;"));
+    Parser parser(lexer);
+
+    auto first = parser.next_statement();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(std::get<SelectStmt>(*first).from[0].name, "t");
+
+    auto second = parser.next_statement();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(std::get<SelectStmt>(*second).from[0].name, "u");
+
+    EXPECT_FALSE(parser.next_statement().has_value());
+}
+
+TEST_F(ParserTest, StatementReaderMatchesParse) {
+    const std::string script =
+        "SELECT a FROM t;\n"
+        "SELECT 'semi;colon' FROM u WHERE x = 1;\n"
+        "SELECT (1 + 2) * 3 FROM v SELECT 'multi\nline' FROM w;\n"
+        "SELECT z FROM final_table  ";
+    const auto expected = parseSQL(script).size();
+
+    for (const size_t chunk_size : {1, 3, 7, 64, 4096}) {
+        std::istringstream stream(script);
+        StatementReader reader(stream, chunk_size);
+
+        std::vector<Statement> statements;
+        while (auto statement = reader.next()) {
+            statements.push_back(std::move(*statement));
+        }
+        ASSERT_EQ(statements.size(), expected) << "chunk size " << chunk_size;
+
+        const auto &second = std::get<SelectStmt>(statements[1]);
+        const auto *literal = std::get_if<LiteralValue>(&second.projections[0]);
+        ASSERT_NE(literal, nullptr);
+        EXPECT_EQ(std::get<std::string>(literal->value), "semi;colon");
+        EXPECT_EQ(std::get<SelectStmt>(statements.back()).from[0].name, "final_table");
+    }
+}
+
+TEST_F(ParserTest, SplittingStopsAtNulLikeTheLexer) {
+    // The lexer treats NUL as end of input, even inside a string, so nothing after it may be parsed: the tail would
+    // fail if it were
+    std::string body;
+    for (int i = 0; i < 2000; ++i) body += "SELECT id FROM t WHERE id = " + std::to_string(i) + ";\n";
+    const std::string nul(1, '\0');
+    const std::string tail = "; SELECT * FROM;\n" + body;
+
+    for (const std::string &script : {body + "SELECT a FROM t" + nul + tail, body + "SELECT 'ab" + nul + "c' FROM t" + tail,
+                                      body + nul + tail}) {
+        const std::vector<Statement> sequential = parseSQL(script);
+        ASSERT_GE(sequential.size(), 2000u);
+
+        const std::vector<Statement> parallel = parse_parallel(script, 4);
+        ASSERT_EQ(parallel.size(), sequential.size());
+        for (size_t chunk_size : {1, 7, 4096}) {
+            std::istringstream stream(script);
+            StatementReader reader(stream, chunk_size);
+            size_t count = 0;
+            while (auto statement = reader.next()) {
+                ASSERT_LT(count, sequential.size());
+                EXPECT_EQ(fingerprint(*statement), fingerprint(sequential[count])) << "chunk size " << chunk_size;
+                ++count;
+            }
+            EXPECT_EQ(count, sequential.size()) << "chunk size " << chunk_size;
+        }
+        for (size_t i = 0; i < parallel.size(); ++i) {
+            EXPECT_EQ(fingerprint(parallel[i]), fingerprint(sequential[i])) << "statement " << i;
+        }
+    }
+}
+
+TEST_F(ParserTest, StatementReaderReportsScriptPositions) {
+    const std::string script = "SELECT a FROM t;\n  SELECT 'x\ny' FROM u;\nSELECT b FROM v; SELECT (1 + 2;";
+
+    std::string expected;
+    try {
+        parseSQL(script);
+    } catch (const std::runtime_error &e) {
+        expected = e.what();
+    }
+    ASSERT_FALSE(expected.empty());
+
+    std::istringstream stream(script);
+    StatementReader reader(stream, 5);
+    std::string actual;
+    try {
+        while (reader.next()) {}
+    } catch (const std::runtime_error &e) {
+        actual = e.what();
+    }
+    EXPECT_EQ(actual, expected);
+    EXPECT_NE(actual.find("line 4"), std::string::npos) << actual;
+}
+
+TEST_F(ParserTest, ParseCreateTable) {
+    const auto statements = parseSQL(
+        "CREATE TABLE IF NOT EXISTS users (id BIGINT PRIMARY KEY, email TEXT NOT NULL UNIQUE, UNIQUE (email, id));");
+
+    ASSERT_EQ(statements.size(), 1);
+    const auto* createStmt = std::get_if<CreateStmt>(&statements[0]);
+    ASSERT_NE(createStmt, nullptr) << "Expected a CreateStmt";
+    const auto* tableStmt = std::get_if<CreateTableStmt>(createStmt);
+    ASSERT_NE(tableStmt, nullptr) << "Expected a CreateTableStmt";
+
+    EXPECT_EQ(tableStmt->table_name, "users");
+    EXPECT_TRUE(tableStmt->if_not_exists);
+    ASSERT_EQ(tableStmt->columns.size(), 2);
+    EXPECT_EQ(tableStmt->columns[0].type, DataType::BIGINT);
+    EXPECT_TRUE(tableStmt->columns[0].primary_key);
+    EXPECT_TRUE(tableStmt->columns[1].not_null);
+    EXPECT_TRUE(tableStmt->columns[1].unique);
+    ASSERT_EQ(tableStmt->constraints.size(), 1);
+    EXPECT_EQ(tableStmt->constraints[0].type, TableConstraint::Type::UNIQUE);
+}
+
+TEST_F(ParserTest, ParseCreateSchemaElements) {
+    const auto statements = parseSQL(
+        "CREATE SCHEMA AUTHORIZATION me sales CREATE TABLE orders (id BIGINT, total DOUBLE)"
+        " CREATE UNIQUE INDEX orders_id ON orders (id); SELECT id FROM orders;");
+
+    ASSERT_EQ(statements.size(), 2);
+    const auto &schema = std::get<CreateSchemaStmt>(std::get<CreateStmt>(statements[0]));
+    EXPECT_EQ(schema.schema_name, "sales");
+    ASSERT_TRUE(schema.schema_elements.has_value());
+    ASSERT_EQ(schema.schema_elements->size(), 2);
+    EXPECT_EQ(std::get<CreateTableStmt>(schema.schema_elements->at(0)).table_name, "orders");
+    EXPECT_TRUE(std::get<CreateIndexStmt>(schema.schema_elements->at(1)).unique);
+
+    Lexer lexer(std::string("CREATE SCHEMA s CREATE ROLE r;"));
+    Parser parser(lexer);
+    const auto nested = parser.try_parse();
+    ASSERT_FALSE(nested.has_value());
+    EXPECT_EQ(nested.error().column, 17);
+}
+
+TEST_F(ParserTest, ParseInsert) {
+    const auto statements = parseSQL("INSERT INTO users (id, name) VALUES (1, 'a'), (2, 'b'); INSERT INTO users VALUES (3, 'c');");
+
+    ASSERT_EQ(statements.size(), 2);
+    const auto* insertStmt = std::get_if<InsertStmt>(&statements[0]);
+    ASSERT_NE(insertStmt, nullptr) << "Expected an InsertStmt";
+    EXPECT_EQ(insertStmt->table_name, "users");
+    ASSERT_EQ(insertStmt->columns.size(), 2);
+    EXPECT_EQ(insertStmt->columns[1], "name");
+    EXPECT_EQ(insertStmt->row_count(), 2);
+    ASSERT_TRUE(insertStmt->bulk.has_value());
+    EXPECT_EQ(insertStmt->bulk->columns.size(), 2);
+
+    const auto* secondInsert = std::get_if<InsertStmt>(&statements[1]);
+    ASSERT_NE(secondInsert, nullptr) << "Expected an InsertStmt";
+    EXPECT_TRUE(secondInsert->columns.empty());
+    EXPECT_EQ(secondInsert->row_count(), 1);
+}
+
+TEST_F(ParserTest, BulkInsertFillsColumnBuffers) {
+    const auto statements = parseSQL(
+        "INSERT INTO t VALUES (1, 2.5, 'ab', NULL, TRUE), (NULL, 3.25, '', 9223372036854775807, FALSE), (3, NULL, 'c', 4, NULL);");
+    const auto &insert = std::get<InsertStmt>(statements[0]);
+    ASSERT_TRUE(insert.bulk.has_value());
+    EXPECT_TRUE(insert.values.empty());
+    const BulkValues &bulk = *insert.bulk;
+    ASSERT_EQ(bulk.row_count, 3u);
+    ASSERT_EQ(bulk.columns.size(), 5u);
+
+    const ColumnBuffer &ids = bulk.columns[0];
+    EXPECT_EQ(ids.type, DataType::INTEGER);
+    EXPECT_EQ(ids.integers, (std::vector<int64_t>{1, 0, 3}));
+    EXPECT_FALSE(ids.is_null(0));
+    EXPECT_TRUE(ids.is_null(1));
+
+    EXPECT_EQ(bulk.columns[1].type, DataType::DOUBLE);
+    EXPECT_EQ(bulk.columns[1].doubles, (std::vector<double>{2.5, 3.25, 0}));
+    EXPECT_TRUE(bulk.columns[1].is_null(2));
+
+    const ColumnBuffer &names = bulk.columns[2];
+    EXPECT_EQ(names.type, DataType::TEXT);
+    EXPECT_EQ(names.string_data, "abc");
+    EXPECT_EQ(names.string_offsets, (std::vector<uint32_t>{0, 2, 2, 3}));
+    EXPECT_FALSE(names.is_null(1));
+
+    // A column whose first values are NULL takes its type from the first non-NULL value
+    EXPECT_EQ(bulk.columns[3].type, DataType::INTEGER);
+    EXPECT_EQ(bulk.columns[3].integers, (std::vector<int64_t>{0, INT64_MAX, 4}));
+    EXPECT_TRUE(bulk.columns[3].is_null(0));
+
+    EXPECT_EQ(bulk.columns[4].type, DataType::BOOLEAN);
+    EXPECT_EQ(bulk.columns[4].integers, (std::vector<int64_t>{1, 0, 0}));
+    EXPECT_TRUE(bulk.columns[4].is_null(2));
+}
+
+TEST_F(ParserTest, BulkInsertFoldsNegativeNumbers) {
+    const auto statements = parseSQL("INSERT INTO t VALUES (-1, -2.5), (3, 4.0), (-9223372036854775807, -0.0);");
+    const auto &insert = std::get<InsertStmt>(statements[0]);
+    ASSERT_TRUE(insert.bulk.has_value());
+    const BulkValues &bulk = *insert.bulk;
+    ASSERT_EQ(bulk.row_count, 3u);
+    EXPECT_EQ(bulk.columns[0].type, DataType::INTEGER);
+    EXPECT_EQ(bulk.columns[0].integers, (std::vector<int64_t>{-1, 3, -INT64_MAX}));
+    EXPECT_EQ(bulk.columns[1].type, DataType::DOUBLE);
+    EXPECT_EQ(bulk.columns[1].doubles, (std::vector<double>{-2.5, 4.0, -0.0}));
+    EXPECT_TRUE(std::signbit(bulk.columns[1].doubles[2]));
+
+    // A sign that is not directly on a lone number still needs the expression parser
+    for (const char *sql : {"INSERT INTO t VALUES (- -1);", "INSERT INTO t VALUES (-1 + 2);",
+                            "INSERT INTO t VALUES (-'a');"}) {
+        EXPECT_FALSE(std::get<InsertStmt>(parseSQL(sql)[0]).bulk.has_value()) << sql;
+    }
+}
+
+TEST_F(ParserTest, BulkInsertFallsBackToExpressions) {
+    const auto literalValue = [](const Expr &expr) { return std::get<LiteralValue>(expr).value; };
+
+    // An expression in a later row moves every earlier row into `values`
+    const auto withExpr = parseSQL("INSERT INTO t VALUES (1, 'a'), (2, NULL), (3, 'c' + 1), (4, 'd');");
+    const auto &mixed = std::get<InsertStmt>(withExpr[0]);
+    EXPECT_FALSE(mixed.bulk.has_value());
+    ASSERT_EQ(mixed.values.size(), 4u);
+    EXPECT_EQ(std::get<int64_t>(literalValue(mixed.values[1][0])), 2);
+    EXPECT_EQ(std::get<LiteralValue>(mixed.values[1][1]).type, DataType::NULL_TYPE);
+    EXPECT_EQ(std::get<int64_t>(literalValue(mixed.values[2][0])), 3);
+    EXPECT_TRUE(std::holds_alternative<std::unique_ptr<BinaryOp>>(mixed.values[2][1]));
+    EXPECT_EQ(std::get<std::string>(literalValue(mixed.values[3][1])), "d");
+
+    // So do a literal of another type and a row of another width
+    const auto retyped = parseSQL("INSERT INTO t VALUES (1), (2.5);");
+    ASSERT_FALSE(std::get<InsertStmt>(retyped[0]).bulk.has_value());
+    EXPECT_EQ(std::get<double>(literalValue(std::get<InsertStmt>(retyped[0]).values[1][0])), 2.5);
+    const auto ragged = parseSQL("INSERT INTO t VALUES (1, 2), (3);");
+    ASSERT_EQ(std::get<InsertStmt>(ragged[0]).values.size(), 2u);
+    EXPECT_EQ(std::get<InsertStmt>(ragged[0]).values[1].size(), 1u);
+
+    // Errors are reported exactly as on the general path
+    Lexer lexer(std::string("INSERT INTO t VALUES (1), (99999999999999999999);"));
+    Parser parser(lexer);
+    const auto result = parser.try_parse();
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().message, "Invalid integer 99999999999999999999");
+}
+
+TEST_F(ParserTest, ParseCreateIndexAndSequence) {
+    const auto statements = parseSQL(
+        "CREATE UNIQUE INDEX idx_email ON users (email DESC NULLS LAST, id);"
+        "CREATE SEQUENCE user_ids INCREMENT BY 2 START WITH 10 OWNED BY users.id;");
+
+    ASSERT_EQ(statements.size(), 2);
+    const auto& indexStmt = std::get<CreateIndexStmt>(std::get<CreateStmt>(statements[0]));
+    EXPECT_TRUE(indexStmt.unique);
+    EXPECT_EQ(indexStmt.table_name, "users");
+    ASSERT_EQ(indexStmt.params.size(), 2);
+    EXPECT_EQ(indexStmt.params[0].ordering, OrderDirection::DESC);
+    EXPECT_EQ(indexStmt.params[0].nulls_first, false);
+
+    const auto& sequenceStmt = std::get<CreateSequenceStmt>(std::get<CreateStmt>(statements[1]));
+    EXPECT_EQ(sequenceStmt.sequence_name, "user_ids");
+    EXPECT_EQ(sequenceStmt.increment_by, 2);
+    EXPECT_EQ(sequenceStmt.start_value, 10);
+    ASSERT_TRUE(sequenceStmt.owner.has_value());
+    EXPECT_EQ(sequenceStmt.owner->second, "id");
+}
+
+TEST_F(ParserTest, ErrorMessageNamesOffendingToken) {
+    const auto messageOf = [](const std::string& sql) -> std::string {
+        try {
+            parseSQL(sql);
+        } catch (const std::runtime_error& e) {
+            return e.what();
+        }
+        return "";
+    };
+
+    EXPECT_EQ(messageOf("SELECT * FROM;"), "Expected table name after FROM at line 1, column 14");
+    EXPECT_EQ(messageOf("CREATE TABLE t (id INT,\n  name NOPE);"), "Unknown data type: NOPE at line 2, column 8");
+    EXPECT_EQ(messageOf("CREATE SEQUENCE s INCREMENT 5;"), "Expected BY after INCREMENT in CREATE SEQUENCE at line 1, column 29");
+}
+
+TEST_F(ParserTest, ArenaStatementMatchesHeapParse) {
+    Lexer lexer(std::string("SELECT a + b * 2 FROM t WHERE a = 1; SELECT c FROM t;"));
+    Parser parser(lexer);
+
+    auto first = parser.next_arena_statement();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(AstArena::current(), nullptr);
+
+    const auto *select = std::get_if<SelectStmt>(&first->statement());
+    ASSERT_NE(select, nullptr);
+    const auto *plus = std::get_if<std::unique_ptr<BinaryOp>>(&select->projections[0]);
+    ASSERT_NE(plus, nullptr);
+    EXPECT_EQ(plus->get()->op, BinaryOp::Op::PLUS);
+    const auto *mul = std::get_if<std::unique_ptr<BinaryOp>>(&plus->get()->right);
+    ASSERT_NE(mul, nullptr);
+    EXPECT_EQ(mul->get()->op, BinaryOp::Op::MUL);
+    ASSERT_TRUE(select->where.has_value());
+
+    auto second = parser.next_arena_statement();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_NE(&second->arena(), &first->arena());
+    EXPECT_FALSE(parser.next_arena_statement().has_value());
+}
+
+TEST_F(ParserTest, ArenaScopesNestAndMixWithHeapNodes) {
+    auto heapNode = std::make_unique<BinaryOp>();
+    heapNode->op = BinaryOp::Op::EQ;
+
+    AstArena outer;
+    {
+        AstArena::Scope outerScope(outer);
+        EXPECT_EQ(AstArena::current(), &outer);
+        {
+            AstArena inner;
+            AstArena::Scope innerScope(inner);
+            EXPECT_EQ(AstArena::current(), &inner);
+        }
+        EXPECT_EQ(AstArena::current(), &outer);
+
+        // A heap node adopted by an arena tree is still returned to the heap when the tree is destroyed
+        auto arenaNode = std::make_unique<BinaryOp>();
+        arenaNode->left = std::move(heapNode);
+        auto cast = std::make_unique<CastExpr>();
+        cast->expr = std::make_unique<Expression>(std::move(arenaNode));
+    }
+    EXPECT_EQ(AstArena::current(), nullptr);
+}
+
+TEST_F(ParserTest, TraceRingKeepsNewestEvents) {
+    TraceRing<4> ring;
+    const Token token{TokenType::PLUS, "+", 2};
+    for (int i = 0; i < 6; ++i) {
+        ring.record("test", token, i);
+    }
+
+    EXPECT_EQ(ring.recorded(), 6u);
+    const std::vector<TraceEvent> events = ring.snapshot();
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events.front().value, 2);
+    EXPECT_EQ(events.back().value, 5);
+    EXPECT_EQ(events.back().token, TokenType::PLUS);
+    EXPECT_EQ(events.back().offset, 2u);
+}
+
+TEST_F(ParserTest, ParseExpressionTraceFollowsBuildOption) {
+    parser_trace().clear();
+    parseSQL("SELECT a + b * 2 FROM t;");
+#if defined(FLUXO_TRACE) && FLUXO_TRACE
+    const std::vector<TraceEvent> events = parser_trace().snapshot();
+    ASSERT_FALSE(events.empty());
+    EXPECT_STREQ(events.front().site, "parse_expression");
+    EXPECT_EQ(events.front().token, TokenType::PLUS);
+    EXPECT_EQ(events.front().value, 4);
+#else
+    EXPECT_EQ(parser_trace().recorded(), 0u);
+#endif
+}
+
+TEST_F(ParserTest, TryParseReturnsErrorsInsteadOfThrowing) {
+    const auto tryParse = [](const std::string& sql) {
+        Lexer lexer(sql);
+        Parser parser(lexer);
+        return parser.try_parse();
+    };
+
+    const auto good = tryParse("SELECT a FROM t; INSERT INTO t (a) VALUES (1);");
+    ASSERT_TRUE(good.has_value());
+    EXPECT_EQ(good->size(), 2u);
+
+    const auto bad = tryParse("SELECT a FROM t;\nCREATE TABLE t (id INT,\n  name NOPE);");
+    ASSERT_FALSE(bad.has_value());
+    EXPECT_EQ(bad.error().message, "Unknown data type: NOPE");
+    EXPECT_EQ(bad.error().line, 3);
+    EXPECT_EQ(bad.error().column, 8);
+    EXPECT_EQ(bad.error().to_string(), "Unknown data type: NOPE at line 3, column 8");
+
+    const auto overflow = tryParse("CREATE SEQUENCE s START WITH 99999999999999999999;");
+    ASSERT_FALSE(overflow.has_value());
+    EXPECT_EQ(overflow.error().message, "Invalid integer 99999999999999999999");
+
+    EXPECT_FALSE(tryParse("SELECT a ^ b FROM t;").has_value());
+}
+
+TEST_F(ParserTest, TryParseTerminatesOnEveryTruncation) {
+    // Every prefix of a script touching each grammar rule must come back as a value or an error, never a throw or hang
+    const std::string script =
+        "CREATE TABLE IF NOT EXISTS t (id BIGINT PRIMARY KEY, name TEXT NOT NULL UNIQUE, CONSTRAINT pk PRIMARY KEY (id),"
+        " FOREIGN KEY (name) REFERENCES u (name), CHECK (id = 1));"
+        "CREATE UNIQUE INDEX i ON t USING btree (id DESC NULLS FIRST, name) WHERE id = 2;"
+        "CREATE SEQUENCE s INCREMENT BY -2 MINVALUE 1 MAXVALUE 9 START WITH 3 CACHE 4 NO CYCLE OWNED BY t.id;"
+        "CREATE TRIGGER tr BEFORE INSERT OR UPDATE OF id, name FOR EACH ROW WHEN (id = 1) ON t EXECUTE FUNCTION f(1, 'x');"
+        "CREATE COLLATION c (LOCALE = 'de', DETERMINISTIC = FALSE, PROVIDER = 'icu');"
+        "CREATE DATABASE d (OWNER = me, ENCODING = 'UTF8', ALLOW_CONNECTIONS = TRUE, CONNECTION_LIMIT = 5);"
+        "CREATE SCHEMA IF NOT EXISTS AUTHORIZATION me sch;"
+        "CREATE ROLE r WITH LOGIN SUPERUSER;"
+        "INSERT INTO t (id, name) VALUES (1, 'a'), (2.5, 'b');"
+        "SELECT id, (id + 2) * 3 FROM t, u WHERE id = 4;"
+        "ALTER TABLE IF EXISTS t ADD COLUMN IF NOT EXISTS x INT NOT NULL, DROP CONSTRAINT IF EXISTS pk CASCADE,"
+        " ALTER COLUMN x TYPE BIGINT USING x * 2, RENAME COLUMN x TO y, SET SCHEMA other, OWNER TO me;"
+        "DROP TABLE IF EXISTS t, u CASCADE;";
+
+    for (size_t length = 0; length <= script.size(); ++length) {
+        Lexer lexer(script.substr(0, length));
+        Parser parser(lexer);
+        EXPECT_NO_THROW(static_cast<void>(parser.try_parse())) << "prefix length " << length;
+    }
+}
+
+TEST_F(ParserTest, ParsesUnaryMinusAndCast) {
+    const auto statements = parseSQL("SELECT -a * 2, CAST(b + 1 AS bigint) FROM t;");
+    const auto &select = std::get<SelectStmt>(statements[0]);
+
+    const auto &mul = std::get<std::unique_ptr<BinaryOp>>(select.projections[0]);
+    EXPECT_EQ(mul->op, BinaryOp::MUL);
+    const auto &negate = std::get<std::unique_ptr<UnaryOp>>(mul->left);
+    EXPECT_EQ(negate->op, UnaryOp::MINUS);
+    EXPECT_EQ(std::get<ColumnRef>(*negate->operand).name, "a");
+
+    const auto &cast = std::get<std::unique_ptr<CastExpr>>(select.projections[1]);
+    EXPECT_EQ(cast->target_type, DataType::BIGINT);
+    EXPECT_TRUE(std::holds_alternative<std::unique_ptr<BinaryOp>>(*cast->expr));
+
+    Lexer lexer(std::string("SELECT CAST(b bigint) FROM t;"));
+    Parser parser(lexer);
+    const auto result = parser.try_parse();
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().message, "Expected AS in CAST");
+}
+
+TEST_F(ParserTest, ParsesExpressionsWithoutRecursion) {
+    const auto statements = parseSQL("SELECT a - b - c, -(a + b) * c, ((a)) FROM t;");
+    const auto &select = std::get<SelectStmt>(statements[0]);
+
+    // Equal precedence associates to the left
+    const auto &outer = std::get<std::unique_ptr<BinaryOp>>(select.projections[0]);
+    EXPECT_EQ(std::get<ColumnRef>(outer->right).name, "c");
+    EXPECT_EQ(std::get<ColumnRef>(std::get<std::unique_ptr<BinaryOp>>(outer->left)->right).name, "b");
+
+    const auto &mul = std::get<std::unique_ptr<BinaryOp>>(select.projections[1]);
+    EXPECT_EQ(mul->op, BinaryOp::MUL);
+    const auto &negate = std::get<std::unique_ptr<UnaryOp>>(mul->left);
+    EXPECT_EQ(std::get<std::unique_ptr<BinaryOp>>(*negate->operand)->op, BinaryOp::PLUS);
+    EXPECT_EQ(std::get<ColumnRef>(select.projections[2]).name, "a");
+
+    // Far deeper than a recursive parser or destructor could go on a worker thread's stack
+    constexpr size_t depth = 300000;
+    std::string chain = "SELECT a";
+    for (size_t i = 0; i < depth; ++i) chain += " + a";
+    std::string parens = "SELECT " + std::string(depth, '(') + "a" + std::string(depth, ')') + ";";
+    std::string negations = "SELECT ";
+    for (size_t i = 0; i < depth; ++i) negations += "- ";
+    negations += "a;";
+
+    auto deep = parseSQL(chain + ";");
+    size_t levels = 0;
+    for (const Expr *node = &std::get<SelectStmt>(deep[0]).projections[0];
+         const auto *binary = std::get_if<std::unique_ptr<BinaryOp>>(node); node = &(*binary)->left) {
+        ++levels;
+    }
+    EXPECT_EQ(levels, depth);
+    deep.clear();
+
+    EXPECT_EQ(std::get<ColumnRef>(std::get<SelectStmt>(parseSQL(parens)[0]).projections[0]).name, "a");
+    EXPECT_TRUE(std::holds_alternative<std::unique_ptr<UnaryOp>>(std::get<SelectStmt>(parseSQL(negations)[0]).projections[0]));
+
+    // Preparing walks the whole tree again, to fold it and to fingerprint it
+    EXPECT_NE(PreparedStatement::prepare(chain)->fingerprint(), 0u);
+    std::string sum = "SELECT 1";
+    for (size_t i = 0; i < depth; ++i) sum += " + 1";
+    const auto folded = PreparedStatement::prepare(sum);
+    const auto &total = std::get<LiteralValue>(std::get<SelectStmt>(folded->statement()).projections[0]);
+    EXPECT_EQ(std::get<int64_t>(total.value), static_cast<int64_t>(depth + 1));
+    const auto negated = PreparedStatement::prepare(negations);
+    EXPECT_TRUE(std::holds_alternative<std::unique_ptr<UnaryOp>>(std::get<SelectStmt>(negated->statement()).projections[0]));
+
+    // And so does normalizing it, which replaces every literal of the chain, leftmost first
+    std::string literals = "SELECT a FROM t WHERE a = 1";
+    for (size_t i = 0; i < depth; ++i) literals += " + 2";
+    Statement normalized = std::move(parseSQL(literals + ";")[0]);
+    const uint64_t shape = fingerprint(normalized);
+    const std::vector<LiteralValue> removed = normalize_literals(normalized);
+    ASSERT_EQ(removed.size(), depth + 1);
+    EXPECT_EQ(std::get<int64_t>(removed.front().value), 1);
+    EXPECT_EQ(std::get<int64_t>(removed.back().value), 2);
+    EXPECT_EQ(fingerprint(normalized), shape);
+
+    Lexer lexer(std::string("SELECT ((a + 1) * 2 FROM t;"));
+    Parser parser(lexer);
+    const auto unbalanced = parser.try_parse();
+    ASSERT_FALSE(unbalanced.has_value());
+    EXPECT_EQ(unbalanced.error().message, "Expected ')'");
+}
+
+TEST_F(ParserTest, ParsesParameterPlaceholders) {
+    Lexer lexer(std::string("SELECT a FROM t WHERE a = ? + $3 * ?; SELECT b FROM t;"));
+    Parser parser(lexer);
+
+    const auto first = parser.next_statement();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(parser.parameter_count(), 3u);
+    const auto &where = *std::get<SelectStmt>(*first).where;
+    const auto &eq = std::get<std::unique_ptr<BinaryOp>>(where);
+    const auto &plus = std::get<std::unique_ptr<BinaryOp>>(eq->right);
+    EXPECT_EQ(std::get<ParameterRef>(plus->left).index, 1u);
+    const auto &mul = std::get<std::unique_ptr<BinaryOp>>(plus->right);
+    EXPECT_EQ(std::get<ParameterRef>(mul->left).index, 3u);
+    EXPECT_EQ(std::get<ParameterRef>(mul->right).index, 2u);
+
+    ASSERT_TRUE(parser.next_statement().has_value());
+    EXPECT_EQ(parser.parameter_count(), 0u);
+
+    Lexer invalid(std::string("SELECT $0 FROM t;"));
+    Parser invalidParser(invalid);
+    const auto result = invalidParser.try_parse();
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().message, "Invalid parameter $0");
+}
+
+TEST_F(ParserTest, StatementCacheReusesAndEvicts) {
+    StatementCache cache(2);
+    const auto first = cache.get_or_prepare("SELECT a FROM t WHERE a = $1;");
+    EXPECT_EQ(first->parameter_count(), 1u);
+    EXPECT_EQ(cache.get_or_prepare("SELECT a FROM t WHERE a = $1;"), first);
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 1u);
+
+    cache.get_or_prepare("SELECT b FROM t;");
+    cache.get_or_prepare("SELECT a FROM t WHERE a = $1;"); // Refresh, so the next insert evicts "SELECT b"
+    cache.get_or_prepare("SELECT c FROM t;");
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.find("SELECT b FROM t;"), nullptr);
+    EXPECT_EQ(cache.find("SELECT a FROM t WHERE a = $1;"), first);
+
+    EXPECT_THROW(cache.get_or_prepare("SELECT FROM;"), std::runtime_error);
+    EXPECT_THROW(cache.get_or_prepare("SELECT a FROM t; SELECT b FROM t;"), std::runtime_error);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST_F(ParserTest, StatementCacheShardsAcrossThreads) {
+    StatementCache cache(1000);
+    EXPECT_EQ(cache.shard_count(), 8u);
+    EXPECT_EQ(StatementCache(2).shard_count(), 1u);
+
+    std::vector<std::string> queries;
+    for (int i = 0; i < 200; ++i) {
+        queries.push_back("SELECT a FROM t WHERE a = " + std::to_string(i) + ";");
+    }
+    std::vector<std::vector<std::shared_ptr<const PreparedStatement>>> seen(4);
+    std::vector<std::thread> threads;
+    for (auto &statements : seen) {
+        threads.emplace_back([&cache, &queries, &statements] {
+            for (int round = 0; round < 3; ++round) {
+                for (const std::string &sql : queries) {
+                    statements.push_back(cache.get_or_prepare(sql));
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    // Every thread got the one shared instance of each statement, and each lookup counted once
+    for (const auto &statements : seen) {
+        for (size_t i = 0; i < statements.size(); ++i) {
+            EXPECT_EQ(statements[i], cache.find(queries[i % queries.size()]));
+        }
+    }
+    EXPECT_EQ(cache.size(), queries.size());
+    EXPECT_EQ(cache.hits() + cache.misses(), 4 * 3 * queries.size());
+
+    // Overfilling keeps every shard, and so the whole cache, within capacity
+    for (int i = 0; i < 3000; ++i) {
+        cache.get_or_prepare("SELECT b FROM t WHERE b = " + std::to_string(i) + ";");
+    }
+    EXPECT_LE(cache.size(), cache.capacity());
+    EXPECT_GT(cache.size(), cache.capacity() * 9 / 10);
+}
+
+TEST_F(ParserTest, ParallelParseMatchesSequential) {
+    std::string script;
+    for (int i = 0; i < 3000; ++i) {
+        script += "INSERT INTO t (id, note) VALUES (" + std::to_string(i) + ", 'semi;colon\nline');\n";
+        script += "SELECT id FROM t WHERE id = " + std::to_string(i) + "; CREATE SEQUENCE s" + std::to_string(i) + ";\n";
+    }
+
+    const std::vector<Statement> sequential = parseSQL(script);
+    const std::vector<Statement> parallel = parse_parallel(script, 4);
+    ASSERT_EQ(parallel.size(), sequential.size());
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        EXPECT_EQ(fingerprint(parallel[i]), fingerprint(sequential[i])) << "statement " << i;
+    }
+    EXPECT_EQ(std::get<CreateSequenceStmt>(std::get<CreateStmt>(parallel.back())).sequence_name, "s2999");
+
+    // Errors late in the script and in several chunks at once report the earliest one with its script position
+    const std::string broken = script + "SELECT * FROM;\n" + script + "CREATE TABLE t (id NOPE);";
+    std::string expected;
+    try {
+        parseSQL(broken);
+    } catch (const std::runtime_error& e) {
+        expected = e.what();
+    }
+    ASSERT_FALSE(expected.empty());
+    const auto result = try_parse_parallel(broken, 4);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().to_string(), expected);
+    EXPECT_EQ(result.error().line, 9001);
+}
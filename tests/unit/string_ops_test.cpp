@@ -0,0 +1,221 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/storage/string_ops.h"
+#include <array>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The same rows in a dictionary and a plain segment; nullopt is NULL
+std::array<ColumnSegment, 2> bothEncodings(const std::vector<std::optional<std::string>> &rows) {
+    std::array<ColumnSegment, 2> segments{ColumnSegment(PhysicalType::STRING, StringEncoding::DICTIONARY),
+                                          ColumnSegment(PhysicalType::STRING, StringEncoding::PLAIN)};
+    for (ColumnSegment &segment : segments) {
+        for (const std::optional<std::string> &row : rows) {
+            if (row) {
+                segment.append_string(*row);
+            } else {
+                segment.append_null();
+            }
+        }
+    }
+    return segments;
+}
+
+std::vector<size_t> selectedRows(const std::vector<uint64_t> &selected) {
+    std::vector<size_t> rows;
+    for (size_t row = 0; row < selected.size() * 64; ++row) {
+        if (selected[row / 64] >> (row % 64) & 1) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+const std::vector<std::optional<std::string>> statusRows = {
+        "open", "closed", std::nullopt, "open", "", "pending", "closed", std::nullopt, "open", ""};
+
+} // namespace
+
+TEST(StringOpsTest, DictionaryKeepsOneCopyOfEachValue) {
+    ColumnSegment segment(PhysicalType::STRING);
+    for (size_t row = 0; row < 1000; ++row) {
+        segment.append_string(row % 3 == 0 ? "DE" : row % 3 == 1 ? "FR" : "US");
+    }
+    segment.seal();
+    ASSERT_EQ(segment.encoding(), StringEncoding::DICTIONARY);
+    EXPECT_EQ(segment.dictionary_size(), 3u);
+    ASSERT_EQ(segment.strings().size(), 3u);
+    EXPECT_EQ(segment.dictionary_entry(1), "FR");
+    EXPECT_EQ(segment.codes().size(), 1000u);
+    EXPECT_EQ(segment.string(997), "FR");
+    EXPECT_EQ(segment.find_code("US"), 2);
+    EXPECT_FALSE(segment.find_code("IT").has_value());
+    EXPECT_LT(segment.data_bytes(), 1000 * sizeof(uint32_t));
+
+    segment.truncate(2);
+    EXPECT_EQ(segment.size(), 2u);
+    EXPECT_EQ(segment.string(1), "FR");
+    segment.append_string("IT");
+    EXPECT_EQ(segment.string(2), "IT");
+}
+
+TEST(StringOpsTest, FallsBackToPlainWhenTheDictionaryDoesNotPay) {
+    ColumnSegment unique(PhysicalType::STRING);
+    for (size_t row = 0; row < 500; ++row) {
+        unique.append_string("customer-" + std::to_string(row));
+    }
+    EXPECT_EQ(unique.encoding(), StringEncoding::DICTIONARY);
+    unique.seal();
+    ASSERT_EQ(unique.encoding(), StringEncoding::PLAIN);
+    EXPECT_EQ(unique.strings().size(), 500u);
+    EXPECT_EQ(unique.string(123), "customer-123");
+
+    // Past 2^16 distinct values the codes no longer fit and the segment switches while it is written
+    ColumnSegment overflow(PhysicalType::STRING);
+    for (size_t row = 0; row < max_dictionary_entries + 10; ++row) {
+        overflow.append_string(std::to_string(row));
+    }
+    EXPECT_EQ(overflow.encoding(), StringEncoding::PLAIN);
+    EXPECT_EQ(overflow.size(), max_dictionary_entries + 10);
+    EXPECT_EQ(overflow.string(max_dictionary_entries - 1), std::to_string(max_dictionary_entries - 1));
+    EXPECT_EQ(overflow.string(max_dictionary_entries + 9), std::to_string(max_dictionary_entries + 9));
+}
+
+TEST(StringOpsTest, EqualityAndInMatchAcrossEncodings) {
+    for (const ColumnSegment &segment : bothEncodings(statusRows)) {
+        std::vector<uint64_t> selected;
+        EXPECT_EQ(select_equal(segment, "open", selected), 3u);
+        EXPECT_EQ(selectedRows(selected), (std::vector<size_t>{0, 3, 8}));
+
+        // NULL rows hold an empty string but never match one
+        EXPECT_EQ(select_equal(segment, "", selected), 2u);
+        EXPECT_EQ(selectedRows(selected), (std::vector<size_t>{4, 9}));
+
+        EXPECT_EQ(select_equal(segment, "missing", selected), 0u);
+        EXPECT_EQ(selected.size(), 1u);
+
+        const std::array<std::string_view, 3> in_list{"closed", "pending", "missing"};
+        EXPECT_EQ(select_in(segment, in_list, selected), 3u);
+        EXPECT_EQ(selectedRows(selected), (std::vector<size_t>{1, 5, 6}));
+    }
+}
+
+TEST(StringOpsTest, SelectionCoversEveryWord) {
+    std::vector<std::optional<std::string>> rows;
+    for (size_t row = 0; row < 200; ++row) {
+        rows.emplace_back(row % 7 == 0 ? "hit" : "miss");
+    }
+    for (const ColumnSegment &segment : bothEncodings(rows)) {
+        std::vector<uint64_t> selected;
+        EXPECT_EQ(select_equal(segment, "hit", selected), 29u);
+        ASSERT_EQ(selected.size(), 4u);
+        EXPECT_EQ(selectedRows(selected).back(), 196u);
+    }
+}
+
+TEST(StringOpsTest, GroupsAcrossSegmentsAndEncodings) {
+    std::array<ColumnSegment, 2> first = bothEncodings(statusRows);
+    std::array<ColumnSegment, 2> second = bothEncodings({"pending", "archived", std::nullopt});
+
+    // One segment of each encoding feeds the same groups
+    StringGroups groups;
+    std::vector<uint32_t> ids;
+    groups.assign(first[0], ids);
+    groups.assign(second[1], ids);
+    ASSERT_EQ(ids.size(), statusRows.size() + 3);
+    ASSERT_EQ(groups.size(), 6u);
+
+    std::vector<std::optional<std::string>> keys;
+    for (const uint32_t id : ids) {
+        const std::optional<std::string_view> key = groups.key(id);
+        keys.push_back(key ? std::optional<std::string>(*key) : std::nullopt);
+    }
+    std::vector<std::optional<std::string>> expected = statusRows;
+    expected.insert(expected.end(), {"pending", "archived", std::nullopt});
+    EXPECT_EQ(keys, expected);
+    EXPECT_EQ(ids[0], ids[3]);
+    EXPECT_EQ(ids[2], ids[12]);
+    EXPECT_EQ(ids[5], ids[10]);
+    EXPECT_NE(ids[4], ids[2]);
+}
+
+TEST(StringOpsTest, NullRowsAddNoEmptyGroup) {
+    // No row holds a real "", so the empty placeholder in the NULL slot must not become a group
+    for (const ColumnSegment &segment : bothEncodings({"a", std::nullopt, "a"})) {
+        StringGroups groups;
+        std::vector<uint32_t> ids;
+        groups.assign(segment, ids);
+        ASSERT_EQ(groups.size(), 2u);
+        EXPECT_EQ(groups.key(ids[0]), "a");
+        EXPECT_EQ(ids[0], ids[2]);
+        EXPECT_FALSE(groups.key(ids[1]).has_value());
+    }
+}
+
+TEST(StringOpsTest, DistinctSkipsUnusedEntries) {
+    for (ColumnSegment &segment : bothEncodings(statusRows)) {
+        segment.truncate(4); // Drops "" and "pending"; a dictionary keeps their entries
+        StringGroups distinct;
+        distinct.add_distinct(segment);
+        std::set<std::optional<std::string_view>> keys;
+        for (uint32_t id = 0; id < distinct.size(); ++id) {
+            keys.insert(distinct.key(id));
+        }
+        EXPECT_EQ(keys, (std::set<std::optional<std::string_view>>{std::nullopt, "open", "closed"}));
+    }
+}
+
+TEST(StringOpsTest, SortsRowsAcrossEncodings) {
+    // Long values sharing a prefix, so the order is decided past the inline part
+    const std::vector<std::optional<std::string>> rows = {
+            "pending", std::nullopt, "customer-000000042", "closed", "customer-000000007", "", "closed",
+            std::nullopt, "customer-000000042"};
+    const std::vector<uint32_t> expected{5, 3, 6, 4, 2, 8, 0, 1, 7};
+    for (const ColumnSegment &segment : bothEncodings(rows)) {
+        std::vector<uint32_t> order{99};
+        sort_rows(segment, order);
+        EXPECT_EQ(std::vector<uint32_t>(order.begin() + 1, order.end()), expected);
+    }
+}
+
+TEST(StringOpsTest, CopiedSegmentsOwnTheirStrings) {
+    const std::string long_value = "a value too long to be stored inline";
+    std::optional<ColumnSegment> original(std::in_place, PhysicalType::STRING);
+    original->append_string(long_value);
+    original->append_string("short");
+    original->append_string(long_value);
+    original->seal(); // Too few rows for the dictionary to pay; the rows share the entry's payload
+    ASSERT_EQ(original->encoding(), StringEncoding::PLAIN);
+    const ColumnSegment copy = *original;
+    original.reset();
+    EXPECT_EQ(copy.string(0), long_value);
+    EXPECT_EQ(copy.string(1), "short");
+    EXPECT_EQ(copy.string(2), long_value);
+    // The two rows still share one payload
+    EXPECT_EQ(copy.string(0).data(), copy.string(2).data());
+}
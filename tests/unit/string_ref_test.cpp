@@ -0,0 +1,84 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/storage/string_ref.h"
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+TEST(StringRefTest, StoresShortStringsInline) {
+    StringArena arena;
+    const StringRef empty("", arena);
+    const StringRef twelve("exactly12chr", arena);
+    const StringRef thirteen("exactly13char", arena);
+    EXPECT_TRUE(empty.is_inline());
+    EXPECT_TRUE(twelve.is_inline());
+    EXPECT_FALSE(thirteen.is_inline());
+    EXPECT_EQ(arena.bytes(), 13u);
+    EXPECT_EQ(twelve.view(), "exactly12chr");
+    EXPECT_EQ(thirteen.view(), "exactly13char");
+    EXPECT_EQ(empty.size(), 0u);
+
+    // A long payload stays put when the arena moves
+    const char *payload = thirteen.view().data();
+    StringArena moved = std::move(arena);
+    EXPECT_EQ(thirteen.view().data(), payload);
+    EXPECT_EQ(StringRef("another long string", moved).view(), "another long string");
+}
+
+TEST(StringRefTest, ComparesLikeStringView) {
+    std::vector<std::string> values{"", "a", "ab", "abc", "abcd", "abcde", "abcdefghijkl", "abcdefghijklm",
+                                    "abcdefghijklmn", "abcdefghijkm", "abce", "b", std::string("a\0b", 3),
+                                    std::string("a\0", 2), "\xff", "\x7f", "abcdzzzzzzzzzzzzzz", "abcdaaaaaaaaaaaaaa"};
+    StringArena arena;
+    std::vector<StringRef> refs;
+    for (const std::string &value : values) {
+        refs.emplace_back(value, arena);
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t j = 0; j < values.size(); ++j) {
+            const std::string_view a = values[i];
+            const std::string_view b = values[j];
+            EXPECT_EQ(refs[i] == refs[j], a == b) << i << " " << j;
+            EXPECT_EQ(refs[i] <=> refs[j], a <=> b) << i << " " << j;
+        }
+        // A borrowed handle equals an owned one, and hashes the same
+        EXPECT_EQ(StringRef(values[i]), refs[i]);
+        EXPECT_EQ(StringRef(values[i]).hash(), refs[i].hash());
+    }
+
+    std::unordered_set<StringRef> distinct(refs.begin(), refs.end());
+    distinct.insert(StringRef("abcdefghijklm"));
+    EXPECT_EQ(distinct.size(), values.size());
+}
+
+TEST(StringRefTest, RejectsStringsPastFourGiB) {
+    if constexpr (sizeof(size_t) > 4) {
+        // Only the length is looked at, so the view never has to be read
+        const std::string_view huge("x", size_t{1} << 32);
+        StringArena arena;
+        EXPECT_THROW(StringRef(huge, arena), std::length_error);
+        EXPECT_EQ(arena.bytes(), 0u);
+    }
+}
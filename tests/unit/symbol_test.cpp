@@ -0,0 +1,81 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/ast/symbol.h"
+#include "../../src/parser/parser.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SymbolTest, InternsEqualNamesToOneId) {
+    const Symbol users("users");
+    EXPECT_EQ(Symbol(std::string("users")), users);
+    EXPECT_EQ(Symbol::from_id(users.id()), users);
+    EXPECT_NE(Symbol("Users"), users); // Interning is exact; case folding is the parser's business
+    EXPECT_EQ(users.str(), "users");
+    EXPECT_EQ(users, "users");
+    EXPECT_EQ(users.text_hash(), Symbol("users").text_hash());
+
+    EXPECT_TRUE(Symbol().empty());
+    EXPECT_EQ(Symbol(""), Symbol());
+    EXPECT_EQ(Symbol().str(), "");
+
+    const size_t before = SymbolTable::global().size();
+    EXPECT_FALSE(SymbolTable::global().find("symbol_test_never_interned").has_value());
+    EXPECT_EQ(SymbolTable::global().find("users"), users.id());
+    EXPECT_EQ(SymbolTable::global().size(), before);
+}
+
+TEST(SymbolTest, ParserInternsNames) {
+    Lexer lexer(std::string("SELECT id FROM orders; CREATE TABLE orders (id INTEGER);"));
+    Parser parser(lexer);
+    const auto statements = parser.parse();
+    const auto &select = std::get<SelectStmt>(statements[0]);
+    const auto &create = std::get<CreateTableStmt>(std::get<CreateStmt>(statements[1]));
+
+    EXPECT_EQ(select.from[0].name.id(), create.table_name.id());
+    const auto &column = std::get<ColumnRef>(select.projections[0]);
+    EXPECT_EQ(column.name, create.columns[0].name);
+}
+
+TEST(SymbolTest, ConcurrentInterningAgrees) {
+    constexpr int thread_count = 8;
+    constexpr int names = 2000;
+    std::vector<std::vector<uint32_t>> ids(thread_count, std::vector<uint32_t>(names));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([t, &ids] {
+            // Each thread starts at a different name and goes round, so first insertions race
+            for (int i = 0; i < names; ++i) {
+                const int n = (i + t * names / thread_count) % names;
+                ids[t][n] = Symbol("concurrent_" + std::to_string(n)).id();
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    for (int n = 0; n < names; ++n) {
+        for (int t = 1; t < thread_count; ++t) ASSERT_EQ(ids[t][n], ids[0][n]);
+        EXPECT_EQ(Symbol::from_id(ids[0][n]).str(), "concurrent_" + std::to_string(n));
+    }
+}
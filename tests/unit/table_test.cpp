@@ -0,0 +1,199 @@
+/*
+ fluxo_db in-memory database
+ Copyright (C) 2025 Mikhail Kulik
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//
+// Created by mikai on 16.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/optimizer/constant_folding.h"
+#include "../../src/parser/parser.h"
+#include "../../src/storage/table.h"
+#include <cstdint>
+#include <string>
+
+namespace {
+
+Statement parseOne(const std::string &sql) {
+    Lexer lexer(sql);
+    Parser parser(lexer);
+    auto statements = parser.parse();
+    return std::move(statements.at(0));
+}
+
+CreateTableStmt parseCreate(const std::string &sql) {
+    return std::get<CreateTableStmt>(std::get<CreateStmt>(parseOne(sql)));
+}
+
+InsertStmt parseInsert(const std::string &sql) {
+    Statement statement = parseOne(sql);
+    fold_constants(statement);
+    return std::move(std::get<InsertStmt>(statement));
+}
+
+const std::string ordersDdl =
+        "CREATE TABLE orders (id BIGINT PRIMARY KEY, qty INT, price DOUBLE, paid BOOLEAN, note TEXT);";
+
+} // namespace
+
+TEST(TableTest, MapsDeclaredTypesToPhysicalColumns) {
+    Table table(parseCreate("CREATE TABLE t (a INT, b BIGINT, c DOUBLE, d BOOLEAN, e TEXT, f VARCHAR, g DATE);"));
+    table.insert(parseInsert("INSERT INTO t VALUES (1, 2, 3, TRUE, 'x', 'y', 19000);"));
+
+    ASSERT_EQ(table.row_groups().size(), 1u);
+    const std::vector<ColumnSegment> &columns = table.row_groups()[0].columns;
+    EXPECT_EQ(columns[0].type(), PhysicalType::INT32);
+    EXPECT_EQ(columns[1].type(), PhysicalType::INT64);
+    EXPECT_EQ(columns[2].type(), PhysicalType::DOUBLE);
+    EXPECT_EQ(columns[3].type(), PhysicalType::BIT);
+    EXPECT_EQ(columns[4].type(), PhysicalType::STRING);
+    EXPECT_EQ(columns[5].type(), PhysicalType::STRING);
+    EXPECT_EQ(columns[6].type(), PhysicalType::INT32);
+
+    EXPECT_EQ(columns[0].int32s()[0], 1);
+    EXPECT_EQ(columns[1].int64s()[0], 2);
+    EXPECT_EQ(columns[2].doubles()[0], 3.0);
+    EXPECT_TRUE(columns[3].boolean(0));
+    EXPECT_EQ(columns[5].string(0), "y");
+    EXPECT_EQ(table.value(0, 6).type, DataType::DATE);
+    EXPECT_EQ(std::get<int64_t>(table.value(0, 6).value), 19000);
+}
+
+TEST(TableTest, StoresBulkInsertColumnByColumn) {
+    Table table(parseCreate(ordersDdl));
+    const InsertStmt insert = parseInsert(
+            "INSERT INTO orders VALUES (1, 3, 9.5, TRUE, 'first'), (2, NULL, 1.25, FALSE, NULL),"
+            " (3, 7, NULL, TRUE, '');");
+    ASSERT_TRUE(insert.bulk.has_value());
+    EXPECT_EQ(table.insert(insert), 3u);
+    EXPECT_EQ(table.row_count(), 3u);
+
+    const RowGroup &group = table.row_groups()[0];
+    EXPECT_EQ(group.row_count, 3u);
+    const ColumnSegment &qty = group.columns[1];
+    EXPECT_EQ(std::vector<int32_t>(qty.int32s().begin(), qty.int32s().end()), (std::vector<int32_t>{3, 0, 7}));
+    EXPECT_TRUE(qty.is_null(1));
+    EXPECT_EQ(qty.null_count(), 1u);
+    EXPECT_TRUE(group.columns[0].null_words().empty());
+
+    const ColumnSegment &paid = group.columns[3];
+    ASSERT_EQ(paid.bool_words().size(), 1u);
+    EXPECT_EQ(paid.bool_words()[0], 0b101u);
+
+    const ColumnSegment &note = group.columns[4];
+    EXPECT_EQ(note.dictionary_size(), 2u); // "first" and the empty string, which NULL rows share
+    EXPECT_EQ(note.string(0), "first");
+    EXPECT_TRUE(note.is_null(1));
+    EXPECT_EQ(note.string(2), "");
+    EXPECT_FALSE(note.is_null(2));
+
+    EXPECT_EQ(std::get<std::string>(table.value(0, 4).value), "first");
+    EXPECT_EQ(table.value(2, 2).type, DataType::NULL_TYPE);
+}
+
+TEST(TableTest, StoresExpressionRowsAndMissingColumns) {
+    Table table(parseCreate(ordersDdl));
+    const InsertStmt insert = parseInsert("INSERT INTO orders (note, id) VALUES ('a', -1), ('b', 2 * 21);");
+    ASSERT_FALSE(insert.bulk.has_value());
+    EXPECT_EQ(table.insert(insert), 2u);
+
+    const RowGroup &group = table.row_groups()[0];
+    EXPECT_EQ(group.columns[0].int64s()[0], -1);
+    EXPECT_EQ(group.columns[0].int64s()[1], 42);
+    EXPECT_EQ(group.columns[1].null_count(), 2u);
+    EXPECT_EQ(group.columns[4].string(1), "b");
+}
+
+TEST(TableTest, SplitsRowsIntoFixedSizeRowGroups) {
+    Table table(parseCreate("CREATE TABLE t (id BIGINT, v DOUBLE);"), 64);
+    std::string sql = "INSERT INTO t VALUES ";
+    for (int i = 0; i < 150; ++i) {
+        sql += (i ? ", (" : "(") + std::to_string(i) + ", " + (i % 10 == 0 ? "NULL" : std::to_string(i) + ".5") + ")";
+    }
+    table.insert(parseInsert(sql + ";"));
+    table.insert(parseInsert("INSERT INTO t VALUES (150, 0.5);"));
+
+    ASSERT_EQ(table.row_groups().size(), 3u);
+    EXPECT_EQ(table.row_groups()[0].row_count, 64u);
+    EXPECT_EQ(table.row_groups()[1].row_count, 64u);
+    EXPECT_EQ(table.row_groups()[2].row_count, 23u);
+    EXPECT_EQ(table.row_groups()[2].first_row, 128u);
+
+    // A typed scan over every row group, skipping NULLs through the bitmap
+    int64_t id_sum = 0;
+    double value_sum = 0;
+    size_t nulls = 0;
+    for (const RowGroup &group : table.row_groups()) {
+        // Full groups are sealed and their ids packed, so they are decoded rather than read in place
+        std::vector<int64_t> ids(group.row_count);
+        group.columns[0].decode_int64s(0, ids);
+        for (const int64_t id : ids) {
+            id_sum += id;
+        }
+        const ColumnSegment &values = group.columns[1];
+        for (size_t row = 0; row < group.row_count; ++row) {
+            value_sum += values.doubles()[row];
+            nulls += values.is_null(row) ? 1 : 0;
+        }
+    }
+    EXPECT_EQ(id_sum, 150 * 151 / 2);
+    EXPECT_EQ(nulls, 15u);
+    EXPECT_EQ(std::get<double>(table.value(131, 1).value), 131.5);
+    EXPECT_EQ(table.value(130, 1).type, DataType::NULL_TYPE);
+    EXPECT_GT(value_sum, 0);
+    EXPECT_TRUE(table.row_groups()[0].columns[0].packed());
+    EXPECT_EQ(std::get<int64_t>(table.value(100, 0).value), 100);
+}
+
+TEST(TableTest, RejectedInsertLeavesTableUnchanged) {
+    Table table(parseCreate(ordersDdl), 64);
+    std::string sql = "INSERT INTO orders (id, qty) VALUES ";
+    for (int i = 0; i < 100; ++i) {
+        sql += (i ? ", (" : "(") + std::to_string(i) + ", " + std::to_string(i) + ")";
+    }
+    table.insert(parseInsert(sql + ";"));
+
+    EXPECT_THROW(table.insert(parseInsert("INSERT INTO orders (id, qty) VALUES (1, 2), (NULL, 3);")),
+                 std::invalid_argument);
+    EXPECT_THROW(table.insert(parseInsert("INSERT INTO orders (id, qty) VALUES (1, 2), (2, 3000000000);")),
+                 std::out_of_range);
+    EXPECT_THROW(table.insert(parseInsert("INSERT INTO orders (id, note) VALUES (1, 'x'), (2, 3);")),
+                 std::invalid_argument);
+    EXPECT_THROW(table.insert(parseInsert("INSERT INTO orders (id, missing) VALUES (1, 2);")), std::invalid_argument);
+    EXPECT_THROW(table.insert(parseInsert("INSERT INTO orders (id, qty) VALUES (1, 2, 3);")), std::invalid_argument);
+
+    EXPECT_EQ(table.row_count(), 100u);
+    ASSERT_EQ(table.row_groups().size(), 2u);
+    for (const RowGroup &group : table.row_groups()) {
+        for (const ColumnSegment &segment : group.columns) {
+            EXPECT_EQ(segment.size(), group.row_count);
+        }
+    }
+    EXPECT_EQ(table.row_groups()[1].columns[4].null_count(), 36u);
+}
+
+TEST(TableTest, ValidatesTheDefinition) {
+    EXPECT_THROW(Table(parseCreate("CREATE TABLE t (a INT, a TEXT);")), std::invalid_argument);
+    EXPECT_THROW(Table(parseCreate("CREATE TABLE t (a INT);"), 100), std::invalid_argument);
+
+    const Table table(parseCreate("CREATE TABLE t (a INT, b TEXT, CONSTRAINT pk PRIMARY KEY (b));"));
+    EXPECT_TRUE(table.columns()[1].not_null);
+    EXPECT_FALSE(table.columns()[0].not_null);
+    EXPECT_EQ(table.column_index(Symbol("b")), 1u);
+    EXPECT_FALSE(table.column_index(Symbol("c")).has_value());
+}